@@ -29,6 +29,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <shared_mutex>
 #include <thread>
 
 #include "AL/al.h"
@@ -283,6 +284,7 @@ ALeffectslot *AllocEffectSlot(ALCcontext *context)
 
     /* Add 1 to avoid source ID 0. */
     slot->id = ((lidx<<6) | slidx) + 1;
+    slot->mSlot.mId = slot->id;
 
     context->mNumEffectSlots += 1;
     sublist->FreeMask &= ~(1_u64 << slidx);
@@ -296,6 +298,12 @@ void FreeEffectSlot(ALCcontext *context, ALeffectslot *slot)
     const size_t lidx{id >> 6};
     const ALuint slidx{id & 0x3f};
 
+    /* Return any unapplied update to the pool. */
+    if(EffectSlotProps *props{slot->mSlot.Update.exchange(nullptr, std::memory_order_relaxed)})
+    {
+        props->State = nullptr;
+        context->mEffectSlotPropsPool.put(props);
+    }
     al::destroy_at(slot);
 
     context->mEffectSlotList[lidx].FreeMask |= 1_u64 << slidx;
@@ -324,7 +332,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Generating %d effect slots", n);
     if UNLIKELY(n <= 0) return;
 
-    std::unique_lock<std::mutex> slotlock{context->mEffectSlotLock};
+    std::unique_lock<ShardedSharedMutex> slotlock{context->mEffectSlotLock};
     ALCdevice *device{context->mDevice.get()};
     if(static_cast<ALuint>(n) > device->AuxiliaryEffectSlotMax-context->mNumEffectSlots)
     {
@@ -375,7 +383,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Deleting %d effect slots", n);
     if UNLIKELY(n <= 0) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     if(n == 1)
     {
         ALeffectslot *slot{LookupEffectSlot(context.get(), effectslots[0])};
@@ -435,7 +443,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if LIKELY(context)
     {
-        std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+        std::shared_lock<ShardedSharedMutex> _{context->mEffectSlotLock};
         if(LookupEffectSlot(context.get(), effectslot) != nullptr)
             return AL_TRUE;
     }
@@ -450,7 +458,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context.get(), slotid)};
     if UNLIKELY(!slot)
     {
@@ -479,7 +487,7 @@ START_API_FUNC
     if UNLIKELY(n <= 0) return;
 
     auto slots = al::vector<ALeffectslot*>(static_cast<ALuint>(n));
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     for(size_t i{0};i < slots.size();++i)
     {
         ALeffectslot *slot{LookupEffectSlot(context.get(), slotids[i])};
@@ -509,7 +517,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context.get(), slotid)};
     if UNLIKELY(!slot)
     {
@@ -533,7 +541,7 @@ START_API_FUNC
     if UNLIKELY(n <= 0) return;
 
     auto slots = al::vector<ALeffectslot*>(static_cast<ALuint>(n));
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     for(size_t i{0};i < slots.size();++i)
     {
         ALeffectslot *slot{LookupEffectSlot(context.get(), slotids[i])};
@@ -559,8 +567,8 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> __{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -638,7 +646,7 @@ START_API_FUNC
                 "Setting buffer on playing effect slot %u", slot->id);
 
         {
-            std::lock_guard<std::mutex> ___{device->BufferLock};
+            std::shared_lock<std::shared_timed_mutex> ___{device->BufferLock};
             ALbuffer *buffer{};
             if(value)
             {
@@ -689,7 +697,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -709,8 +717,8 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> __{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -744,7 +752,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -765,7 +773,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -817,7 +825,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -837,7 +845,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -867,7 +875,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context.get(), effectslot);
     if UNLIKELY(!slot)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid effect slot ID %u", effectslot);
@@ -903,14 +911,6 @@ ALeffectslot::~ALeffectslot()
         DecrementRef(Buffer->ref);
     Buffer = nullptr;
 
-    EffectSlotProps *props{mSlot.Update.exchange(nullptr)};
-    if(props)
-    {
-        TRACE("Freed unapplied AuxiliaryEffectSlot update %p\n",
-            decltype(std::declval<void*>()){props});
-        delete props;
-    }
-
     if(mSlot.mEffectState)
         mSlot.mEffectState->release();
 }
@@ -945,30 +945,20 @@ ALenum ALeffectslot::initEffect(ALeffect *effect, ALCcontext *context)
         Effect.Props = effect->Props;
 
     /* Remove state references from old effect slot property updates. */
-    EffectSlotProps *props{context->mFreeEffectslotProps.load()};
-    while(props)
-    {
-        props->State = nullptr;
-        props = props->next.load(std::memory_order_relaxed);
-    }
+    context->mEffectSlotPropsPool.forEachFree([](EffectSlotProps &props) noexcept
+        { props.State = nullptr; });
 
     return AL_NO_ERROR;
 }
 
 void ALeffectslot::updateProps(ALCcontext *context)
 {
-    /* Get an unused property container, or allocate a new one as needed. */
-    EffectSlotProps *props{context->mFreeEffectslotProps.load(std::memory_order_relaxed)};
+    /* Take back the pending update if the mixer hasn't gotten to it yet, or
+     * get an unused property container from the pool.
+     */
+    EffectSlotProps *props{mSlot.Update.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props)
-        props = new EffectSlotProps{};
-    else
-    {
-        EffectSlotProps *next;
-        do {
-            next = props->next.load(std::memory_order_relaxed);
-        } while(context->mFreeEffectslotProps.compare_exchange_weak(props, next,
-                std::memory_order_seq_cst, std::memory_order_acquire) == 0);
-    }
+        props = context->mEffectSlotPropsPool.get();
 
     /* Copy in current property values. */
     props->Gain = Gain;
@@ -979,21 +969,24 @@ void ALeffectslot::updateProps(ALCcontext *context)
     props->Props = Effect.Props;
     props->State = Effect.State;
 
+    props->Stamp = mSourceParams.Stamp + 1;
+    mSourceParams.set(*props);
+
     /* Set the new container for updating internal parameters. */
     props = mSlot.Update.exchange(props, std::memory_order_acq_rel);
     if(props)
     {
         /* If there was an unused update container, put it back in the
-         * freelist.
+         * pool.
          */
         props->State = nullptr;
-        AtomicReplaceHead(context->mFreeEffectslotProps, props);
+        context->mEffectSlotPropsPool.put(props);
     }
 }
 
 void UpdateAllEffectSlotProps(ALCcontext *context)
 {
-    std::lock_guard<std::mutex> _{context->mEffectSlotLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mEffectSlotLock};
     for(auto &sublist : context->mEffectSlotList)
     {
         uint64_t usemask{~sublist.FreeMask};
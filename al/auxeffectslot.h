@@ -48,6 +48,11 @@ struct ALeffectslot {
 
     EffectSlot mSlot;
 
+    /* The source parameters as last sent to the mixer, for calculating source
+     * parameters outside of it. Guarded by the context's mPropLock.
+     */
+    EffectSlotSourceParams mSourceParams;
+
     /* Self ID */
     ALuint id{};
 
@@ -35,6 +35,7 @@
 #include <mutex>
 #include <new>
 #include <numeric>
+#include <shared_mutex>
 #include <utility>
 
 #include "AL/al.h"
@@ -50,6 +51,7 @@
 #include "aloptional.h"
 #include "atomic.h"
 #include "core/except.h"
+#include "core/uhjfilter.h"
 #include "inprogext.h"
 #include "opthelpers.h"
 
@@ -271,6 +273,7 @@ ALuint ChannelsFromUserFmt(UserFmtChannels chans, ALuint ambiorder) noexcept
     case UserFmtX71: return 8;
     case UserFmtBFormat2D: return (ambiorder*2) + 1;
     case UserFmtBFormat3D: return (ambiorder+1) * (ambiorder+1);
+    case UserFmtUHJ2: return 2;
     }
     return 0;
 }
@@ -465,6 +468,7 @@ void LoadData(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq, ALuint size,
     case UserFmtX71: DstChannels = FmtX71; break;
     case UserFmtBFormat2D: DstChannels = FmtBFormat2D; break;
     case UserFmtBFormat3D: DstChannels = FmtBFormat3D; break;
+    case UserFmtUHJ2: DstChannels = FmtUHJ2; break;
     }
     if UNLIKELY(static_cast<long>(SrcChannels) != static_cast<long>(DstChannels))
         SETERR_RETURN(context, AL_INVALID_ENUM, , "Invalid format");
@@ -622,6 +626,7 @@ void PrepareCallback(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
     case UserFmtX71: DstChannels = FmtX71; break;
     case UserFmtBFormat2D: DstChannels = FmtBFormat2D; break;
     case UserFmtBFormat3D: DstChannels = FmtBFormat3D; break;
+    case UserFmtUHJ2: DstChannels = FmtUHJ2; break;
     }
     if UNLIKELY(static_cast<long>(SrcChannels) != static_cast<long>(DstChannels))
         SETERR_RETURN(context, AL_INVALID_ENUM,, "Invalid format");
@@ -645,8 +650,10 @@ void PrepareCallback(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
     const ALuint ambiorder{(DstChannels == FmtBFormat2D || DstChannels == FmtBFormat3D) ?
         ALBuf->UnpackAmbiOrder : 0};
 
+    /* UHJ decoding needs extra samples to look ahead. */
+    const size_t padding{(DstChannels == FmtUHJ2) ? UhjDecoder::sFilterDelay : 0};
     al::vector<al::byte,16>(FrameSizeFromFmt(DstChannels, DstType, ambiorder) *
-        size_t{BufferLineSize + (MaxResamplerPadding>>1)}).swap(ALBuf->mData);
+        size_t{BufferLineSize + (MaxResamplerPadding>>1) + padding}).swap(ALBuf->mData);
 
     ALBuf->mCallback = callback;
     ALBuf->mUserData = userptr;
@@ -675,7 +682,7 @@ al::optional<DecompResult> DecomposeUserFormat(ALenum format)
         UserFmtChannels channels;
         UserFmtType type;
     };
-    static const std::array<FormatMap,46> UserFmtList{{
+    static const std::array<FormatMap,49> UserFmtList{{
         { AL_FORMAT_MONO8,             UserFmtMono, UserFmtUByte   },
         { AL_FORMAT_MONO16,            UserFmtMono, UserFmtShort   },
         { AL_FORMAT_MONO_FLOAT32,      UserFmtMono, UserFmtFloat   },
@@ -731,6 +738,10 @@ al::optional<DecompResult> DecomposeUserFormat(ALenum format)
         { AL_FORMAT_BFORMAT3D_16,      UserFmtBFormat3D, UserFmtShort },
         { AL_FORMAT_BFORMAT3D_FLOAT32, UserFmtBFormat3D, UserFmtFloat },
         { AL_FORMAT_BFORMAT3D_MULAW,   UserFmtBFormat3D, UserFmtMulaw },
+
+        { AL_FORMAT_UHJ2CHN8_SOFT,        UserFmtUHJ2, UserFmtUByte },
+        { AL_FORMAT_UHJ2CHN16_SOFT,       UserFmtUHJ2, UserFmtShort },
+        { AL_FORMAT_UHJ2CHN_FLOAT32_SOFT, UserFmtUHJ2, UserFmtFloat },
     }};
 
     for(const auto &fmt : UserFmtList)
@@ -755,7 +766,7 @@ START_API_FUNC
     if UNLIKELY(n <= 0) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
     if(!EnsureBuffers(device, static_cast<ALuint>(n)))
     {
         context->setError(AL_OUT_OF_MEMORY, "Failed to allocate %d buffer%s", n, (n==1)?"":"s");
@@ -795,7 +806,7 @@ START_API_FUNC
     if UNLIKELY(n <= 0) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     /* First try to find any buffers that are invalid or in-use. */
     auto validate_buffer = [device, &context](const ALuint bid) -> bool
@@ -835,7 +846,7 @@ START_API_FUNC
     if LIKELY(context)
     {
         ALCdevice *device{context->mDevice.get()};
-        std::lock_guard<std::mutex> _{device->BufferLock};
+        std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
         if(!buffer || LookupBuffer(device, buffer))
             return AL_TRUE;
     }
@@ -856,7 +867,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -890,7 +901,7 @@ START_API_FUNC
     if UNLIKELY(!context) return nullptr;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -943,7 +954,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -966,7 +977,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -998,7 +1009,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -1128,7 +1139,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1148,7 +1159,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1167,7 +1178,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1189,7 +1200,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -1251,7 +1262,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1284,7 +1295,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -1322,7 +1333,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -1344,7 +1355,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1372,7 +1383,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
 
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1394,7 +1405,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1451,7 +1462,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
     else if UNLIKELY(!value1 || !value2 || !value3)
@@ -1489,7 +1500,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1517,7 +1528,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
 
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
@@ -1547,7 +1558,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     ALbuffer *albuf = LookupBuffer(device, buffer);
     if UNLIKELY(!albuf)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
@@ -1575,7 +1586,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
     else if UNLIKELY(!value1 || !value2 || !value3)
@@ -1603,7 +1614,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALCdevice *device{context->mDevice.get()};
-    std::lock_guard<std::mutex> _{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> _{device->BufferLock};
     if UNLIKELY(LookupBuffer(device, buffer) == nullptr)
         context->setError(AL_INVALID_NAME, "Invalid buffer ID %u", buffer);
     else if UNLIKELY(!values)
@@ -5,15 +5,23 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <exception>
 #include <memory>
 #include <mutex>
 #include <new>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <utility>
 
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 #include "AL/al.h"
 #include "AL/alc.h"
 
@@ -23,6 +31,7 @@
 #include "async_event.h"
 #include "core/except.h"
 #include "core/logging.h"
+#include "core/trace.h"
 #include "effects/base.h"
 #include "inprogext.h"
 #include "opthelpers.h"
@@ -33,6 +42,8 @@
 
 static int EventThread(ALCcontext *context)
 {
+    althrd_setname(EVENT_THREAD_NAME);
+
     RingBuffer *ring{context->mAsyncEvents.get()};
     bool quitnow{false};
     while LIKELY(!quitnow)
@@ -44,6 +55,7 @@ static int EventThread(ALCcontext *context)
             continue;
         }
 
+        TraceScope trace{"EventThread", "events", static_cast<uint32_t>(evt_data.len)};
         std::lock_guard<std::mutex> _{context->mEventCbLock};
         do {
             auto *evt_ptr = reinterpret_cast<AsyncEvent*>(evt_data.buf);
@@ -66,35 +78,44 @@ static int EventThread(ALCcontext *context)
             uint enabledevts{context->mEnabledEvts.load(std::memory_order_acquire)};
             if(!context->mEventCb) continue;
 
+            /* Only build the messages when the app wants them. */
+            const bool withmsg{context->mEventMessages.load(std::memory_order_relaxed)};
+
             if(evt.EnumType == EventType_SourceStateChange)
             {
                 if(!(enabledevts&EventType_SourceStateChange))
                     continue;
                 ALuint state{};
-                std::string msg{"Source ID " + std::to_string(evt.u.srcstate.id)};
-                msg += " state has changed to ";
+                const char *statename{""};
                 switch(evt.u.srcstate.state)
                 {
                 case VChangeState::Reset:
-                    msg += "AL_INITIAL";
+                    statename = "AL_INITIAL";
                     state = AL_INITIAL;
                     break;
                 case VChangeState::Stop:
-                    msg += "AL_STOPPED";
+                    statename = "AL_STOPPED";
                     state = AL_STOPPED;
                     break;
                 case VChangeState::Play:
-                    msg += "AL_PLAYING";
+                    statename = "AL_PLAYING";
                     state = AL_PLAYING;
                     break;
                 case VChangeState::Pause:
-                    msg += "AL_PAUSED";
+                    statename = "AL_PAUSED";
                     state = AL_PAUSED;
                     break;
                 /* Shouldn't happen */
                 case VChangeState::Restart:
                     break;
                 }
+                std::string msg;
+                if(withmsg)
+                {
+                    msg = "Source ID " + std::to_string(evt.u.srcstate.id);
+                    msg += " state has changed to ";
+                    msg += statename;
+                }
                 context->mEventCb(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.u.srcstate.id,
                     state, static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
             }
@@ -102,9 +123,13 @@ static int EventThread(ALCcontext *context)
             {
                 if(!(enabledevts&EventType_BufferCompleted))
                     continue;
-                std::string msg{std::to_string(evt.u.bufcomp.count)};
-                if(evt.u.bufcomp.count == 1) msg += " buffer completed";
-                else msg += " buffers completed";
+                std::string msg;
+                if(withmsg)
+                {
+                    msg = std::to_string(evt.u.bufcomp.count);
+                    if(evt.u.bufcomp.count == 1) msg += " buffer completed";
+                    else msg += " buffers completed";
+                }
                 context->mEventCb(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.u.bufcomp.id,
                     evt.u.bufcomp.count, static_cast<ALsizei>(msg.length()), msg.c_str(),
                     context->mEventParam);
@@ -113,9 +138,9 @@ static int EventThread(ALCcontext *context)
             {
                 if(!(enabledevts&EventType_Disconnected))
                     continue;
+                const char *msg{withmsg ? evt.u.disconnect.msg : ""};
                 context->mEventCb(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0,
-                    static_cast<ALsizei>(strlen(evt.u.disconnect.msg)), evt.u.disconnect.msg,
-                    context->mEventParam);
+                    static_cast<ALsizei>(strlen(msg)), msg, context->mEventParam);
             }
         } while(evt_data.len != 0);
     }
@@ -124,6 +149,13 @@ static int EventThread(ALCcontext *context)
 
 void StartEventThrd(ALCcontext *ctx)
 {
+    ctx->mEventRecords = RingBuffer::Create(2047, sizeof(ALeventRecordSOFT), false);
+#ifdef HAVE_SYS_EVENTFD_H
+    ctx->mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(ctx->mEventFd == -1)
+        WARN("Failed to create event fd: %s\n", std::strerror(errno));
+#endif
+
     try {
         ctx->mEventThread = std::thread{EventThread, ctx};
     }
@@ -152,6 +184,45 @@ void StopEventThrd(ALCcontext *ctx)
     ctx->mEventSem.post();
     if(ctx->mEventThread.joinable())
         ctx->mEventThread.join();
+
+#ifdef HAVE_SYS_EVENTFD_H
+    if(ctx->mEventFd != -1)
+        close(ctx->mEventFd);
+    ctx->mEventFd = -1;
+#endif
+}
+
+
+void ALCcontext::queueEventRecord(ALenum type, ALuint object, ALuint param) noexcept
+{
+    auto rec_data = mEventRecords->getWriteVector().first;
+    if(rec_data.len < 1) return;
+
+    auto *rec = reinterpret_cast<ALeventRecordSOFT*>(rec_data.buf);
+    rec->type = type;
+    rec->object = object;
+    rec->param = param;
+    mEventRecords->writeAdvance(1);
+
+    /* Pairs with the fence in alReadEventsSOFT, so either the reader sees the
+     * new record after clearing the signal, or this sees the signal cleared.
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!mEventRecordsSignaled.load(std::memory_order_relaxed)
+        && !mEventRecordsSignaled.exchange(true, std::memory_order_acq_rel))
+        signalEventRecords();
+}
+
+void ALCcontext::signalEventRecords() noexcept
+{
+#ifdef HAVE_SYS_EVENTFD_H
+    if(mEventFd != -1)
+    {
+        const uint64_t value{1};
+        ssize_t ret{write(mEventFd, &value, sizeof(value))};
+        (void)ret;
+    }
+#endif
 }
 
 AL_API void AL_APIENTRY alEventControlSOFT(ALsizei count, const ALenum *types, ALboolean enable)
@@ -215,9 +286,52 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     std::lock_guard<std::mutex> __{context->mEventCbLock};
     context->mEventCb = callback;
     context->mEventParam = userParam;
 }
 END_API_FUNC
+
+AL_API ALsizei AL_APIENTRY alReadEventsSOFT(ALsizei count, ALeventRecordSOFT *events)
+START_API_FUNC
+{
+    ContextRef context{GetContextRef()};
+    if UNLIKELY(!context) return 0;
+
+    if(count < 0) context->setError(AL_INVALID_VALUE, "Reading %d events", count);
+    if(count <= 0) return 0;
+    if(!events) SETERR_RETURN(context, AL_INVALID_VALUE, 0, "NULL pointer");
+
+    std::lock_guard<std::mutex> _{context->mEventRecordLock};
+    /* Drain the eventfd before clearing the signal. Clearing it first would
+     * let the mixer signal a new record in between, and the read would then
+     * consume that signal while the flag stays set, so the record would never
+     * be signaled.
+     */
+#ifdef HAVE_SYS_EVENTFD_H
+    if(context->mEventFd != -1)
+    {
+        uint64_t value;
+        ssize_t ret{read(context->mEventFd, &value, sizeof(value))};
+        (void)ret;
+    }
+#endif
+    context->mEventRecordsSignaled.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    RingBuffer *ring{context->mEventRecords.get()};
+    const size_t total{ring->read(events, static_cast<ALuint>(count))};
+
+    /* Signal again if there are still records left to read. This may signal
+     * along with the mixer, which only causes a spurious wakeup.
+     */
+    if(ring->readSpace() > 0)
+    {
+        context->mEventRecordsSignaled.store(true, std::memory_order_relaxed);
+        context->signalEventRecords();
+    }
+
+    return static_cast<ALsizei>(total);
+}
+END_API_FUNC
@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include <mutex>
+#include <shared_mutex>
 
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -31,6 +32,7 @@
 
 #include "alcontext.h"
 #include "almalloc.h"
+#include "alu.h"
 #include "atomic.h"
 #include "core/except.h"
 #include "opthelpers.h"
@@ -51,7 +53,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(param)
     {
     case AL_GAIN:
@@ -81,7 +83,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(param)
     {
     case AL_POSITION:
@@ -131,7 +133,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     if(!values) SETERR_RETURN(context, AL_INVALID_VALUE,, "NULL pointer");
     switch(param)
     {
@@ -162,7 +164,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(param)
     {
     default:
@@ -185,7 +187,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(param)
     {
     default:
@@ -222,7 +224,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     if(!values)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -241,7 +243,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!value)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -267,7 +269,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!value1 || !value2 || !value3)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -310,7 +312,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!values)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -338,7 +340,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!value)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -356,7 +358,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!value1 || !value2 || !value3)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -394,7 +396,7 @@ START_API_FUNC
     if UNLIKELY(!context) return;
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     if(!values)
         context->setError(AL_INVALID_VALUE, "NULL pointer");
     else switch(param)
@@ -418,18 +420,13 @@ END_API_FUNC
 
 void UpdateListenerProps(ALCcontext *context)
 {
-    /* Get an unused proprty container, or allocate a new one as needed. */
-    ListenerProps *props{context->mFreeListenerProps.load(std::memory_order_acquire)};
+    /* Take back the pending update if the mixer hasn't gotten to it yet, or
+     * get an unused property container from the pool.
+     */
+    ListenerProps *props{context->mParams.ListenerUpdate.exchange(nullptr,
+        std::memory_order_acq_rel)};
     if(!props)
-        props = new ListenerProps{};
-    else
-    {
-        ListenerProps *next;
-        do {
-            next = props->next.load(std::memory_order_relaxed);
-        } while(context->mFreeListenerProps.compare_exchange_weak(props, next,
-                std::memory_order_seq_cst, std::memory_order_acquire) == 0);
-    }
+        props = context->mListenerPropsPool.get();
 
     /* Copy in current property values. */
     ALlistener &listener = context->mListener;
@@ -440,13 +437,38 @@ void UpdateListenerProps(ALCcontext *context)
     props->Gain = listener.Gain;
     props->MetersPerUnit = listener.mMetersPerUnit;
 
+    /* Only give a new pose stamp if the listener moved, turned, or changed
+     * velocity, so moving it leaves the parameters for sources that don't
+     * depend on its pose valid. Likewise for the gain stamp.
+     */
+    ContextParams &sent = context->mSentParams;
+    const alu::Matrix oldmatrix{sent.Matrix};
+    const alu::Vector oldvelocity{sent.Velocity};
+    const float oldgain{sent.Gain};
+    const float oldmpu{sent.MetersPerUnit};
+    props->Stamp = sent.ListenerStamp;
+    props->PoseStamp = sent.ListenerPoseStamp;
+    SetListenerParams(sent, *props, context->mGainBoost);
+
+    bool posechanged{false};
+    for(size_t i{0};i < 4;++i)
+    {
+        posechanged |= sent.Velocity[i] != oldvelocity[i];
+        for(size_t j{0};j < 4;++j)
+            posechanged |= sent.Matrix[i][j] != oldmatrix[i][j];
+    }
+    if(posechanged)
+        props->PoseStamp = ++sent.ListenerPoseStamp;
+    if(sent.Gain != oldgain || sent.MetersPerUnit != oldmpu)
+        props->Stamp = ++sent.ListenerStamp;
+
     /* Set the new container for updating internal parameters. */
     props = context->mParams.ListenerUpdate.exchange(props, std::memory_order_acq_rel);
     if(props)
     {
         /* If there was an unused update container, put it back in the
-         * freelist.
+         * pool.
          */
-        AtomicReplaceHead(context->mFreeListenerProps, props);
+        context->mListenerPropsPool.put(props);
     }
 }
@@ -37,6 +37,7 @@
 #include <mutex>
 #include <new>
 #include <numeric>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
 
@@ -78,7 +79,11 @@ namespace {
 using namespace std::placeholders;
 using std::chrono::nanoseconds;
 
-Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
+/* Finds the voice playing the given source, without modifying the source.
+ * Queries only hold the source lock shared, so they use this instead of
+ * GetSourceVoice.
+ */
+Voice *FindSourceVoice(const ALsource *source, ALCcontext *context)
 {
     auto voicelist = context->getVoicesSpan();
     ALuint idx{source->VoiceIdx};
@@ -89,25 +94,31 @@ Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
         if(voice->mSourceID.load(std::memory_order_acquire) == sid)
             return voice;
     }
+    return nullptr;
+}
+
+Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
+{
+    if(Voice *voice{FindSourceVoice(source, context)})
+        return voice;
     source->VoiceIdx = INVALID_VOICE_IDX;
     return nullptr;
 }
 
 
-void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context)
+/* Sends the source's properties to the voice. The caller sets hasstate if
+ * it's holding the device's state lock.
+ */
+void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context,
+    const bool hasstate)
 {
-    /* Get an unused property container, or allocate a new one as needed. */
-    VoicePropsItem *props{context->mFreeVoiceProps.load(std::memory_order_acquire)};
+    /* Take back the voice's pending update if the mixer hasn't gotten to it
+     * yet, so repeated updates in one period reuse the same container.
+     * Otherwise get an unused one from the pool.
+     */
+    VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props)
-        props = new VoicePropsItem{};
-    else
-    {
-        VoicePropsItem *next;
-        do {
-            next = props->next.load(std::memory_order_relaxed);
-        } while(context->mFreeVoiceProps.compare_exchange_weak(props, next,
-                std::memory_order_acq_rel, std::memory_order_acquire) == 0);
-    }
+        props = context->mVoicePropsPool.get();
 
     props->Pitch = source->Pitch;
     props->Gain = source->Gain;
@@ -164,17 +175,98 @@ void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context
     if(!props->Send[0].Slot && context->mDefaultSlot)
         props->Send[0].Slot = &context->mDefaultSlot->mSlot;
 
+    props->mHasMixParams = false;
+    ALCdevice *device{context->mDevice.get()};
+    std::unique_lock<std::mutex> statelock{device->StateLock, std::defer_lock};
+    /* The device's output can only be read with its state lock, which is held
+     * while it's being reset. Don't wait for it here, as the reset can be
+     * waiting for the property lock. The mixer will calculate the parameters
+     * if they can't be calculated here.
+     */
+    if(context->mAsyncSourceParams && (hasstate || statelock.try_lock()))
+    {
+        /* Calculate the mixing parameters here, with the context, listener,
+         * and effect slot parameters last sent to the mixer. The stamps let
+         * the mixer know if it needs to recalculate them anyway.
+         */
+        props->mHasMixParams = true;
+        const EffectSlotSourceParams *sendparams[MAX_SENDS]{};
+        for(uint i{0};i < device->NumAuxSends;++i)
+        {
+            const ALeffectslot *slot{source->Send[i].Slot};
+            if(!slot && i == 0) slot = context->mDefaultSlot.get();
+            if(slot)
+            {
+                sendparams[i] = &slot->mSourceParams;
+                props->mSlotStamps[i] = slot->mSourceParams.Stamp;
+            }
+        }
+        props->mContextStamp = context->mSentParams.ContextStamp;
+        props->mListenerStamp = context->mSentParams.ListenerStamp;
+        props->mListenerPoseStamp = context->mSentParams.ListenerPoseStamp;
+
+        if(!props->mMixParams || props->mMixParams->mChans.size() < voice->mChans.size())
+            props->mMixParams = VoiceMixParams::Create(voice->mChans.size());
+        CalcVoiceParams(*props->mMixParams, voice, props, context->mSentParams, sendparams,
+            device);
+    }
+
     /* Set the new container for updating internal parameters. */
     props = voice->mUpdate.exchange(props, std::memory_order_acq_rel);
     if(props)
     {
         /* If there was an unused update container, put it back in the
-         * freelist.
+         * pool.
          */
-        AtomicReplaceHead(context->mFreeVoiceProps, props);
+        context->mVoicePropsPool.put(props);
     }
 }
 
+struct VoicePosition {
+    const VoiceBufferItem *mCurrent;
+    ALuint mPos, mPosFrac;
+    nanoseconds mClockTime;
+};
+
+/* GetSourceVoicePosition
+ *
+ * Gets the playback position of the given Source's voice, and the device clock
+ * time it's at. Returns false if the source has no voice. This doesn't wait
+ * for the mixer, it only retries if the mixer changed the position while it
+ * was being read.
+ */
+bool GetSourceVoicePosition(const ALsource *Source, ALCcontext *context, VoicePosition *pos)
+{
+    auto voicelist = context->getVoicesSpan();
+    const ALuint idx{Source->VoiceIdx};
+    if(idx >= voicelist.size())
+        return false;
+    Voice *voice{voicelist[idx]};
+
+    /* Get the clock time before the voice position. If the voice position
+     * wasn't updated for this time or later, the voice wasn't mixed since and
+     * is still at that position.
+     */
+    const nanoseconds clocktime{context->mDevice->getClockTime()};
+
+    ALuint seq, sid;
+    nanoseconds::rep posclock;
+    do {
+        seq = voice->mPositionSeq.load(std::memory_order_acquire);
+        sid = voice->mSourceID.load(std::memory_order_relaxed);
+        pos->mCurrent = voice->mCurrentBuffer.load(std::memory_order_relaxed);
+        pos->mPos = voice->mPosition.load(std::memory_order_relaxed);
+        pos->mPosFrac = voice->mPositionFrac.load(std::memory_order_relaxed);
+        posclock = voice->mPositionClock.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while((seq&1) || seq != voice->mPositionSeq.load(std::memory_order_relaxed));
+
+    if(sid != Source->id)
+        return false;
+    pos->mClockTime = std::max(nanoseconds{posclock}, clocktime);
+    return true;
+}
+
 /* GetSourceSampleOffset
  *
  * Gets the current read offset for the given Source, in 32.32 fixed-point
@@ -183,29 +275,17 @@ void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context
  */
 int64_t GetSourceSampleOffset(ALsource *Source, ALCcontext *context, nanoseconds *clocktime)
 {
-    ALCdevice *device{context->mDevice.get()};
-    const VoiceBufferItem *Current{};
-    uint64_t readPos{};
-    ALuint refcount;
-    Voice *voice;
-
-    do {
-        refcount = device->waitForMix();
-        *clocktime = GetDeviceClockTime(device);
-        voice = GetSourceVoice(Source, context);
-        if(voice)
-        {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
-
-            readPos  = uint64_t{voice->mPosition.load(std::memory_order_relaxed)} << 32;
-            readPos |= uint64_t{voice->mPositionFrac.load(std::memory_order_relaxed)} <<
-                       (32-MixerFracBits);
-        }
-        std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != device->MixCount.load(std::memory_order_relaxed));
-
-    if(!voice)
+    VoicePosition vpos;
+    if(!GetSourceVoicePosition(Source, context, &vpos))
+    {
+        *clocktime = context->mDevice->getClockTime();
         return 0;
+    }
+    *clocktime = vpos.mClockTime;
+
+    const VoiceBufferItem *Current{vpos.mCurrent};
+    uint64_t readPos{uint64_t{vpos.mPos} << 32};
+    readPos |= uint64_t{vpos.mPosFrac} << (32-MixerFracBits);
 
     for(auto &item : Source->mQueue)
     {
@@ -222,28 +302,17 @@ int64_t GetSourceSampleOffset(ALsource *Source, ALCcontext *context, nanoseconds
  */
 double GetSourceSecOffset(ALsource *Source, ALCcontext *context, nanoseconds *clocktime)
 {
-    ALCdevice *device{context->mDevice.get()};
-    const VoiceBufferItem *Current{};
-    uint64_t readPos{};
-    ALuint refcount;
-    Voice *voice;
-
-    do {
-        refcount = device->waitForMix();
-        *clocktime = GetDeviceClockTime(device);
-        voice = GetSourceVoice(Source, context);
-        if(voice)
-        {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
-
-            readPos  = uint64_t{voice->mPosition.load(std::memory_order_relaxed)} << MixerFracBits;
-            readPos |= voice->mPositionFrac.load(std::memory_order_relaxed);
-        }
-        std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != device->MixCount.load(std::memory_order_relaxed));
-
-    if(!voice)
+    VoicePosition vpos;
+    if(!GetSourceVoicePosition(Source, context, &vpos))
+    {
+        *clocktime = context->mDevice->getClockTime();
         return 0.0f;
+    }
+    *clocktime = vpos.mClockTime;
+
+    const VoiceBufferItem *Current{vpos.mCurrent};
+    uint64_t readPos{uint64_t{vpos.mPos} << MixerFracBits};
+    readPos |= vpos.mPosFrac;
 
     const ALbuffer *BufferFmt{nullptr};
     auto BufferList = Source->mQueue.cbegin();
@@ -271,29 +340,14 @@ double GetSourceSecOffset(ALsource *Source, ALCcontext *context, nanoseconds *cl
  */
 double GetSourceOffset(ALsource *Source, ALenum name, ALCcontext *context)
 {
-    ALCdevice *device{context->mDevice.get()};
-    const VoiceBufferItem *Current{};
-    ALuint readPos{};
-    ALuint readPosFrac{};
-    ALuint refcount;
-    Voice *voice;
-
-    do {
-        refcount = device->waitForMix();
-        voice = GetSourceVoice(Source, context);
-        if(voice)
-        {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
-
-            readPos = voice->mPosition.load(std::memory_order_relaxed);
-            readPosFrac = voice->mPositionFrac.load(std::memory_order_relaxed);
-        }
-        std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != device->MixCount.load(std::memory_order_relaxed));
-
-    if(!voice)
+    VoicePosition vpos;
+    if(!GetSourceVoicePosition(Source, context, &vpos))
         return 0.0;
 
+    const VoiceBufferItem *Current{vpos.mCurrent};
+    ALuint readPos{vpos.mPos};
+    const ALuint readPosFrac{vpos.mPosFrac};
+
     const ALbuffer *BufferFmt{nullptr};
     auto BufferList = Source->mQueue.cbegin();
     while(BufferList != Source->mQueue.cend() && std::addressof(*BufferList) != Current)
@@ -448,6 +502,25 @@ void InitVoice(Voice *voice, ALsource *source, ALbufferQueueItem *BufferList, AL
     voice->mAmbiScaling = buffer->mAmbiScaling;
     voice->mAmbiOrder = buffer->mAmbiOrder;
 
+    if(buffer->mChannels == FmtUHJ2)
+    {
+        /* 2-channel UHJ is decoded to first-order horizontal B-Format (W, X,
+         * and Y) using FuMa ordering and scaling.
+         */
+        num_channels = 3;
+        voice->mAmbiLayout = AmbiLayout::FuMa;
+        voice->mAmbiScaling = AmbiScaling::FuMa;
+        voice->mAmbiOrder = 1;
+
+        voice->mDecoder = std::make_unique<UhjDecoder>();
+        voice->mDecodeSamples.resize(num_channels);
+    }
+    else
+    {
+        voice->mDecoder = nullptr;
+        al::vector<Voice::DecodeBufferLine,16>{}.swap(voice->mDecodeSamples);
+    }
+
     if(buffer->mCallback) voice->mFlags |= VoiceIsCallback;
     else if(source->SourceType == AL_STATIC) voice->mFlags |= VoiceIsStatic;
     voice->mNumCallbackSamples = 0;
@@ -467,7 +540,7 @@ void InitVoice(Voice *voice, ALsource *source, ALbufferQueueItem *BufferList, AL
      */
     if(voice->mAmbiOrder && device->mAmbiOrder > voice->mAmbiOrder)
     {
-        const uint8_t *OrderFromChan{(voice->mFmtChannels == FmtBFormat2D) ?
+        const uint8_t *OrderFromChan{Is2DAmbisonic(voice->mFmtChannels) ?
             AmbiIndex::OrderFrom2DChannel().data() :
             AmbiIndex::OrderFromChannel().data()};
         const auto scales = BFormatDec::GetHFOrderScales(voice->mAmbiOrder, device->mAmbiOrder);
@@ -505,7 +578,7 @@ void InitVoice(Voice *voice, ALsource *source, ALbufferQueueItem *BufferList, AL
     }
 
     source->PropsClean.test_and_set(std::memory_order_acq_rel);
-    UpdateSourceProps(source, voice, context);
+    UpdateSourceProps(source, voice, context, false);
 
     voice->mSourceID.store(source->id, std::memory_order_release);
 }
@@ -803,6 +876,27 @@ inline ALeffectslot *LookupEffectSlot(ALCcontext *context, ALuint id) noexcept
     return sublist.EffectSlots + slidx;
 }
 
+/* Locks the context for setting a property on one source. Most properties
+ * only affect the given source, so setting them only needs the context
+ * properties shared and the source's shard of the source lock. Offsets can
+ * replace the source's voice with the context's voice changes, so they need
+ * all the sources locked.
+ */
+class SourcePropSetLock {
+    std::shared_lock<ShardedSharedMutex> mPropLock;
+    std::unique_lock<ShardedSharedMutex> mSourceLock;
+    std::unique_lock<std::shared_timed_mutex> mShardLock;
+
+public:
+    SourcePropSetLock(ALCcontext *context, ALuint id, ALenum param) : mPropLock{context->mPropLock}
+    {
+        if(param == AL_SEC_OFFSET || param == AL_SAMPLE_OFFSET || param == AL_BYTE_OFFSET)
+            mSourceLock = std::unique_lock<ShardedSharedMutex>{context->mSourceLock};
+        else
+            mShardLock = std::unique_lock<std::shared_timed_mutex>{context->mSourceLock.shard(id)};
+    }
+};
+
 
 al::optional<SpatializeMode> SpatializeModeFromEnum(ALenum mode)
 {
@@ -1070,12 +1164,188 @@ ALuint DoubleValsByProp(ALenum prop)
     }
     return 0;
 }
+/* Integer and integer64 properties take the same number of values. */
+ALuint IntValsByProp(ALenum prop)
+{
+    switch(static_cast<SourceProp>(prop))
+    {
+    case AL_PITCH:
+    case AL_GAIN:
+    case AL_MIN_GAIN:
+    case AL_MAX_GAIN:
+    case AL_MAX_DISTANCE:
+    case AL_ROLLOFF_FACTOR:
+    case AL_DOPPLER_FACTOR:
+    case AL_CONE_OUTER_GAIN:
+    case AL_SEC_OFFSET:
+    case AL_SAMPLE_OFFSET:
+    case AL_BYTE_OFFSET:
+    case AL_CONE_INNER_ANGLE:
+    case AL_CONE_OUTER_ANGLE:
+    case AL_REFERENCE_DISTANCE:
+    case AL_CONE_OUTER_GAINHF:
+    case AL_AIR_ABSORPTION_FACTOR:
+    case AL_ROOM_ROLLOFF_FACTOR:
+    case AL_DIRECT_FILTER_GAINHF_AUTO:
+    case AL_AUXILIARY_SEND_FILTER_GAIN_AUTO:
+    case AL_AUXILIARY_SEND_FILTER_GAINHF_AUTO:
+    case AL_DIRECT_CHANNELS_SOFT:
+    case AL_DISTANCE_MODEL:
+    case AL_SOURCE_RELATIVE:
+    case AL_LOOPING:
+    case AL_SOURCE_STATE:
+    case AL_BUFFERS_QUEUED:
+    case AL_BUFFERS_PROCESSED:
+    case AL_SOURCE_TYPE:
+    case AL_SOURCE_RADIUS:
+    case AL_SOURCE_RESAMPLER_SOFT:
+    case AL_SOURCE_SPATIALIZE_SOFT:
+    case AL_BUFFER:
+    case AL_DIRECT_FILTER:
+        return 1;
+
+    case AL_POSITION:
+    case AL_VELOCITY:
+    case AL_DIRECTION:
+    case AL_AUXILIARY_SEND_FILTER:
+        return 3;
+
+    case AL_ORIENTATION:
+        return 6;
+
+    case AL_SEC_OFFSET_LATENCY_SOFT:
+    case AL_SEC_OFFSET_CLOCK_SOFT:
+    case AL_STEREO_ANGLES:
+        break; /* Float/double only */
+    case AL_SAMPLE_OFFSET_LATENCY_SOFT:
+    case AL_SAMPLE_OFFSET_CLOCK_SOFT:
+        break; /* Query only */
+    }
+    return 0;
+}
+
+
+/* Source commands recorded by a thread between alBeginSourceCommandsSOFT and
+ * alCommitSourceCommandsSOFT. The thread records them without taking any
+ * locks, and they're applied together when committed.
+ */
+struct SourceCommand {
+    enum Type : unsigned char {
+        SetFloat,
+        SetInt,
+        SetInt64,
+        Play,
+        Pause,
+        Stop,
+        Rewind,
+        Queue
+    };
+    Type mType;
+    ALenum mParam;
+    ALuint mSource;
+
+    /* The number of property values given, so the property setters can check
+     * it as the call would have.
+     */
+    ALuint mCount;
+
+    /* The source IDs to play, pause, stop, or rewind, or the buffer IDs to
+     * queue, in the command list's ID storage.
+     */
+    size_t mIdOffset;
+    size_t mIdCount;
+
+    union {
+        float mFloats[MaxValues];
+        int mInts[MaxValues];
+        int64_t mInt64s[MaxValues];
+    };
+};
+
+struct SourceCommandList {
+    /* The context commands are being recorded for. Null when not recording. */
+    ContextRef mContext;
+
+    al::vector<SourceCommand> mCommands;
+    al::vector<ALuint> mIds;
+
+    SourceCommand &add(SourceCommand::Type type, ALuint source, ALenum param)
+    {
+        mCommands.emplace_back();
+        SourceCommand &cmd = mCommands.back();
+        cmd.mType = type;
+        cmd.mParam = param;
+        cmd.mSource = source;
+        return cmd;
+    }
+
+    void addFloats(ALuint source, ALenum param, const float *values, ALuint count)
+    {
+        if UNLIKELY(!values)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "NULL pointer");
+        SourceCommand &cmd = add(SourceCommand::SetFloat, source, param);
+        cmd.mCount = count;
+        std::copy_n(values, count, std::begin(cmd.mFloats));
+    }
+    void addDoubles(ALuint source, ALenum param, const double *values, ALuint count)
+    {
+        if UNLIKELY(!values)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "NULL pointer");
+        SourceCommand &cmd = add(SourceCommand::SetFloat, source, param);
+        cmd.mCount = count;
+        std::transform(values, values+count, std::begin(cmd.mFloats),
+            [](const double val) noexcept -> float { return static_cast<float>(val); });
+    }
+    void addInts(ALuint source, ALenum param, const int *values, ALuint count)
+    {
+        if UNLIKELY(!values)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "NULL pointer");
+        SourceCommand &cmd = add(SourceCommand::SetInt, source, param);
+        cmd.mCount = count;
+        std::copy_n(values, count, std::begin(cmd.mInts));
+    }
+    void addInt64s(ALuint source, ALenum param, const int64_t *values, ALuint count)
+    {
+        if UNLIKELY(!values)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "NULL pointer");
+        SourceCommand &cmd = add(SourceCommand::SetInt64, source, param);
+        cmd.mCount = count;
+        std::copy_n(values, count, std::begin(cmd.mInt64s));
+    }
+
+    void addIds(SourceCommand::Type type, ALuint source, const ALuint *ids, ALsizei count)
+    {
+        if UNLIKELY(count < 0)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "Recording %d IDs", count);
+        if UNLIKELY(count == 0) return;
+        if UNLIKELY(!ids)
+            SETERR_RETURN(mContext, AL_INVALID_VALUE,, "NULL pointer");
+
+        SourceCommand &cmd = add(type, source, AL_NONE);
+        cmd.mIdOffset = mIds.size();
+        cmd.mIdCount = static_cast<ALuint>(count);
+        mIds.insert(mIds.end(), ids, ids+count);
+    }
+};
+
+thread_local SourceCommandList ThreadCommands;
 
 
 bool SetSourcefv(ALsource *Source, ALCcontext *Context, SourceProp prop, const al::span<const float> values);
 bool SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const al::span<const int> values);
 bool SetSourcei64v(ALsource *Source, ALCcontext *Context, SourceProp prop, const al::span<const int64_t> values);
 
+/* The source state functions, used by the API functions and when committing
+ * recorded source commands. They're called with the source lock held.
+ * PlaySources also needs the property lock when source parameters are
+ * calculated asynchronously.
+ */
+void PlaySources(ALCcontext *context, const al::span<ALsource*> srchandles);
+void PauseSources(ALCcontext *context, const al::span<ALsource*> srchandles);
+void StopSources(ALCcontext *context, const al::span<ALsource*> srchandles);
+void RewindSources(ALCcontext *context, const al::span<ALsource*> srchandles);
+void QueueSourceBuffers(ALCcontext *context, ALsource *source, const al::span<const ALuint> buffers);
+
 #define CHECKSIZE(v, s) do { \
     if LIKELY((v).size() == (s) || (v).size() == MaxValues) break;            \
     Context->setError(AL_INVALID_ENUM,                                        \
@@ -1092,8 +1362,9 @@ bool SetSourcei64v(ALsource *Source, ALCcontext *Context, SourceProp prop, const
 bool UpdateSourceProps(ALsource *source, ALCcontext *context)
 {
     Voice *voice;
-    if(SourceShouldUpdate(source, context) && (voice=GetSourceVoice(source, context)) != nullptr)
-        UpdateSourceProps(source, voice, context);
+    if(!context->mBatchSourceUpdates && SourceShouldUpdate(source, context)
+        && (voice=GetSourceVoice(source, context)) != nullptr)
+        UpdateSourceProps(source, voice, context, false);
     else
         source->PropsClean.clear(std::memory_order_release);
     return true;
@@ -1326,7 +1597,7 @@ bool SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
     ALCdevice *device{Context->mDevice.get()};
     ALeffectslot *slot{nullptr};
     al::deque<ALbufferQueueItem> oldlist;
-    std::unique_lock<std::mutex> slotlock;
+    std::shared_lock<ShardedSharedMutex> slotlock;
     float fvals[6];
 
     switch(prop)
@@ -1379,7 +1650,7 @@ bool SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
         }
         if(values[0])
         {
-            std::lock_guard<std::mutex> _{device->BufferLock};
+            std::lock_guard<std::shared_timed_mutex> _{device->BufferLock};
             ALbuffer *buffer{LookupBuffer(device, static_cast<ALuint>(values[0]))};
             if(!buffer)
                 SETERR_RETURN(Context, AL_INVALID_VALUE, false, "Invalid buffer ID %u",
@@ -1533,7 +1804,7 @@ bool SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
 
     case AL_AUXILIARY_SEND_FILTER:
         CHECKSIZE(values, 3);
-        slotlock = std::unique_lock<std::mutex>{Context->mEffectSlotLock};
+        slotlock = std::shared_lock<ShardedSharedMutex>{Context->mEffectSlotLock};
         if(values[0] && (slot=LookupEffectSlot(Context, static_cast<ALuint>(values[0]))) == nullptr)
             SETERR_RETURN(Context, AL_INVALID_VALUE, false, "Invalid effect ID %u", values[0]);
         if(static_cast<ALuint>(values[1]) >= device->NumAuxSends)
@@ -1576,7 +1847,7 @@ bool SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
              * active source, in case the slot is about to be deleted.
              */
             Voice *voice{GetSourceVoice(Source, Context)};
-            if(voice) UpdateSourceProps(Source, voice, Context);
+            if(voice) UpdateSourceProps(Source, voice, Context, false);
             else Source->PropsClean.clear(std::memory_order_release);
         }
         else
@@ -1978,7 +2249,12 @@ bool GetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
 
     case AL_SOURCE_STATE:
         CHECKSIZE(values, 1);
-        values[0] = GetSourceState(Source, GetSourceVoice(Source, Context));
+        /* Don't update the source's stored state here, since it's only
+         * being queried.
+         */
+        values[0] = Source->state;
+        if(values[0] == AL_PLAYING && !FindSourceVoice(Source, Context))
+            values[0] = AL_STOPPED;
         return true;
 
     case AL_BUFFERS_QUEUED:
@@ -2001,7 +2277,7 @@ bool GetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, const a
             if(Source->state != AL_INITIAL)
             {
                 const VoiceBufferItem *Current{nullptr};
-                if(Voice *voice{GetSourceVoice(Source, Context)})
+                if(Voice *voice{FindSourceVoice(Source, Context)})
                     Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
                 for(auto &item : Source->mQueue)
                 {
@@ -2264,6 +2540,7 @@ bool GetSourcei64v(ALsource *Source, ALCcontext *Context, SourceProp prop, const
     return false;
 }
 
+
 } // namespace
 
 AL_API void AL_APIENTRY alGenSources(ALsizei n, ALuint *sources)
@@ -2276,7 +2553,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Generating %d sources", n);
     if UNLIKELY(n <= 0) return;
 
-    std::unique_lock<std::mutex> srclock{context->mSourceLock};
+    std::unique_lock<ShardedSharedMutex> srclock{context->mSourceLock};
     ALCdevice *device{context->mDevice.get()};
     if(static_cast<ALuint>(n) > device->SourcesMax-context->mNumSources)
     {
@@ -2317,7 +2594,7 @@ START_API_FUNC
     if UNLIKELY(n < 0)
         SETERR_RETURN(context, AL_INVALID_VALUE,, "Deleting %d sources", n);
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
 
     /* Check that all Sources are valid */
     auto validate_source = [&context](const ALuint sid) -> bool
@@ -2347,7 +2624,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if LIKELY(context)
     {
-        std::lock_guard<std::mutex> _{context->mSourceLock};
+        std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
         if(LookupSource(context.get(), source) != nullptr)
             return AL_TRUE;
     }
@@ -2359,11 +2636,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcef(ALuint source, ALenum param, ALfloat value)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addFloats(source, param, &value, 1u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2375,11 +2657,17 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSource3f(ALuint source, ALenum param, ALfloat value1, ALfloat value2, ALfloat value3)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        const float fvals[3]{ value1, value2, value3 };
+        ThreadCommands.addFloats(source, param, fvals, 3u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2394,11 +2682,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcefv(ALuint source, ALenum param, const ALfloat *values)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addFloats(source, param, values, FloatValsByProp(param));
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2409,15 +2702,112 @@ START_API_FUNC
 }
 END_API_FUNC
 
+AL_API void AL_APIENTRY alSourcesfvSOFT(ALsizei nsources, const ALuint *sources, ALsizei nparams,
+    const ALenum *params, const ALfloat *values)
+START_API_FUNC
+{
+    ContextRef context{GetContextRef()};
+    if UNLIKELY(!context) return;
+
+    if UNLIKELY(nsources < 0 || nparams < 0)
+        SETERR_RETURN(context, AL_INVALID_VALUE,, "Setting %d properties on %d sources",
+            nparams, nsources);
+    if UNLIKELY(nsources == 0 || nparams == 0) return;
+    if UNLIKELY(!sources || !params || !values)
+        SETERR_RETURN(context, AL_INVALID_VALUE,, "NULL pointer");
+
+    /* Each source's values follow the previous source's, in the order of the
+     * given properties.
+     */
+    size_t stride{0};
+    for(ALsizei i{0};i < nparams;++i)
+    {
+        const ALuint count{FloatValsByProp(params[i])};
+        if UNLIKELY(count == 0)
+            SETERR_RETURN(context, AL_INVALID_ENUM,, "Invalid float-vector property 0x%04x",
+                params[i]);
+        stride += count;
+    }
+
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        for(ALsizei s{0};s < nsources;++s)
+        {
+            for(ALsizei i{0};i < nparams;++i)
+            {
+                const ALuint count{FloatValsByProp(params[i])};
+                ThreadCommands.addFloats(sources[s], params[i], values, count);
+                values += count;
+            }
+        }
+        return;
+    }
+
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> __{context->mSourceLock};
+    const al::span<const ALuint> srcids{sources, static_cast<ALuint>(nsources)};
+    for(const ALuint id : srcids)
+    {
+        if UNLIKELY(!LookupSource(context.get(), id))
+            SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid source ID %u", id);
+    }
+
+    /* Set all the properties before updating any voices, so each changed
+     * voice only gets one update. If a value is invalid, the remaining values
+     * aren't set.
+     */
+    context->mBatchSourceUpdates = true;
+    for(const ALuint id : srcids)
+    {
+        ALsource *source{LookupSource(context.get(), id)};
+        const float *srcvals{values};
+        for(ALsizei i{0};i < nparams;++i)
+        {
+            const ALuint count{FloatValsByProp(params[i])};
+            if UNLIKELY(!SetSourcefv(source, context.get(), static_cast<SourceProp>(params[i]),
+                {srcvals, count}))
+                goto done;
+            srcvals += count;
+        }
+        values += stride;
+    }
+done:
+    context->mBatchSourceUpdates = false;
+
+    if(context->mDeferUpdates.load(std::memory_order_acquire))
+        return;
+
+    /* Hold the mixer's updates while providing them, so the whole batch takes
+     * effect together.
+     */
+    context->mHoldUpdates.store(true, std::memory_order_release);
+    while((context->mUpdateCount.load(std::memory_order_acquire)&1) != 0) {
+        /* busy-wait */
+    }
+    for(const ALuint id : srcids)
+    {
+        ALsource *source{LookupSource(context.get(), id)};
+        if(!source->PropsClean.test_and_set(std::memory_order_acq_rel))
+            UpdateSourceProps(source, context.get());
+    }
+    context->mHoldUpdates.store(false, std::memory_order_release);
+}
+END_API_FUNC
+
 
 AL_API void AL_APIENTRY alSourcedSOFT(ALuint source, ALenum param, ALdouble value)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addDoubles(source, param, &value, 1u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2432,11 +2822,17 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSource3dSOFT(ALuint source, ALenum param, ALdouble value1, ALdouble value2, ALdouble value3)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        const double dvals[3]{ value1, value2, value3 };
+        ThreadCommands.addDoubles(source, param, dvals, 3u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2452,11 +2848,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcedvSOFT(ALuint source, ALenum param, const ALdouble *values)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addDoubles(source, param, values, DoubleValsByProp(param));
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2477,11 +2878,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcei(ALuint source, ALenum param, ALint value)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addInts(source, param, &value, 1u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2493,11 +2899,17 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSource3i(ALuint source, ALenum param, ALint value1, ALint value2, ALint value3)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        const int ivals[3]{ value1, value2, value3 };
+        ThreadCommands.addInts(source, param, ivals, 3u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2512,11 +2924,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourceiv(ALuint source, ALenum param, const ALint *values)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addInts(source, param, values, IntValsByProp(param));
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source = LookupSource(context.get(), source);
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2531,11 +2948,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcei64SOFT(ALuint source, ALenum param, ALint64SOFT value)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addInt64s(source, param, &value, 1u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2547,11 +2969,17 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSource3i64SOFT(ALuint source, ALenum param, ALint64SOFT value1, ALint64SOFT value2, ALint64SOFT value3)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        const int64_t i64vals[3]{ value1, value2, value3 };
+        ThreadCommands.addInt64s(source, param, i64vals, 3u);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2566,11 +2994,16 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcei64vSOFT(ALuint source, ALenum param, const ALint64SOFT *values)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addInt64s(source, param, values, IntValsByProp(param));
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
-    std::lock_guard<std::mutex> __{context->mSourceLock};
+    SourcePropSetLock _{context.get(), source, param};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2588,7 +3021,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2609,7 +3042,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2634,7 +3067,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2660,7 +3093,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2677,7 +3110,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2702,7 +3135,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2720,7 +3153,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2737,7 +3170,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2762,7 +3195,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2780,7 +3213,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2797,7 +3230,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2822,7 +3255,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::shared_lock<std::shared_timed_mutex> _{context->mSourceLock.shard(source)};
     ALsource *Source{LookupSource(context.get(), source)};
     if UNLIKELY(!Source)
         context->setError(AL_INVALID_NAME, "Invalid source ID %u", source);
@@ -2842,6 +3275,12 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcePlayv(ALsizei n, const ALuint *sources)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addIds(SourceCommand::Play, 0, sources, n);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
@@ -2860,7 +3299,11 @@ START_API_FUNC
         srchandles = {extra_sources.data(), extra_sources.size()};
     }
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    /* Calculating the new voices' parameters here needs the property lock. */
+    std::unique_lock<ShardedSharedMutex> proplock{context->mPropLock, std::defer_lock};
+    if(context->mAsyncSourceParams)
+        proplock.lock();
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     for(auto &srchdl : srchandles)
     {
         srchdl = LookupSource(context.get(), *sources);
@@ -2869,6 +3312,14 @@ START_API_FUNC
         ++sources;
     }
 
+    PlaySources(context.get(), srchandles);
+}
+END_API_FUNC
+
+namespace {
+
+void PlaySources(ALCcontext *context, const al::span<ALsource*> srchandles)
+{
     ALCdevice *device{context->mDevice.get()};
     /* If the device is disconnected, go right to stopped. */
     if UNLIKELY(!device->Connected.load(std::memory_order_acquire))
@@ -2936,13 +3387,13 @@ START_API_FUNC
         }
 
         if(!cur)
-            cur = tail = GetVoiceChanger(context.get());
+            cur = tail = GetVoiceChanger(context);
         else
         {
-            cur->mNext.store(GetVoiceChanger(context.get()), std::memory_order_relaxed);
+            cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
             cur = cur->mNext.load(std::memory_order_relaxed);
         }
-        Voice *voice{GetSourceVoice(source, context.get())};
+        Voice *voice{GetSourceVoice(source, context)};
         switch(GetSourceState(source, voice))
         {
         case AL_PAUSED:
@@ -3008,7 +3459,7 @@ START_API_FUNC
                     voice->mFlags |= VoiceIsFading;
             }
         }
-        InitVoice(voice, source, std::addressof(*BufferList), context.get(), device);
+        InitVoice(voice, source, std::addressof(*BufferList), context, device);
 
         source->VoiceIdx = vidx;
         source->state = AL_PLAYING;
@@ -3018,9 +3469,10 @@ START_API_FUNC
         cur->mState = VChangeState::Play;
     }
     if LIKELY(tail)
-        SendVoiceChanges(context.get(), tail);
+        SendVoiceChanges(context, tail);
 }
-END_API_FUNC
+
+} // namespace
 
 
 AL_API void AL_APIENTRY alSourcePause(ALuint source)
@@ -3031,6 +3483,12 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourcePausev(ALsizei n, const ALuint *sources)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addIds(SourceCommand::Pause, 0, sources, n);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
@@ -3049,7 +3507,7 @@ START_API_FUNC
         srchandles = {extra_sources.data(), extra_sources.size()};
     }
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     for(auto &srchdl : srchandles)
     {
         srchdl = LookupSource(context.get(), *sources);
@@ -3058,6 +3516,14 @@ START_API_FUNC
         ++sources;
     }
 
+    PauseSources(context.get(), srchandles);
+}
+END_API_FUNC
+
+namespace {
+
+void PauseSources(ALCcontext *context, const al::span<ALsource*> srchandles)
+{
     /* Pausing has to be done in two steps. First, for each source that's
      * detected to be playing, chamge the voice (asynchronously) to
      * stopping/paused.
@@ -3065,14 +3531,14 @@ START_API_FUNC
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
     {
-        Voice *voice{GetSourceVoice(source, context.get())};
+        Voice *voice{GetSourceVoice(source, context)};
         if(GetSourceState(source, voice) == AL_PLAYING)
         {
             if(!cur)
-                cur = tail = GetVoiceChanger(context.get());
+                cur = tail = GetVoiceChanger(context);
             else
             {
-                cur->mNext.store(GetVoiceChanger(context.get()), std::memory_order_relaxed);
+                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
                 cur = cur->mNext.load(std::memory_order_relaxed);
             }
             cur->mVoice = voice;
@@ -3082,7 +3548,7 @@ START_API_FUNC
     }
     if LIKELY(tail)
     {
-        SendVoiceChanges(context.get(), tail);
+        SendVoiceChanges(context, tail);
         /* Second, now that the voice changes have been sent, because it's
          * possible that the voice stopped after it was detected playing and
          * before the voice got paused, recheck that the source is still
@@ -3090,13 +3556,14 @@ START_API_FUNC
          */
         for(ALsource *source : srchandles)
         {
-            Voice *voice{GetSourceVoice(source, context.get())};
+            Voice *voice{GetSourceVoice(source, context)};
             if(GetSourceState(source, voice) == AL_PLAYING)
                 source->state = AL_PAUSED;
         }
     }
 }
-END_API_FUNC
+
+} // namespace
 
 
 AL_API void AL_APIENTRY alSourceStop(ALuint source)
@@ -3107,6 +3574,12 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourceStopv(ALsizei n, const ALuint *sources)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addIds(SourceCommand::Stop, 0, sources, n);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
@@ -3125,7 +3598,7 @@ START_API_FUNC
         srchandles = {extra_sources.data(), extra_sources.size()};
     }
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     for(auto &srchdl : srchandles)
     {
         srchdl = LookupSource(context.get(), *sources);
@@ -3134,16 +3607,24 @@ START_API_FUNC
         ++sources;
     }
 
+    StopSources(context.get(), srchandles);
+}
+END_API_FUNC
+
+namespace {
+
+void StopSources(ALCcontext *context, const al::span<ALsource*> srchandles)
+{
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
     {
-        if(Voice *voice{GetSourceVoice(source, context.get())})
+        if(Voice *voice{GetSourceVoice(source, context)})
         {
             if(!cur)
-                cur = tail = GetVoiceChanger(context.get());
+                cur = tail = GetVoiceChanger(context);
             else
             {
-                cur->mNext.store(GetVoiceChanger(context.get()), std::memory_order_relaxed);
+                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
                 cur = cur->mNext.load(std::memory_order_relaxed);
             }
             voice->mPendingChange.store(true, std::memory_order_relaxed);
@@ -3157,9 +3638,10 @@ START_API_FUNC
         source->VoiceIdx = INVALID_VOICE_IDX;
     }
     if LIKELY(tail)
-        SendVoiceChanges(context.get(), tail);
+        SendVoiceChanges(context, tail);
 }
-END_API_FUNC
+
+} // namespace
 
 
 AL_API void AL_APIENTRY alSourceRewind(ALuint source)
@@ -3170,6 +3652,12 @@ END_API_FUNC
 AL_API void AL_APIENTRY alSourceRewindv(ALsizei n, const ALuint *sources)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addIds(SourceCommand::Rewind, 0, sources, n);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
@@ -3188,7 +3676,7 @@ START_API_FUNC
         srchandles = {extra_sources.data(), extra_sources.size()};
     }
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     for(auto &srchdl : srchandles)
     {
         srchdl = LookupSource(context.get(), *sources);
@@ -3197,17 +3685,25 @@ START_API_FUNC
         ++sources;
     }
 
+    RewindSources(context.get(), srchandles);
+}
+END_API_FUNC
+
+namespace {
+
+void RewindSources(ALCcontext *context, const al::span<ALsource*> srchandles)
+{
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
     {
-        Voice *voice{GetSourceVoice(source, context.get())};
+        Voice *voice{GetSourceVoice(source, context)};
         if(source->state != AL_INITIAL)
         {
             if(!cur)
-                cur = tail = GetVoiceChanger(context.get());
+                cur = tail = GetVoiceChanger(context);
             else
             {
-                cur->mNext.store(GetVoiceChanger(context.get()), std::memory_order_relaxed);
+                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
                 cur = cur->mNext.load(std::memory_order_relaxed);
             }
             if(voice)
@@ -3222,14 +3718,21 @@ START_API_FUNC
         source->VoiceIdx = INVALID_VOICE_IDX;
     }
     if LIKELY(tail)
-        SendVoiceChanges(context.get(), tail);
+        SendVoiceChanges(context, tail);
 }
-END_API_FUNC
+
+} // namespace
 
 
 AL_API void AL_APIENTRY alSourceQueueBuffers(ALuint src, ALsizei nb, const ALuint *buffers)
 START_API_FUNC
 {
+    if UNLIKELY(ThreadCommands.mContext)
+    {
+        ThreadCommands.addIds(SourceCommand::Queue, src, buffers, nb);
+        return;
+    }
+
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
@@ -3237,14 +3740,23 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Queueing %d buffers", nb);
     if UNLIKELY(nb <= 0) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     ALsource *source{LookupSource(context.get(),src)};
     if UNLIKELY(!source)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid source ID %u", src);
 
+    QueueSourceBuffers(context.get(), source, {buffers, static_cast<ALuint>(nb)});
+}
+END_API_FUNC
+
+namespace {
+
+void QueueSourceBuffers(ALCcontext *context, ALsource *source, const al::span<const ALuint> buffers)
+{
     /* Can't queue on a Static Source */
     if UNLIKELY(source->SourceType == AL_STATIC)
-        SETERR_RETURN(context, AL_INVALID_OPERATION,, "Queueing onto static source %u", src);
+        SETERR_RETURN(context, AL_INVALID_OPERATION,, "Queueing onto static source %u",
+            source->id);
 
     /* Check for a valid Buffer, for its frequency and format */
     ALCdevice *device{context->mDevice.get()};
@@ -3255,10 +3767,10 @@ START_API_FUNC
         if(BufferFmt) break;
     }
 
-    std::unique_lock<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_timed_mutex> buflock{device->BufferLock};
     const size_t NewListStart{source->mQueue.size()};
     ALbufferQueueItem *BufferList{nullptr};
-    for(ALsizei i{0};i < nb;i++)
+    for(size_t i{0};i < buffers.size();++i)
     {
         bool fmt_mismatch{false};
         ALbuffer *buffer{nullptr};
@@ -3340,7 +3852,8 @@ START_API_FUNC
         (iter-1)->mNext.store(std::addressof(*iter), std::memory_order_release);
     }
 }
-END_API_FUNC
+
+} // namespace
 
 AL_API void AL_APIENTRY alSourceUnqueueBuffers(ALuint src, ALsizei nb, ALuint *buffers)
 START_API_FUNC
@@ -3352,7 +3865,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Unqueueing %d buffers", nb);
     if UNLIKELY(nb <= 0) return;
 
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     ALsource *source{LookupSource(context.get(),src)};
     if UNLIKELY(!source)
         SETERR_RETURN(context, AL_INVALID_NAME,, "Invalid source ID %u", src);
@@ -3396,6 +3909,129 @@ START_API_FUNC
 END_API_FUNC
 
 
+AL_API void AL_APIENTRY alBeginSourceCommandsSOFT(void)
+START_API_FUNC
+{
+    ContextRef context{GetContextRef()};
+    if UNLIKELY(!context) return;
+
+    SourceCommandList &cmdlist = ThreadCommands;
+    if UNLIKELY(cmdlist.mContext)
+        SETERR_RETURN(context, AL_INVALID_OPERATION,, "Already recording source commands");
+    cmdlist.mContext = std::move(context);
+}
+END_API_FUNC
+
+AL_API void AL_APIENTRY alCommitSourceCommandsSOFT(void)
+START_API_FUNC
+{
+    SourceCommandList &cmdlist = ThreadCommands;
+    ContextRef context{std::move(cmdlist.mContext)};
+    if UNLIKELY(!context)
+    {
+        context = GetContextRef();
+        if(context)
+            context->setError(AL_INVALID_OPERATION, "Not recording source commands");
+        return;
+    }
+
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> __{context->mSourceLock};
+
+    al::vector<ALsource*> srchandles;
+    auto lookup_sources = [&context,&cmdlist,&srchandles](const SourceCommand &cmd) -> bool
+    {
+        srchandles.clear();
+        const ALuint *sources{cmdlist.mIds.data() + cmd.mIdOffset};
+        for(size_t i{0};i < cmd.mIdCount;++i)
+        {
+            ALsource *source{LookupSource(context.get(), sources[i])};
+            if UNLIKELY(!source)
+                SETERR_RETURN(context, AL_INVALID_NAME, false, "Invalid source ID %u",
+                    sources[i]);
+            srchandles.emplace_back(source);
+        }
+        return true;
+    };
+
+    /* Apply the commands in the order they were recorded, with each failed
+     * command setting an error as the call would have. Voices are only
+     * updated with the new properties after all the commands are applied.
+     */
+    context->mBatchSourceUpdates = true;
+    for(const SourceCommand &cmd : cmdlist.mCommands)
+    {
+        if(cmd.mType == SourceCommand::Play || cmd.mType == SourceCommand::Pause
+            || cmd.mType == SourceCommand::Stop || cmd.mType == SourceCommand::Rewind)
+        {
+            if(!lookup_sources(cmd))
+                continue;
+            if(cmd.mType == SourceCommand::Play)
+                PlaySources(context.get(), srchandles);
+            else if(cmd.mType == SourceCommand::Pause)
+                PauseSources(context.get(), srchandles);
+            else if(cmd.mType == SourceCommand::Stop)
+                StopSources(context.get(), srchandles);
+            else
+                RewindSources(context.get(), srchandles);
+            continue;
+        }
+
+        ALsource *source{LookupSource(context.get(), cmd.mSource)};
+        if UNLIKELY(!source)
+        {
+            context->setError(AL_INVALID_NAME, "Invalid source ID %u", cmd.mSource);
+            continue;
+        }
+        const auto prop = static_cast<SourceProp>(cmd.mParam);
+        switch(cmd.mType)
+        {
+        case SourceCommand::SetFloat:
+            SetSourcefv(source, context.get(), prop, {cmd.mFloats, cmd.mCount});
+            break;
+        case SourceCommand::SetInt:
+            SetSourceiv(source, context.get(), prop, {cmd.mInts, cmd.mCount});
+            break;
+        case SourceCommand::SetInt64:
+            SetSourcei64v(source, context.get(), prop, {cmd.mInt64s, cmd.mCount});
+            break;
+        case SourceCommand::Queue:
+            QueueSourceBuffers(context.get(), source,
+                {cmdlist.mIds.data() + cmd.mIdOffset, cmd.mIdCount});
+            break;
+        case SourceCommand::Play:
+        case SourceCommand::Pause:
+        case SourceCommand::Stop:
+        case SourceCommand::Rewind:
+            break;
+        }
+    }
+    context->mBatchSourceUpdates = false;
+
+    if(!context->mDeferUpdates.load(std::memory_order_acquire))
+    {
+        /* Hold the mixer's updates while providing them, so all the property
+         * changes take effect together.
+         */
+        context->mHoldUpdates.store(true, std::memory_order_release);
+        while((context->mUpdateCount.load(std::memory_order_acquire)&1) != 0) {
+            /* busy-wait */
+        }
+        for(const SourceCommand &cmd : cmdlist.mCommands)
+        {
+            ALsource *source{LookupSource(context.get(), cmd.mSource)};
+            if(source && !source->PropsClean.test_and_set(std::memory_order_acq_rel))
+                UpdateSourceProps(source, context.get());
+        }
+        context->mHoldUpdates.store(false, std::memory_order_release);
+    }
+
+    cmdlist.mCommands.clear();
+    cmdlist.mIds.clear();
+}
+END_API_FUNC
+
+
 AL_API void AL_APIENTRY alSourceQueueBufferLayersSOFT(ALuint, ALsizei, const ALuint*)
 START_API_FUNC
 {
@@ -3440,9 +4076,9 @@ ALsource::~ALsource()
     std::for_each(Send.begin(), Send.end(), clear_send);
 }
 
-void UpdateAllSourceProps(ALCcontext *context)
+void UpdateAllSourceProps(ALCcontext *context, const bool hasstate)
 {
-    std::lock_guard<std::mutex> _{context->mSourceLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mSourceLock};
     auto voicelist = context->getVoicesSpan();
     ALuint vidx{0u};
     for(Voice *voice : voicelist)
@@ -3452,7 +4088,7 @@ void UpdateAllSourceProps(ALCcontext *context)
         if(source && source->VoiceIdx == vidx)
         {
             if(!source->PropsClean.test_and_set(std::memory_order_acq_rel))
-                UpdateSourceProps(source, voice, context);
+                UpdateSourceProps(source, voice, context, hasstate);
         }
         ++vidx;
     }
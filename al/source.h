@@ -129,6 +129,9 @@ struct ALsource {
     DISABLE_ALLOC()
 };
 
-void UpdateAllSourceProps(ALCcontext *context);
+/* Sends pending property updates for the playing and paused sources to the
+ * mixer. The caller sets hasstate if it's holding the device's state lock.
+ */
+void UpdateAllSourceProps(ALCcontext *context, const bool hasstate);
 
 #endif
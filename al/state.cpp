@@ -27,6 +27,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
+#include <shared_mutex>
 
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -152,7 +153,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(capability)
     {
     case AL_SOURCE_DISTANCE_MODEL:
@@ -160,6 +161,14 @@ START_API_FUNC
         DO_UPDATEPROPS();
         break;
 
+    case AL_EVENT_QUEUE_SOFTX:
+        context->mEventQueueing.store(true, std::memory_order_release);
+        break;
+
+    case AL_EVENT_MESSAGES_SOFTX:
+        context->mEventMessages.store(true, std::memory_order_relaxed);
+        break;
+
     default:
         context->setError(AL_INVALID_VALUE, "Invalid enable property 0x%04x", capability);
     }
@@ -172,7 +181,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
     switch(capability)
     {
     case AL_SOURCE_DISTANCE_MODEL:
@@ -180,6 +189,14 @@ START_API_FUNC
         DO_UPDATEPROPS();
         break;
 
+    case AL_EVENT_QUEUE_SOFTX:
+        context->mEventQueueing.store(false, std::memory_order_release);
+        break;
+
+    case AL_EVENT_MESSAGES_SOFTX:
+        context->mEventMessages.store(false, std::memory_order_relaxed);
+        break;
+
     default:
         context->setError(AL_INVALID_VALUE, "Invalid disable property 0x%04x", capability);
     }
@@ -192,7 +209,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return AL_FALSE;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALboolean value{AL_FALSE};
     switch(capability)
     {
@@ -200,6 +217,14 @@ START_API_FUNC
         value = context->mSourceDistanceModel ? AL_TRUE : AL_FALSE;
         break;
 
+    case AL_EVENT_QUEUE_SOFTX:
+        value = context->mEventQueueing.load(std::memory_order_relaxed) ? AL_TRUE : AL_FALSE;
+        break;
+
+    case AL_EVENT_MESSAGES_SOFTX:
+        value = context->mEventMessages.load(std::memory_order_relaxed) ? AL_TRUE : AL_FALSE;
+        break;
+
     default:
         context->setError(AL_INVALID_VALUE, "Invalid is enabled property 0x%04x", capability);
     }
@@ -214,7 +239,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return AL_FALSE;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALboolean value{AL_FALSE};
     switch(pname)
     {
@@ -271,7 +296,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return 0.0;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALdouble value{0.0};
     switch(pname)
     {
@@ -322,7 +347,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return 0.0f;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALfloat value{0.0f};
     switch(pname)
     {
@@ -373,7 +398,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return 0;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALint value{0};
     switch(pname)
     {
@@ -410,6 +435,22 @@ START_API_FUNC
         value = static_cast<int>(ResamplerDefault);
         break;
 
+    case AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<int>(context->mVoicePropsPool.getHighWater());
+        break;
+
+    case AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<int>(context->mEffectSlotPropsPool.getHighWater());
+        break;
+
+    case AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<int>(context->mListenerPropsPool.getHighWater());
+        break;
+
+    case AL_EVENT_FD_SOFTX:
+        value = context->mEventFd;
+        break;
+
     default:
         context->setError(AL_INVALID_VALUE, "Invalid integer property 0x%04x", pname);
     }
@@ -424,7 +465,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return 0_i64;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     ALint64SOFT value{0};
     switch(pname)
     {
@@ -461,6 +502,22 @@ START_API_FUNC
         value = static_cast<ALint64SOFT>(ResamplerDefault);
         break;
 
+    case AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<ALint64SOFT>(context->mVoicePropsPool.getHighWater());
+        break;
+
+    case AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<ALint64SOFT>(context->mEffectSlotPropsPool.getHighWater());
+        break;
+
+    case AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX:
+        value = static_cast<ALint64SOFT>(context->mListenerPropsPool.getHighWater());
+        break;
+
+    case AL_EVENT_FD_SOFTX:
+        value = context->mEventFd;
+        break;
+
     default:
         context->setError(AL_INVALID_VALUE, "Invalid integer64 property 0x%04x", pname);
     }
@@ -475,7 +532,7 @@ START_API_FUNC
     ContextRef context{GetContextRef()};
     if UNLIKELY(!context) return nullptr;
 
-    std::lock_guard<std::mutex> _{context->mPropLock};
+    std::shared_lock<ShardedSharedMutex> _{context->mPropLock};
     void *value{nullptr};
     switch(pname)
     {
@@ -609,6 +666,10 @@ START_API_FUNC
             case AL_GAIN_LIMIT_SOFT:
             case AL_NUM_RESAMPLERS_SOFT:
             case AL_DEFAULT_RESAMPLER_SOFT:
+            case AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_EVENT_FD_SOFTX:
                 values[0] = alGetInteger(pname);
                 return;
         }
@@ -642,6 +703,10 @@ START_API_FUNC
             case AL_GAIN_LIMIT_SOFT:
             case AL_NUM_RESAMPLERS_SOFT:
             case AL_DEFAULT_RESAMPLER_SOFT:
+            case AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX:
+            case AL_EVENT_FD_SOFTX:
                 values[0] = alGetInteger64SOFT(pname);
                 return;
         }
@@ -753,7 +818,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Doppler factor %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> _{context->mPropLock};
+        std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
         context->mDopplerFactor = value;
         DO_UPDATEPROPS();
     }
@@ -770,7 +835,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Doppler velocity %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> _{context->mPropLock};
+        std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
         context->mDopplerVelocity = value;
         DO_UPDATEPROPS();
     }
@@ -787,7 +852,7 @@ START_API_FUNC
         context->setError(AL_INVALID_VALUE, "Speed of sound %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> _{context->mPropLock};
+        std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
         context->mSpeedOfSound = value;
         DO_UPDATEPROPS();
     }
@@ -802,7 +867,7 @@ START_API_FUNC
 
     if(auto model = DistanceModelFromALenum(value))
     {
-        std::lock_guard<std::mutex> _{context->mPropLock};
+        std::lock_guard<ShardedSharedMutex> _{context->mPropLock};
         context->mDistanceModel = *model;
         if(!context->mSourceDistanceModel)
             DO_UPDATEPROPS();
@@ -860,18 +925,13 @@ END_API_FUNC
 
 void UpdateContextProps(ALCcontext *context)
 {
-    /* Get an unused proprty container, or allocate a new one as needed. */
-    ContextProps *props{context->mFreeContextProps.load(std::memory_order_acquire)};
+    /* Take back the pending update if the mixer hasn't gotten to it yet, or
+     * get an unused property container from the pool.
+     */
+    ContextProps *props{context->mParams.ContextUpdate.exchange(nullptr,
+        std::memory_order_acq_rel)};
     if(!props)
-        props = new ContextProps{};
-    else
-    {
-        ContextProps *next;
-        do {
-            next = props->next.load(std::memory_order_relaxed);
-        } while(context->mFreeContextProps.compare_exchange_weak(props, next,
-                std::memory_order_seq_cst, std::memory_order_acquire) == 0);
-    }
+        props = context->mContextPropsPool.get();
 
     /* Copy in current property values. */
     props->DopplerFactor = context->mDopplerFactor;
@@ -881,13 +941,16 @@ void UpdateContextProps(ALCcontext *context)
     props->SourceDistanceModel = context->mSourceDistanceModel;
     props->mDistanceModel = context->mDistanceModel;
 
+    props->Stamp = context->mSentParams.ContextStamp + 1;
+    SetContextParams(context->mSentParams, *props);
+
     /* Set the new container for updating internal parameters. */
     props = context->mParams.ContextUpdate.exchange(props, std::memory_order_acq_rel);
     if(props)
     {
         /* If there was an unused update container, put it back in the
-         * freelist.
+         * pool.
          */
-        AtomicReplaceHead(context->mFreeContextProps, props);
+        context->mContextPropsPool.put(props);
     }
 }
@@ -48,6 +48,7 @@
 #include <mutex>
 #include <new>
 #include <numeric>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -89,6 +90,7 @@
 #include "core/filters/splitter.h"
 #include "core/fpu_ctrl.h"
 #include "core/logging.h"
+#include "core/trace.h"
 #include "core/uhjfilter.h"
 #include "effects/base.h"
 #include "front_stablizer.h"
@@ -414,6 +416,13 @@ const struct {
     DECL(alAuxiliaryEffectSlotPlayvSOFT),
     DECL(alAuxiliaryEffectSlotStopSOFT),
     DECL(alAuxiliaryEffectSlotStopvSOFT),
+
+    DECL(alSourcesfvSOFT),
+
+    DECL(alBeginSourceCommandsSOFT),
+    DECL(alCommitSourceCommandsSOFT),
+
+    DECL(alReadEventsSOFT),
 };
 #undef DECL
 
@@ -600,6 +609,10 @@ constexpr struct {
     DECL(AL_FORMAT_BFORMAT3D_FLOAT32),
     DECL(AL_FORMAT_BFORMAT3D_MULAW),
 
+    DECL(AL_FORMAT_UHJ2CHN8_SOFT),
+    DECL(AL_FORMAT_UHJ2CHN16_SOFT),
+    DECL(AL_FORMAT_UHJ2CHN_FLOAT32_SOFT),
+
     DECL(AL_FREQUENCY),
     DECL(AL_BITS),
     DECL(AL_CHANNELS),
@@ -821,6 +834,29 @@ constexpr struct {
 
     DECL(AL_EFFECT_CONVOLUTION_REVERB_SOFT),
     DECL(AL_EFFECTSLOT_STATE_SOFT),
+
+    DECL(ALC_SOURCE_PROPERTY_POOL_SIZE_SOFTX),
+    DECL(AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX),
+    DECL(AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX),
+    DECL(AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX),
+    DECL(ALC_RESERVED_VOICES_SOFTX),
+    DECL(ALC_EFFECTSLOT_PROPERTY_POOL_SIZE_SOFTX),
+    DECL(AL_EVENT_QUEUE_SOFTX),
+    DECL(AL_EVENT_MESSAGES_SOFTX),
+    DECL(AL_EVENT_FD_SOFTX),
+
+    DECL(ALC_MIXER_PERIODS_SOFTX),
+    DECL(ALC_MIXER_TOTAL_TIME_SOFTX),
+    DECL(ALC_MIXER_STAGE_TIMES_SOFTX),
+    DECL(ALC_MIXER_MAX_PERIOD_TIME_SOFTX),
+    DECL(ALC_MIXER_PERIOD_PERCENTILES_SOFTX),
+    DECL(ALC_MIXER_DEADLINE_MISSES_SOFTX),
+    DECL(ALC_MIXER_ACTIVE_VOICES_SOFTX),
+    DECL(ALC_MIXER_IDLE_VOICES_SOFTX),
+
+    DECL(ALC_BACKEND_XRUNS_SOFTX),
+    DECL(ALC_BACKEND_CALLBACK_JITTER_SOFTX),
+    DECL(ALC_BACKEND_WAKEUP_LATENCY_SOFTX),
 };
 #undef DECL
 
@@ -873,16 +909,21 @@ constexpr ALchar alExtList[] =
     "AL_SOFT_direct_channels "
     "AL_SOFT_direct_channels_remix "
     "AL_SOFT_effect_target "
+    "AL_SOFTX_event_queue "
     "AL_SOFT_events "
     "AL_SOFTX_filter_gain_ex "
     "AL_SOFT_gain_clamp_ex "
     "AL_SOFT_loop_points "
     "AL_SOFTX_map_buffer "
     "AL_SOFT_MSADPCM "
+    "AL_SOFTX_property_pools "
+    "AL_SOFTX_source_batch "
+    "AL_SOFTX_source_commands "
     "AL_SOFT_source_latency "
     "AL_SOFT_source_length "
     "AL_SOFT_source_resampler "
-    "AL_SOFT_source_spatialize";
+    "AL_SOFT_source_spatialize "
+    "AL_SOFTX_UHJ";
 
 std::atomic<ALCenum> LastNullDeviceError{ALC_NO_ERROR};
 
@@ -951,6 +992,9 @@ constexpr ALCchar alcExtensionList[] =
     "ALC_EXT_disconnect "
     "ALC_EXT_EFX "
     "ALC_EXT_thread_local_context "
+    "ALC_SOFTX_backend_stats "
+    "ALC_SOFTX_mixer_stats "
+    "ALC_SOFTX_reserved_voices "
     "ALC_SOFT_device_clock "
     "ALC_SOFT_HRTF "
     "ALC_SOFT_loopback "
@@ -1015,6 +1059,29 @@ void alc_initconfig(void)
     }
 #endif
 
+    auto tracevoices = al::getenv("ALSOFT_TRACE_VOICES");
+    const bool trace_voices{tracevoices && (al::strcasecmp(tracevoices->c_str(), "true") == 0
+        || std::strtol(tracevoices->c_str(), nullptr, 0) == 1)};
+#ifdef _WIN32
+    if(const auto tracefile = al::getenv(L"ALSOFT_TRACEFILE"))
+    {
+        FILE *tracef{_wfopen(tracefile->c_str(), L"wt")};
+        if(tracef) StartTracing(tracef, trace_voices);
+        else
+        {
+            auto u8name = wstr_to_utf8(tracefile->c_str());
+            ERR("Failed to open trace file '%s'\n", u8name.c_str());
+        }
+    }
+#else
+    if(const auto tracefile = al::getenv("ALSOFT_TRACEFILE"))
+    {
+        FILE *tracef{fopen(tracefile->c_str(), "wt")};
+        if(tracef) StartTracing(tracef, trace_voices);
+        else ERR("Failed to open trace file '%s'\n", tracefile->c_str());
+    }
+#endif
+
     TRACE("Initializing library v%s-%s %s\n", ALSOFT_VERSION, ALSOFT_GIT_COMMIT_HASH,
         ALSOFT_GIT_BRANCH);
     {
@@ -1530,7 +1597,7 @@ const std::array<InputRemixMap,1> X71Downmix{{
 
 void ALCcontext::processUpdates()
 {
-    std::lock_guard<std::mutex> _{mPropLock};
+    std::lock_guard<ShardedSharedMutex> _{mPropLock};
     if(mDeferUpdates.exchange(false, std::memory_order_acq_rel))
     {
         /* Tell the mixer to stop applying updates, then wait for any active
@@ -1546,7 +1613,7 @@ void ALCcontext::processUpdates()
         if(!mListener.PropsClean.test_and_set(std::memory_order_acq_rel))
             UpdateListenerProps(this);
         UpdateAllEffectSlotProps(this);
-        UpdateAllSourceProps(this);
+        UpdateAllSourceProps(this, false);
 
         /* Now with all updates declared, let the mixer continue applying them
          * so they all happen at once.
@@ -1575,6 +1642,8 @@ void ALCcontext::allocVoiceChanges(size_t addcount)
 
 void ALCcontext::allocVoices(size_t addcount)
 {
+    freeRetiredVoices();
+
     constexpr size_t clustersize{32};
     /* Convert element count to cluster count. */
     addcount = (addcount+(clustersize-1)) / clustersize;
@@ -1598,11 +1667,32 @@ void ALCcontext::allocVoices(size_t addcount)
             *(voice_iter++) = &cluster[i];
     }
 
-    if(auto *oldvoices = mVoices.exchange(newarray.release(), std::memory_order_acq_rel))
-    {
-        mDevice->waitForMix();
-        delete oldvoices;
-    }
+    std::unique_ptr<VoiceArray> oldvoices{mVoices.exchange(newarray.release(),
+        std::memory_order_acq_rel)};
+    if(!oldvoices) return;
+
+    /* Rather than waiting for the mixer to finish with the old array, note
+     * the mix count it was replaced at. The mixer only reads the array while
+     * the count is odd, so an even count means no mix can still be using it,
+     * and an odd one means it can be deleted once that mix ends.
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint refcount{ReadRef(mDevice->MixCount)};
+    if(!(refcount&1))
+        return;
+    mRetiredVoices.emplace_back(RetiredVoiceArray{std::move(oldvoices), refcount});
+}
+
+void ALCcontext::freeRetiredVoices()
+{
+    if(mRetiredVoices.empty())
+        return;
+
+    const uint refcount{ReadRef(mDevice->MixCount)};
+    auto is_done = [refcount](const RetiredVoiceArray &retired) noexcept -> bool
+    { return retired.mMixCount != refcount; };
+    mRetiredVoices.erase(std::remove_if(mRetiredVoices.begin(), mRetiredVoices.end(), is_done),
+        mRetiredVoices.end());
 }
 
 
@@ -1660,6 +1750,7 @@ static inline void UpdateClockBase(ALCdevice *device)
     IncrementRef(device->MixCount);
     device->ClockBase += nanoseconds{seconds{device->SamplesDone}} / device->Frequency;
     device->SamplesDone = 0;
+    device->mClockTime.store(device->ClockBase.count(), std::memory_order_relaxed);
     IncrementRef(device->MixCount);
 }
 
@@ -1811,6 +1902,8 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
         device->Flags.reset(DeviceRunning);
 
         UpdateClockBase(device);
+        device->mMixStats.reset();
+        device->Backend->mStats.reset();
 
         const char *devname{nullptr};
         if(loopback)
@@ -1996,7 +2089,7 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
 
     nanoseconds::rep sample_delay{0};
     if(device->Uhj_Encoder)
-        sample_delay += Uhj2Encoder::sFilterSize;
+        sample_delay += static_cast<nanoseconds::rep>(device->Uhj_Encoder->mFilterDelay);
     if(device->mHrtfState)
         sample_delay += HrtfDirectDelay;
     if(auto *ambidec = device->AmbiDecoder.get())
@@ -2108,8 +2201,8 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
             if(!buffer) return EffectState::Buffer{};
             return EffectState::Buffer{buffer, buffer->mData};
         };
-        std::unique_lock<std::mutex> proplock{context->mPropLock};
-        std::unique_lock<std::mutex> slotlock{context->mEffectSlotLock};
+        std::unique_lock<ShardedSharedMutex> proplock{context->mPropLock};
+        std::unique_lock<ShardedSharedMutex> slotlock{context->mEffectSlotLock};
 
         /* Clear out unused wet buffers. */
         auto buffer_not_in_use = [](WetBufferPtr &wetbuffer) noexcept -> bool
@@ -2150,7 +2243,7 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
         slotlock.unlock();
 
         const uint num_sends{device->NumAuxSends};
-        std::unique_lock<std::mutex> srclock{context->mSourceLock};
+        std::unique_lock<ShardedSharedMutex> srclock{context->mSourceLock};
         for(auto &sublist : context->mSourceList)
         {
             uint64_t usemask{~sublist.FreeMask};
@@ -2178,18 +2271,6 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
             }
         }
 
-        /* Clear any pre-existing voice property structs, in case the number of
-         * auxiliary sends is changing. Active sources will have updates
-         * respecified in UpdateAllSourceProps.
-         */
-        VoicePropsItem *vprops{context->mFreeVoiceProps.exchange(nullptr, std::memory_order_acq_rel)};
-        while(vprops)
-        {
-            VoicePropsItem *next = vprops->next.load(std::memory_order_relaxed);
-            delete vprops;
-            vprops = next;
-        }
-
         auto voicelist = context->getVoicesSpan();
         for(Voice *voice : voicelist)
         {
@@ -2204,7 +2285,11 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
                     SendParams{});
             }
 
-            delete voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel);
+            /* Active sources will have updates respecified in
+             * UpdateAllSourceProps.
+             */
+            if(VoicePropsItem *vprops{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)})
+                context->mVoicePropsPool.put(vprops);
 
             /* Force the voice to stopped if it was stopping. */
             Voice::State vstate{Voice::Stopping};
@@ -2218,7 +2303,7 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
 
             if(voice->mAmbiOrder && device->mAmbiOrder > voice->mAmbiOrder)
             {
-                const uint8_t *OrderFromChan{(voice->mFmtChannels == FmtBFormat2D) ?
+                const uint8_t *OrderFromChan{Is2DAmbisonic(voice->mFmtChannels) ?
                     AmbiIndex::OrderFrom2DChannel().data() :
                     AmbiIndex::OrderFromChannel().data()};
 
@@ -2266,7 +2351,7 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const int *attrList)
         UpdateContextProps(context);
         context->mListener.PropsClean.test_and_set(std::memory_order_release);
         UpdateListenerProps(context);
-        UpdateAllSourceProps(context);
+        UpdateAllSourceProps(context, true);
     }
     mixer_mode.leave();
 
@@ -2345,22 +2430,7 @@ ALCcontext::~ALCcontext()
 {
     TRACE("Freeing context %p\n", voidp{this});
 
-    size_t count{0};
-    ContextProps *cprops{mParams.ContextUpdate.exchange(nullptr, std::memory_order_relaxed)};
-    if(cprops)
-    {
-        ++count;
-        delete cprops;
-    }
-    cprops = mFreeContextProps.exchange(nullptr, std::memory_order_acquire);
-    while(cprops)
-    {
-        std::unique_ptr<ContextProps> old{cprops};
-        cprops = old->next.load(std::memory_order_relaxed);
-        ++count;
-    }
-    TRACE("Freed %zu context property object%s\n", count, (count==1)?"":"s");
-
+    size_t count;
     count = std::accumulate(mSourceList.cbegin(), mSourceList.cend(), size_t{0u},
         [](size_t cur, const SourceSubList &sublist) noexcept -> size_t
         { return cur + static_cast<uint>(al::popcount(~sublist.FreeMask)); });
@@ -2369,16 +2439,6 @@ ALCcontext::~ALCcontext()
     mSourceList.clear();
     mNumSources = 0;
 
-    count = 0;
-    EffectSlotProps *eprops{mFreeEffectslotProps.exchange(nullptr, std::memory_order_acquire)};
-    while(eprops)
-    {
-        std::unique_ptr<EffectSlotProps> old{eprops};
-        eprops = old->next.load(std::memory_order_relaxed);
-        ++count;
-    }
-    TRACE("Freed %zu AuxiliaryEffectSlot property object%s\n", count, (count==1)?"":"s");
-
     if(EffectSlotArray *curarray{mActiveAuxSlots.exchange(nullptr, std::memory_order_relaxed)})
     {
         al::destroy_n(curarray->end(), curarray->size());
@@ -2394,33 +2454,18 @@ ALCcontext::~ALCcontext()
     mEffectSlotList.clear();
     mNumEffectSlots = 0;
 
-    count = 0;
-    VoicePropsItem *vprops{mFreeVoiceProps.exchange(nullptr, std::memory_order_acquire)};
-    while(vprops)
-    {
-        std::unique_ptr<VoicePropsItem> old{vprops};
-        vprops = old->next.load(std::memory_order_relaxed);
-        ++count;
-    }
-    TRACE("Freed %zu voice property object%s\n", count, (count==1)?"":"s");
-
     delete mVoices.exchange(nullptr, std::memory_order_relaxed);
 
-    count = 0;
-    ListenerProps *lprops{mParams.ListenerUpdate.exchange(nullptr, std::memory_order_relaxed)};
-    if(lprops)
+    /* The property containers are freed with their pools. */
+    auto trace_pool = [](const char *name, auto &pool)
     {
-        ++count;
-        delete lprops;
-    }
-    lprops = mFreeListenerProps.exchange(nullptr, std::memory_order_acquire);
-    while(lprops)
-    {
-        std::unique_ptr<ListenerProps> old{lprops};
-        lprops = old->next.load(std::memory_order_relaxed);
-        ++count;
-    }
-    TRACE("Freed %zu listener property object%s\n", count, (count==1)?"":"s");
+        TRACE("Freeing %zu %s property object%s (%zu used at most)\n", pool.getTotal(), name,
+            (pool.getTotal()==1)?"":"s", pool.getHighWater());
+    };
+    trace_pool("context", mContextPropsPool);
+    trace_pool("listener", mListenerPropsPool);
+    trace_pool("voice", mVoicePropsPool);
+    trace_pool("AuxiliaryEffectSlot", mEffectSlotPropsPool);
 
     if(mAsyncEvents)
     {
@@ -2472,14 +2517,28 @@ void ALCcontext::init()
     mExtensionList = alExtList;
 
 
-    mParams.Matrix = alu::Matrix::Identity();
-    mParams.Velocity = alu::Vector{};
-    mParams.Gain = mListener.Gain;
-    mParams.MetersPerUnit = mListener.mMetersPerUnit;
-    mParams.DopplerFactor = mDopplerFactor;
-    mParams.SpeedOfSound = mSpeedOfSound * mDopplerVelocity;
-    mParams.SourceDistanceModel = mSourceDistanceModel;
-    mParams.mDistanceModel = mDistanceModel;
+    auto init_params = [this](ContextParams &params) -> void
+    {
+        params.Matrix = alu::Matrix::Identity();
+        params.Velocity = alu::Vector{};
+        params.Gain = mListener.Gain;
+        params.MetersPerUnit = mListener.mMetersPerUnit;
+        params.DopplerFactor = mDopplerFactor;
+        params.SpeedOfSound = mSpeedOfSound * mDopplerVelocity;
+        params.SourceDistanceModel = mSourceDistanceModel;
+        params.mDistanceModel = mDistanceModel;
+    };
+    init_params(mParams);
+    init_params(mSentParams);
+    mMixParams = VoiceMixParams::Create(MaxAmbiChannels);
+
+    /* Each pool starts with one cluster, so the first updates don't need to
+     * allocate.
+     */
+    mContextPropsPool.reserve(2);
+    mListenerPropsPool.reserve(2);
+    mVoicePropsPool.reserve(16);
+    mEffectSlotPropsPool.reserve(4);
 
 
     mAsyncEvents = RingBuffer::Create(511, sizeof(AsyncEvent), false);
@@ -3065,6 +3124,16 @@ START_API_FUNC
 }
 END_API_FUNC
 
+/* Writes the 50th, 90th, 99th, and 99.9th percentile times from the given
+ * histogram.
+ */
+static void GetHistogramPercentiles(const TimeHistogram &histogram, ALCint64SOFT *values)
+{
+    static constexpr double fractions[]{0.5, 0.9, 0.99, 0.999};
+    for(const double frac : fractions)
+        *(values++) = static_cast<ALCint64SOFT>(histogram.getPercentile(frac));
+}
+
 ALC_API void ALC_APIENTRY alcGetInteger64vSOFT(ALCdevice *device, ALCenum pname, ALCsizei size, ALCint64SOFT *values)
 START_API_FUNC
 {
@@ -3157,18 +3226,7 @@ START_API_FUNC
         break;
 
     case ALC_DEVICE_CLOCK_SOFT:
-        {
-            std::lock_guard<std::mutex> _{dev->StateLock};
-            uint samplecount, refcount;
-            nanoseconds basecount;
-            do {
-                refcount = dev->waitForMix();
-                basecount = dev->ClockBase;
-                samplecount = dev->SamplesDone;
-            } while(refcount != ReadRef(dev->MixCount));
-            basecount += nanoseconds{seconds{samplecount}} / dev->Frequency;
-            *values = basecount.count();
-        }
+        *values = dev->getClockTime().count();
         break;
 
     case ALC_DEVICE_LATENCY_SOFT:
@@ -3191,6 +3249,68 @@ START_API_FUNC
         }
         break;
 
+    /* The mixer stats don't need the device lock, as they're only reset when
+     * the mixer is stopped and the individual values don't need to be in
+     * sync.
+     */
+    case ALC_MIXER_PERIODS_SOFTX:
+        *values = static_cast<ALCint64SOFT>(dev->mMixStats.mPeriods.load());
+        break;
+
+    case ALC_MIXER_TOTAL_TIME_SOFTX:
+        *values = static_cast<ALCint64SOFT>(dev->mMixStats.mTotalTime.load());
+        break;
+
+    case ALC_MIXER_STAGE_TIMES_SOFTX:
+        if(size < static_cast<ALCsizei>(MixerStats::StageCount))
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else
+        {
+            for(size_t i{0};i < MixerStats::StageCount;++i)
+                values[i] = static_cast<ALCint64SOFT>(dev->mMixStats.mStageTimes[i].load());
+        }
+        break;
+
+    case ALC_MIXER_MAX_PERIOD_TIME_SOFTX:
+        *values = static_cast<ALCint64SOFT>(dev->mMixStats.mPeriodTimes.getMax());
+        break;
+
+    case ALC_MIXER_PERIOD_PERCENTILES_SOFTX:
+        if(size < 4)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else
+            GetHistogramPercentiles(dev->mMixStats.mPeriodTimes, values);
+        break;
+
+    case ALC_MIXER_DEADLINE_MISSES_SOFTX:
+        *values = static_cast<ALCint64SOFT>(dev->mMixStats.mDeadlineMisses.load());
+        break;
+
+    case ALC_MIXER_ACTIVE_VOICES_SOFTX:
+        *values = dev->mMixStats.mActiveVoices.load();
+        break;
+
+    case ALC_MIXER_IDLE_VOICES_SOFTX:
+        *values = dev->mMixStats.mIdleVoices.load();
+        break;
+
+    case ALC_BACKEND_XRUNS_SOFTX:
+        *values = static_cast<ALCint64SOFT>(dev->Backend->mStats.mXRuns.load());
+        break;
+
+    case ALC_BACKEND_CALLBACK_JITTER_SOFTX:
+    case ALC_BACKEND_WAKEUP_LATENCY_SOFTX:
+        if(size < 5)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else
+        {
+            const TimeHistogram &histogram = (pname == ALC_BACKEND_CALLBACK_JITTER_SOFTX) ?
+                dev->Backend->mStats.mCallbackJitter : dev->Backend->mStats.mWakeupLatency;
+            GetHistogramPercentiles(histogram, values);
+            values[4] = static_cast<ALCint64SOFT>(histogram.getMax());
+        }
+        break;
+
     default:
         auto ivals = al::vector<int>(static_cast<uint>(size));
         size_t got{GetIntegerv(dev.get(), pname, ivals)};
@@ -3315,6 +3435,48 @@ START_API_FUNC
             TRACE("volume-adjust gain: %f\n", context->mGainBoost);
         }
     }
+    context->mAsyncSourceParams = GetConfigValueBool(dev->DeviceName.c_str(), nullptr,
+        "async-source-params", false);
+    if(attrList)
+    {
+        for(size_t attrIdx{0};attrList[attrIdx];attrIdx += 2)
+        {
+            if(attrList[attrIdx] == ALC_SOURCE_PROPERTY_POOL_SIZE_SOFTX)
+            {
+                /* Enough source property containers for the given number of
+                 * sources to have an update pending, plus one more being set.
+                 */
+                const int count{attrList[attrIdx + 1]};
+                if(count > 0)
+                    context->mVoicePropsPool.reserve(static_cast<uint>(count) + 1u);
+            }
+            else if(attrList[attrIdx] == ALC_EFFECTSLOT_PROPERTY_POOL_SIZE_SOFTX)
+            {
+                /* Likewise for effect slots. The listener and context only
+                 * ever have one update pending, plus one being set, which
+                 * their pools start with.
+                 */
+                const int count{attrList[attrIdx + 1]};
+                if(count > 0)
+                    context->mEffectSlotPropsPool.reserve(static_cast<uint>(count) + 1u);
+            }
+            else if(attrList[attrIdx] == ALC_RESERVED_VOICES_SOFTX)
+            {
+                /* Enough voices and voice changes for the given number of
+                 * sources to start at once without allocating more.
+                 */
+                const int count{attrList[attrIdx + 1]};
+                if(count > 0)
+                {
+                    const size_t numvoices{static_cast<uint>(count)};
+                    const size_t curvoices{context->mVoices.load()->size()};
+                    if(numvoices > curvoices)
+                        context->allocVoices(numvoices - curvoices);
+                    context->allocVoiceChanges(numvoices);
+                }
+            }
+        }
+    }
     UpdateListenerProps(context.get());
 
     {
@@ -3632,6 +3794,9 @@ START_API_FUNC
         device->NumAuxSends = minu(DEFAULT_SENDS,
             static_cast<uint>(clampi(*sendsopt, 0, MAX_SENDS)));
 
+    if(auto logopt = ConfigValueUInt(deviceName, nullptr, "stats-log-interval"))
+        device->Backend->mStatsLogInterval = std::chrono::seconds{*logopt};
+
     device->NumStereoSources = 1;
     device->NumMonoSources = device->SourcesMax - device->NumStereoSources;
 
@@ -4129,7 +4294,7 @@ START_API_FUNC
             /* Clear any pending voice changes and reallocate voices to get a
              * clean restart.
              */
-            std::lock_guard<std::mutex> __{ctx->mSourceLock};
+            std::lock_guard<ShardedSharedMutex> __{ctx->mSourceLock};
             auto *vchg = ctx->mCurrentVoiceChange.load(std::memory_order_acquire);
             while(auto *next = vchg->mNext.load(std::memory_order_acquire))
                 vchg = next;
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -25,11 +26,13 @@
 #include "core/ambidefs.h"
 #include "core/bufferline.h"
 #include "core/devformat.h"
+#include "core/filters/biquad.h"
 #include "core/filters/splitter.h"
 #include "core/mixer/defs.h"
 #include "hrtf.h"
 #include "inprogext.h"
 #include "intrusive_ptr.h"
+#include "mixstats.h"
 #include "vector.h"
 
 class BFormatDec;
@@ -223,10 +226,11 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice> {
     /* Temp storage used for mixer processing. */
     alignas(16) float SourceData[BufferLineSize + MaxResamplerPadding];
     alignas(16) float ResampledData[BufferLineSize];
-    alignas(16) float FilteredData[BufferLineSize];
+    alignas(16) FloatBufferLine FilteredData[BiquadBank<2,8>::NumLanes];
+    alignas(16) FloatBufferLine GroupResampledData[BandSplitterBank::NumLanes];
     union {
         alignas(16) float HrtfSourceData[BufferLineSize + HrtfHistoryLength];
-        alignas(16) float NfcSampleData[BufferLineSize];
+        alignas(16) FloatBufferLine NfcSampleData[MaxAmbiOrder];
     };
 
     /* Persistent storage for HRTF mixing. */
@@ -277,6 +281,16 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice> {
      */
     RefCount MixCount{0u};
 
+    /* The clock time at the end of the last mix, which can be read without
+     * waiting for the mixer, and the clock time at the end of the mix in
+     * progress (only used by the mixer).
+     */
+    std::atomic<std::chrono::nanoseconds::rep> mClockTime{0};
+    std::chrono::nanoseconds mMixEndTime{0};
+
+    /* Timing statistics for the mixer, reset with the device. */
+    MixerStats mMixStats;
+
     // Contexts created on this device
     std::atomic<al::FlexArray<ALCcontext*>*> mContexts{nullptr};
 
@@ -300,8 +314,8 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice> {
 
     std::atomic<ALCenum> LastError{ALC_NO_ERROR};
 
-    // Map of Buffers for this device
-    std::mutex BufferLock;
+    // Map of Buffers for this device. Buffer queries only take a shared lock.
+    std::shared_timed_mutex BufferLock;
     al::vector<BufferSubList> BufferList;
 
     // Map of Effects for this device
@@ -322,6 +336,9 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice> {
     uint channelsFromFmt() const noexcept { return ChannelsFromDevFmt(FmtChans, mAmbiOrder); }
     uint frameSizeFromFmt() const noexcept { return bytesFromFmt() * channelsFromFmt(); }
 
+    std::chrono::nanoseconds getClockTime() const noexcept
+    { return std::chrono::nanoseconds{mClockTime.load(std::memory_order_acquire)}; }
+
     uint waitForMix() const noexcept
     {
         uint refcount;
@@ -353,6 +370,8 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice> {
 
 #define RECORD_THREAD_NAME "alsoft-record"
 
+#define EVENT_THREAD_NAME "alsoft-event"
+
 
 extern int RTPrioLevel;
 void SetRTPriority(void);
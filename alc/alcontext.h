@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
 
@@ -20,6 +21,8 @@
 #include "atomic.h"
 #include "inprogext.h"
 #include "intrusive_ptr.h"
+#include "proppool.h"
+#include "shardedmutex.h"
 #include "threads.h"
 #include "vecmat.h"
 #include "vector.h"
@@ -31,6 +34,7 @@ struct EffectSlotProps;
 struct RingBuffer;
 struct Voice;
 struct VoiceChange;
+struct VoiceMixParams;
 struct VoicePropsItem;
 
 
@@ -62,6 +66,9 @@ struct ContextProps {
     bool SourceDistanceModel;
     DistanceModel mDistanceModel;
 
+    /* Identifies this update, for source parameters calculated with it. */
+    uint Stamp;
+
     std::atomic<ContextProps*> next;
 
     DEF_NEWDEL(ContextProps)
@@ -75,6 +82,13 @@ struct ListenerProps {
     float Gain;
     float MetersPerUnit;
 
+    /* Identifies this update, for source parameters calculated with it. The
+     * pose stamp only changes when the listener's position, orientation, or
+     * velocity does.
+     */
+    uint Stamp;
+    uint PoseStamp;
+
     std::atomic<ListenerProps*> next;
 
     DEF_NEWDEL(ListenerProps)
@@ -96,6 +110,11 @@ struct ContextParams {
 
     bool SourceDistanceModel{false};
     DistanceModel mDistanceModel{};
+
+    /* The stamps of the context and listener updates these were set from. */
+    uint ContextStamp{0u};
+    uint ListenerStamp{0u};
+    uint ListenerPoseStamp{0u};
 };
 
 
@@ -141,13 +160,11 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext> {
 
     float mGainBoost{1.0f};
 
-    /* Linked lists of unused property containers, free to use for future
-     * updates.
-     */
-    std::atomic<ContextProps*> mFreeContextProps{nullptr};
-    std::atomic<ListenerProps*> mFreeListenerProps{nullptr};
-    std::atomic<VoicePropsItem*> mFreeVoiceProps{nullptr};
-    std::atomic<EffectSlotProps*> mFreeEffectslotProps{nullptr};
+    /* Pools of property containers, free to use for future updates. */
+    PropsPool<ContextProps,2> mContextPropsPool;
+    PropsPool<ListenerProps,2> mListenerPropsPool;
+    PropsPool<VoicePropsItem,16> mVoicePropsPool;
+    PropsPool<EffectSlotProps,4> mEffectSlotPropsPool;
 
     /* The voice change tail is the beginning of the "free" elements, up to and
      * *excluding* the current. If tail==current, there's no free elements and
@@ -162,11 +179,44 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext> {
 
     ContextParams mParams;
 
+    /* Scratch space for the mixer to calculate voice parameters in. */
+    std::unique_ptr<VoiceMixParams> mMixParams;
+
+    /* The context and listener parameters as last sent to the mixer, for
+     * calculating source parameters outside of it. Guarded by mPropLock.
+     */
+    ContextParams mSentParams;
+
+    /* Calculate source parameters when their properties are committed,
+     * instead of in the mixer.
+     */
+    bool mAsyncSourceParams{false};
+
+    /* Set while a batch of source properties is being set, so the voices are
+     * only updated once afterward. Guarded by mSourceLock.
+     */
+    bool mBatchSourceUpdates{false};
+
     using VoiceArray = al::FlexArray<Voice*>;
     std::atomic<VoiceArray*> mVoices{};
     std::atomic<size_t> mActiveVoiceCount{};
 
+    /* Voice arrays replaced while the mixer may have still been using them,
+     * along with the device's mix count when they were. Guarded by
+     * mSourceLock.
+     */
+    struct RetiredVoiceArray {
+        std::unique_ptr<VoiceArray> mArray;
+        uint mMixCount;
+    };
+    al::vector<RetiredVoiceArray> mRetiredVoices;
+
     void allocVoices(size_t addcount);
+    /**
+     * Deletes retired voice arrays the mixer has finished with. This doesn't
+     * wait on the mixer, so arrays still in use are kept for a later call.
+     */
+    void freeRetiredVoices();
     al::span<Voice*> getVoicesSpan() const noexcept
     {
         return {mVoices.load(std::memory_order_relaxed)->data(),
@@ -187,6 +237,25 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext> {
     std::unique_ptr<RingBuffer> mAsyncEvents;
     std::atomic<uint> mEnabledEvts{0u};
 
+    /* Whether the event callback is given a message for each event. */
+    std::atomic<bool> mEventMessages{true};
+
+    /* When event queueing is enabled, the mixer writes records of the enabled
+     * events for the app to read with alReadEventsSOFT, instead of sending
+     * them to the event thread. mEventFd is an eventfd that's signaled when
+     * there are records to read (or -1 if unsupported), and
+     * mEventRecordsSignaled avoids signaling it again until they're read.
+     */
+    std::atomic<bool> mEventQueueing{false};
+    std::unique_ptr<RingBuffer> mEventRecords;
+    std::mutex mEventRecordLock;
+    std::atomic<bool> mEventRecordsSignaled{false};
+    int mEventFd{-1};
+
+    /** Adds an event record for the app to read. Called by the mixer. */
+    void queueEventRecord(ALenum type, ALuint object, ALuint param) noexcept;
+    void signalEventRecords() noexcept;
+
     /* Asynchronous voice change actions are processed as a linked list of
      * VoiceChange objects by the mixer, which is atomically appended to.
      * However, to avoid allocating each object individually, they're allocated
@@ -205,7 +274,14 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext> {
     std::atomic_flag mPropsClean;
     std::atomic<bool> mDeferUpdates{false};
 
-    std::mutex mPropLock;
+    /* The context property, source, and effect slot locks are sharded
+     * reader/writer locks. Queries only take one shard shared, so threads
+     * getting properties don't serialize on or write to the same lock, while
+     * anything modifying state takes them exclusively. The source lock is
+     * sharded by source ID; setting one source's properties only needs its
+     * shard, with the property lock shared.
+     */
+    ShardedSharedMutex mPropLock;
 
     std::atomic<ALenum> mLastError{AL_NO_ERROR};
 
@@ -224,11 +300,11 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext> {
 
     al::vector<SourceSubList> mSourceList;
     ALuint mNumSources{0};
-    std::mutex mSourceLock;
+    ShardedSharedMutex mSourceLock;
 
     al::vector<EffectSlotSubList> mEffectSlotList;
     ALuint mNumEffectSlots{0u};
-    std::mutex mEffectSlotLock;
+    ShardedSharedMutex mEffectSlotLock;
 
     /* Default effect slot */
     std::unique_ptr<ALeffectslot> mDefaultSlot;
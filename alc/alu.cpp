@@ -64,6 +64,7 @@
 #include "core/fpu_ctrl.h"
 #include "core/mastering.h"
 #include "core/mixer/defs.h"
+#include "core/trace.h"
 #include "core/uhjfilter.h"
 #include "effects/base.h"
 #include "effectslot.h"
@@ -332,6 +333,52 @@ void ALCdevice::ProcessBs2b(const size_t SamplesToDo)
 }
 
 
+void SetContextParams(ContextParams &params, const ContextProps &props)
+{
+    params.DopplerFactor = props.DopplerFactor;
+    params.SpeedOfSound = props.SpeedOfSound * props.DopplerVelocity;
+
+    params.SourceDistanceModel = props.SourceDistanceModel;
+    params.mDistanceModel = props.mDistanceModel;
+
+    params.ContextStamp = props.Stamp;
+}
+
+void SetListenerParams(ContextParams &params, const ListenerProps &props, const float gainboost)
+{
+    /* AT then UP */
+    alu::Vector N{props.OrientAt[0], props.OrientAt[1], props.OrientAt[2], 0.0f};
+    N.normalize();
+    alu::Vector V{props.OrientUp[0], props.OrientUp[1], props.OrientUp[2], 0.0f};
+    V.normalize();
+    /* Build and normalize right-vector */
+    alu::Vector U{N.cross_product(V)};
+    U.normalize();
+
+    const alu::MatrixR<double> rot{
+        U[0], V[0], -N[0], 0.0,
+        U[1], V[1], -N[1], 0.0,
+        U[2], V[2], -N[2], 0.0,
+         0.0,  0.0,   0.0, 1.0};
+    const alu::VectorR<double> pos{props.Position[0],props.Position[1],props.Position[2],1.0};
+    const alu::VectorR<double> vel{props.Velocity[0],props.Velocity[1],props.Velocity[2],0.0};
+    const alu::Vector P{alu::cast_to<float>(rot * pos)};
+
+    params.Matrix = alu::Matrix{
+         U[0],  V[0], -N[0], 0.0f,
+         U[1],  V[1], -N[1], 0.0f,
+         U[2],  V[2], -N[2], 0.0f,
+        -P[0], -P[1], -P[2], 1.0f};
+    params.Velocity = alu::cast_to<float>(rot * vel);
+
+    params.Gain = props.Gain * gainboost;
+    params.MetersPerUnit = props.MetersPerUnit;
+
+    params.ListenerStamp = props.Stamp;
+    params.ListenerPoseStamp = props.PoseStamp;
+}
+
+
 namespace {
 
 /* This RNG method was created based on the math found in opusdec. It's quick,
@@ -370,52 +417,29 @@ bool CalcContextParams(ALCcontext *ctx)
     ContextProps *props{ctx->mParams.ContextUpdate.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props) return false;
 
-    ctx->mParams.DopplerFactor = props->DopplerFactor;
-    ctx->mParams.SpeedOfSound = props->SpeedOfSound * props->DopplerVelocity;
+    SetContextParams(ctx->mParams, *props);
 
-    ctx->mParams.SourceDistanceModel = props->SourceDistanceModel;
-    ctx->mParams.mDistanceModel = props->mDistanceModel;
-
-    AtomicReplaceHead(ctx->mFreeContextProps, props);
+    ctx->mContextPropsPool.put(props);
     return true;
 }
 
-bool CalcListenerParams(ALCcontext *ctx)
+/* Applies any pending listener update. Returns true if every voice needs
+ * recalculating, and sets posechanged if the voices depending on the
+ * listener's pose do.
+ */
+bool CalcListenerParams(ALCcontext *ctx, bool &posechanged)
 {
     ListenerProps *props{ctx->mParams.ListenerUpdate.exchange(nullptr,
         std::memory_order_acq_rel)};
     if(!props) return false;
 
-    /* AT then UP */
-    alu::Vector N{props->OrientAt[0], props->OrientAt[1], props->OrientAt[2], 0.0f};
-    N.normalize();
-    alu::Vector V{props->OrientUp[0], props->OrientUp[1], props->OrientUp[2], 0.0f};
-    V.normalize();
-    /* Build and normalize right-vector */
-    alu::Vector U{N.cross_product(V)};
-    U.normalize();
-
-    const alu::MatrixR<double> rot{
-        U[0], V[0], -N[0], 0.0,
-        U[1], V[1], -N[1], 0.0,
-        U[2], V[2], -N[2], 0.0,
-         0.0,  0.0,   0.0, 1.0};
-    const alu::VectorR<double> pos{props->Position[0],props->Position[1],props->Position[2],1.0};
-    const alu::VectorR<double> vel{props->Velocity[0],props->Velocity[1],props->Velocity[2],0.0};
-    const alu::Vector P{alu::cast_to<float>(rot * pos)};
+    const uint oldstamp{ctx->mParams.ListenerStamp};
+    const uint oldposestamp{ctx->mParams.ListenerPoseStamp};
+    SetListenerParams(ctx->mParams, *props, ctx->mGainBoost);
 
-    ctx->mParams.Matrix = alu::Matrix{
-         U[0],  V[0], -N[0], 0.0f,
-         U[1],  V[1], -N[1], 0.0f,
-         U[2],  V[2], -N[2], 0.0f,
-        -P[0], -P[1], -P[2], 1.0f};
-    ctx->mParams.Velocity = alu::cast_to<float>(rot * vel);
-
-    ctx->mParams.Gain = props->Gain * ctx->mGainBoost;
-    ctx->mParams.MetersPerUnit = props->MetersPerUnit;
-
-    AtomicReplaceHead(ctx->mFreeListenerProps, props);
-    return true;
+    ctx->mListenerPropsPool.put(props);
+    posechanged = ctx->mParams.ListenerPoseStamp != oldposestamp;
+    return ctx->mParams.ListenerStamp != oldstamp;
 }
 
 bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ALCcontext *context)
@@ -429,28 +453,9 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ALCcontex
     if(slot->Target != props->Target)
         *sorted_slots = nullptr;
     slot->Gain = props->Gain;
-    slot->AuxSendAuto = props->AuxSendAuto;
     slot->Target = props->Target;
-    slot->EffectType = props->Type;
     slot->mEffectProps = props->Props;
-    if(props->Type == EffectSlotType::Reverb || props->Type == EffectSlotType::EAXReverb)
-    {
-        slot->RoomRolloff = props->Props.Reverb.RoomRolloffFactor;
-        slot->DecayTime = props->Props.Reverb.DecayTime;
-        slot->DecayLFRatio = props->Props.Reverb.DecayLFRatio;
-        slot->DecayHFRatio = props->Props.Reverb.DecayHFRatio;
-        slot->DecayHFLimit = props->Props.Reverb.DecayHFLimit;
-        slot->AirAbsorptionGainHF = props->Props.Reverb.AirAbsorptionGainHF;
-    }
-    else
-    {
-        slot->RoomRolloff = 0.0f;
-        slot->DecayTime = 0.0f;
-        slot->DecayLFRatio = 0.0f;
-        slot->DecayHFRatio = 0.0f;
-        slot->DecayHFLimit = false;
-        slot->AirAbsorptionGainHF = 1.0f;
-    }
+    slot->mSourceParams.set(*props);
 
     EffectState *state{props->State.release()};
     EffectState *oldstate{slot->mEffectState};
@@ -481,7 +486,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ALCcontex
         }
     }
 
-    AtomicReplaceHead(context->mFreeEffectslotProps, props);
+    context->mEffectSlotPropsPool.put(props);
 
     EffectTarget output;
     if(EffectSlot *target{slot->Target})
@@ -675,7 +680,8 @@ void AmbiRotator(std::array<std::array<float,MaxAmbiChannels>,MaxAmbiChannels> &
 
 struct GainTriplet { float Base, HF, LF; };
 
-void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, const float zpos,
+void CalcPanningAndFilters(VoiceMixParams &params, const Voice *voice, const float xpos,
+    const float ypos, const float zpos,
     const float Distance, const float Spread, const GainTriplet &DryGain,
     const al::span<const GainTriplet,MAX_SENDS> WetGain, EffectSlot *(&SendSlots)[MAX_SENDS],
     const VoiceProps *props, const ContextParams &Context, const ALCdevice *Device)
@@ -727,12 +733,13 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
     const size_t num_channels{voice->mChans.size()};
     ASSUME(num_channels > 0);
 
-    for(auto &chandata : voice->mChans)
+    for(size_t c{0};c < num_channels;c++)
     {
-        chandata.mDryParams.Hrtf.Target = HrtfFilter{};
-        chandata.mDryParams.Gains.Target.fill(0.0f);
-        std::for_each(chandata.mWetParams.begin(), chandata.mWetParams.begin()+NumSends,
-            [](SendParams &params) -> void { params.Gains.Target.fill(0.0f); });
+        auto &chanparams = params.mChans[c];
+        chanparams.HrtfTarget = HrtfFilter{};
+        chanparams.DryGains.fill(0.0f);
+        std::for_each(chanparams.WetGains.begin(), chanparams.WetGains.begin()+NumSends,
+            [](std::array<float,MAX_OUTPUT_CHANNELS> &gains) -> void { gains.fill(0.0f); });
     }
 
     DirectMode DirectChannels{props->DirectChannels};
@@ -790,12 +797,15 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
 
     case FmtBFormat2D:
     case FmtBFormat3D:
+    case FmtUHJ2:
         DirectChannels = DirectMode::Off;
         break;
     }
 
-    voice->mFlags &= ~(VoiceHasHrtf | VoiceHasNfc);
-    if(voice->mFmtChannels == FmtBFormat2D || voice->mFmtChannels == FmtBFormat3D)
+    params.mFlags = 0;
+    params.mNfcW0 = 0.0f;
+    params.mNfcChannels = 0;
+    if(IsAmbisonic(voice->mFmtChannels))
     {
         /* Special handling for B-Format sources. */
 
@@ -807,7 +817,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                  * is what we want for FOA input. The first channel may have
                  * been previously re-adjusted if panned, so reset it.
                  */
-                voice->mChans[0].mDryParams.NFCtrlFilter.adjust(0.0f);
+                params.mNfcW0 = 0.0f;
             }
             else
             {
@@ -817,11 +827,12 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 const float mdist{maxf(Distance, Device->AvgSpeakerDist/4.0f)};
                 const float w0{SpeedOfSoundMetersPerSec / (mdist * Frequency)};
 
-                /* Only need to adjust the first channel of a B-Format source. */
-                voice->mChans[0].mDryParams.NFCtrlFilter.adjust(w0);
+                params.mNfcW0 = w0;
             }
 
-            voice->mFlags |= VoiceHasNfc;
+            /* Only need to adjust the first channel of a B-Format source. */
+            params.mNfcChannels = 1;
+            params.mFlags |= VoiceHasNfc;
         }
 
         /* Panning a B-Format sound toward some direction is easy. Just pan the
@@ -857,12 +868,12 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         /* NOTE: W needs to be scaled according to channel scaling. */
         auto&& scales = GetAmbiScales(voice->mAmbiScaling);
         ComputePanGains(&Device->Dry, coeffs.data(), DryGain.Base*scales[0],
-            voice->mChans[0].mDryParams.Gains.Target);
+            params.mChans[0].DryGains);
         for(uint i{0};i < NumSends;i++)
         {
             if(const EffectSlot *Slot{SendSlots[i]})
                 ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base*scales[0],
-                    voice->mChans[0].mWetParams[i].Gains.Target);
+                    params.mChans[0].WetGains[i]);
         }
 
         if(coverage > 0.0f)
@@ -898,7 +909,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
             /* Convert the rotation matrix for input ordering and scaling, and
              * whether input is 2D or 3D.
              */
-            const uint8_t *index_map{(voice->mFmtChannels == FmtBFormat2D) ?
+            const uint8_t *index_map{Is2DAmbisonic(voice->mFmtChannels) ?
                 GetAmbi2DLayout(voice->mAmbiLayout).data() :
                 GetAmbiLayout(voice->mAmbiLayout).data()};
 
@@ -918,13 +929,13 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     coeffs[offset+x] = in[x][acn] * scale;
 
                 ComputePanGains(&Device->Dry, coeffs.data(), DryGain.Base,
-                    voice->mChans[c].mDryParams.Gains.Target);
+                    params.mChans[c].DryGains);
 
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
                         ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base,
-                            voice->mChans[c].mWetParams[i].Gains.Target);
+                            params.mChans[c].WetGains[i]);
                 }
             }
         }
@@ -934,13 +945,13 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         /* Direct source channels always play local. Skip the virtual channels
          * and write inputs to the matching real outputs.
          */
-        voice->mDirect.Buffer = Device->RealOut.Buffer;
+        params.mDirect.Buffer = Device->RealOut.Buffer;
 
         for(size_t c{0};c < num_channels;c++)
         {
             uint idx{GetChannelIdxByName(Device->RealOut, chans[c].channel)};
             if(idx != INVALID_CHANNEL_INDEX)
-                voice->mChans[c].mDryParams.Gains.Target[idx] = DryGain.Base;
+                params.mChans[c].DryGains[idx] = DryGain.Base;
             else if(DirectChannels == DirectMode::RemixMismatch)
             {
                 auto match_channel = [chans,c](const InputRemixMap &map) noexcept -> bool
@@ -952,7 +963,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     {
                         idx = GetChannelIdxByName(Device->RealOut, target.channel);
                         if(idx != INVALID_CHANNEL_INDEX)
-                            voice->mChans[c].mDryParams.Gains.Target[idx] = DryGain.Base *
+                            params.mChans[c].DryGains[idx] = DryGain.Base *
                                 target.mix;
                     }
             }
@@ -969,7 +980,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
             {
                 if(const EffectSlot *Slot{SendSlots[i]})
                     ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base,
-                        voice->mChans[c].mWetParams[i].Gains.Target);
+                        params.mChans[c].WetGains[i]);
             }
         }
     }
@@ -978,7 +989,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         /* Full HRTF rendering. Skip the virtual channels and render to the
          * real outputs.
          */
-        voice->mDirect.Buffer = Device->RealOut.Buffer;
+        params.mDirect.Buffer = Device->RealOut.Buffer;
 
         if(Distance > std::numeric_limits<float>::epsilon())
         {
@@ -989,16 +1000,16 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
              * source direction.
              */
             GetHrtfCoeffs(Device->mHrtf.get(), ev, az, Distance, Spread,
-                voice->mChans[0].mDryParams.Hrtf.Target.Coeffs,
-                voice->mChans[0].mDryParams.Hrtf.Target.Delay);
-            voice->mChans[0].mDryParams.Hrtf.Target.Gain = DryGain.Base * downmix_gain;
+                params.mChans[0].HrtfTarget.Coeffs,
+                params.mChans[0].HrtfTarget.Delay);
+            params.mChans[0].HrtfTarget.Gain = DryGain.Base * downmix_gain;
 
             /* Remaining channels use the same results as the first. */
             for(size_t c{1};c < num_channels;c++)
             {
                 /* Skip LFE */
                 if(chans[c].channel == LFE) continue;
-                voice->mChans[c].mDryParams.Hrtf.Target = voice->mChans[0].mDryParams.Hrtf.Target;
+                params.mChans[c].HrtfTarget = params.mChans[0].HrtfTarget;
             }
 
             /* Calculate the directional coefficients once, which apply to all
@@ -1015,7 +1026,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
                         ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base * downmix_gain,
-                            voice->mChans[c].mWetParams[i].Gains.Target);
+                            params.mChans[c].WetGains[i]);
                 }
             }
         }
@@ -1036,9 +1047,9 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                  */
                 GetHrtfCoeffs(Device->mHrtf.get(), chans[c].elevation, chans[c].angle,
                     std::numeric_limits<float>::infinity(), Spread,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Coeffs,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Delay);
-                voice->mChans[c].mDryParams.Hrtf.Target.Gain = DryGain.Base;
+                    params.mChans[c].HrtfTarget.Coeffs,
+                    params.mChans[c].HrtfTarget.Delay);
+                params.mChans[c].HrtfTarget.Gain = DryGain.Base;
 
                 /* Normal panning for auxiliary sends. */
                 const auto coeffs = CalcAngleCoeffs(chans[c].angle, chans[c].elevation, Spread);
@@ -1047,12 +1058,12 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
                         ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base,
-                            voice->mChans[c].mWetParams[i].Gains.Target);
+                            params.mChans[c].WetGains[i]);
                 }
             }
         }
 
-        voice->mFlags |= VoiceHasHrtf;
+        params.mFlags |= VoiceHasHrtf;
     }
     else
     {
@@ -1070,10 +1081,9 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 const float w0{SpeedOfSoundMetersPerSec / (mdist * Frequency)};
 
                 /* Adjust NFC filters. */
-                for(size_t c{0};c < num_channels;c++)
-                    voice->mChans[c].mDryParams.NFCtrlFilter.adjust(w0);
-
-                voice->mFlags |= VoiceHasNfc;
+                params.mNfcW0 = w0;
+                params.mNfcChannels = static_cast<uint>(num_channels);
+                params.mFlags |= VoiceHasNfc;
             }
 
             /* Calculate the directional coefficients once, which apply to all
@@ -1098,18 +1108,18 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     {
                         const uint idx{GetChannelIdxByName(Device->RealOut, chans[c].channel)};
                         if(idx != INVALID_CHANNEL_INDEX)
-                            voice->mChans[c].mDryParams.Gains.Target[idx] = DryGain.Base;
+                            params.mChans[c].DryGains[idx] = DryGain.Base;
                     }
                     continue;
                 }
 
                 ComputePanGains(&Device->Dry, coeffs.data(), DryGain.Base * downmix_gain,
-                    voice->mChans[c].mDryParams.Gains.Target);
+                    params.mChans[c].DryGains);
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
                         ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base * downmix_gain,
-                            voice->mChans[c].mWetParams[i].Gains.Target);
+                            params.mChans[c].WetGains[i]);
                 }
             }
         }
@@ -1121,10 +1131,9 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                  * infinite distance, which results in a w0 of 0.
                  */
                 constexpr float w0{0.0f};
-                for(size_t c{0};c < num_channels;c++)
-                    voice->mChans[c].mDryParams.NFCtrlFilter.adjust(w0);
-
-                voice->mFlags |= VoiceHasNfc;
+                params.mNfcW0 = w0;
+                params.mNfcChannels = static_cast<uint>(num_channels);
+                params.mFlags |= VoiceHasNfc;
             }
 
             for(size_t c{0};c < num_channels;c++)
@@ -1136,7 +1145,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     {
                         const uint idx{GetChannelIdxByName(Device->RealOut, chans[c].channel)};
                         if(idx != INVALID_CHANNEL_INDEX)
-                            voice->mChans[c].mDryParams.Gains.Target[idx] = DryGain.Base;
+                            params.mChans[c].DryGains[idx] = DryGain.Base;
                     }
                     continue;
                 }
@@ -1146,12 +1155,12 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     chans[c].elevation, Spread);
 
                 ComputePanGains(&Device->Dry, coeffs.data(), DryGain.Base,
-                    voice->mChans[c].mDryParams.Gains.Target);
+                    params.mChans[c].DryGains);
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
                         ComputePanGains(&Slot->Wet, coeffs.data(), WetGain[i].Base,
-                            voice->mChans[c].mWetParams[i].Gains.Target);
+                            params.mChans[c].WetGains[i]);
                 }
             }
         }
@@ -1161,101 +1170,95 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         const float hfNorm{props->Direct.HFReference / Frequency};
         const float lfNorm{props->Direct.LFReference / Frequency};
 
-        voice->mDirect.FilterType = AF_None;
-        if(DryGain.HF != 1.0f) voice->mDirect.FilterType |= AF_LowPass;
-        if(DryGain.LF != 1.0f) voice->mDirect.FilterType |= AF_HighPass;
+        params.mDirect.FilterType = AF_None;
+        if(DryGain.HF != 1.0f) params.mDirect.FilterType |= AF_LowPass;
+        if(DryGain.LF != 1.0f) params.mDirect.FilterType |= AF_HighPass;
 
-        auto &lowpass = voice->mChans[0].mDryParams.LowPass;
-        auto &highpass = voice->mChans[0].mDryParams.HighPass;
-        lowpass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, DryGain.HF, 1.0f);
-        highpass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, DryGain.LF, 1.0f);
-        for(size_t c{1};c < num_channels;c++)
-        {
-            voice->mChans[c].mDryParams.LowPass.copyParamsFrom(lowpass);
-            voice->mChans[c].mDryParams.HighPass.copyParamsFrom(highpass);
-        }
+        params.mDirect.LowPass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, DryGain.HF,
+            1.0f);
+        params.mDirect.HighPass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, DryGain.LF,
+            1.0f);
     }
     for(uint i{0};i < NumSends;i++)
     {
         const float hfNorm{props->Send[i].HFReference / Frequency};
         const float lfNorm{props->Send[i].LFReference / Frequency};
 
-        voice->mSend[i].FilterType = AF_None;
-        if(WetGain[i].HF != 1.0f) voice->mSend[i].FilterType |= AF_LowPass;
-        if(WetGain[i].LF != 1.0f) voice->mSend[i].FilterType |= AF_HighPass;
+        params.mSend[i].FilterType = AF_None;
+        if(WetGain[i].HF != 1.0f) params.mSend[i].FilterType |= AF_LowPass;
+        if(WetGain[i].LF != 1.0f) params.mSend[i].FilterType |= AF_HighPass;
 
-        auto &lowpass = voice->mChans[0].mWetParams[i].LowPass;
-        auto &highpass = voice->mChans[0].mWetParams[i].HighPass;
-        lowpass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, WetGain[i].HF, 1.0f);
-        highpass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, WetGain[i].LF, 1.0f);
-        for(size_t c{1};c < num_channels;c++)
-        {
-            voice->mChans[c].mWetParams[i].LowPass.copyParamsFrom(lowpass);
-            voice->mChans[c].mWetParams[i].HighPass.copyParamsFrom(highpass);
-        }
+        params.mSend[i].LowPass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, WetGain[i].HF,
+            1.0f);
+        params.mSend[i].HighPass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, WetGain[i].LF,
+            1.0f);
     }
 }
 
-void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontext *context)
+void CalcNonAttnSourceParams(VoiceMixParams &params, const Voice *voice,
+    const VoiceProps *props, const ContextParams &Context,
+    const EffectSlotSourceParams *const (&SendParams)[MAX_SENDS], const ALCdevice *Device)
 {
-    const ALCdevice *Device{context->mDevice.get()};
     EffectSlot *SendSlots[MAX_SENDS];
 
-    voice->mDirect.Buffer = Device->Dry.Buffer;
+    params.mDirect.Buffer = Device->Dry.Buffer;
     for(uint i{0};i < Device->NumAuxSends;i++)
     {
         SendSlots[i] = props->Send[i].Slot;
-        if(!SendSlots[i] || SendSlots[i]->EffectType == EffectSlotType::None)
+        if(!SendSlots[i] || SendParams[i]->EffectType == EffectSlotType::None)
         {
             SendSlots[i] = nullptr;
-            voice->mSend[i].Buffer = {};
+            params.mSend[i].Buffer = {};
         }
         else
-            voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            params.mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
     }
 
     /* Calculate the stepping value */
     const auto Pitch = static_cast<float>(voice->mFrequency) /
         static_cast<float>(Device->Frequency) * props->Pitch;
     if(Pitch > float{MaxPitch})
-        voice->mStep = MaxPitch<<MixerFracBits;
+        params.mStep = MaxPitch<<MixerFracBits;
     else
-        voice->mStep = maxu(fastf2u(Pitch * MixerFracOne), 1);
-    voice->mResampler = PrepareResampler(props->mResampler, voice->mStep, &voice->mResampleState);
+        params.mStep = maxu(fastf2u(Pitch * MixerFracOne), 1);
+    params.mResampler = PrepareResampler(props->mResampler, params.mStep,
+        &params.mResampleState);
 
     /* Calculate gains */
     GainTriplet DryGain;
     DryGain.Base  = minf(clampf(props->Gain, props->MinGain, props->MaxGain) * props->Direct.Gain *
-        context->mParams.Gain, GainMixMax);
+        Context.Gain, GainMixMax);
     DryGain.HF = props->Direct.GainHF;
     DryGain.LF = props->Direct.GainLF;
     GainTriplet WetGain[MAX_SENDS];
     for(uint i{0};i < Device->NumAuxSends;i++)
     {
         WetGain[i].Base = minf(clampf(props->Gain, props->MinGain, props->MaxGain) *
-            props->Send[i].Gain * context->mParams.Gain, GainMixMax);
+            props->Send[i].Gain * Context.Gain, GainMixMax);
         WetGain[i].HF = props->Send[i].GainHF;
         WetGain[i].LF = props->Send[i].GainLF;
     }
 
-    CalcPanningAndFilters(voice, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, DryGain, WetGain, SendSlots, props,
-        context->mParams, Device);
+    CalcPanningAndFilters(params, voice, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, DryGain, WetGain, SendSlots,
+        props, Context, Device);
 }
 
-void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontext *context)
+void CalcAttnSourceParams(VoiceMixParams &params, const Voice *voice, const VoiceProps *props,
+    const ContextParams &Context, const EffectSlotSourceParams *const (&SendParams)[MAX_SENDS],
+    const ALCdevice *Device)
 {
-    const ALCdevice *Device{context->mDevice.get()};
     const uint NumSends{Device->NumAuxSends};
 
     /* Set mixing buffers and get send parameters. */
-    voice->mDirect.Buffer = Device->Dry.Buffer;
+    params.mDirect.Buffer = Device->Dry.Buffer;
     EffectSlot *SendSlots[MAX_SENDS];
     float RoomRolloff[MAX_SENDS];
     GainTriplet DecayDistance[MAX_SENDS];
     for(uint i{0};i < NumSends;i++)
     {
         SendSlots[i] = props->Send[i].Slot;
-        if(!SendSlots[i] || SendSlots[i]->EffectType == EffectSlotType::None)
+        const EffectSlotSourceParams *slotparams{SendParams[i]};
+        if(!SendSlots[i] || slotparams->EffectType == EffectSlotType::None)
         {
             SendSlots[i] = nullptr;
             RoomRolloff[i] = 0.0f;
@@ -1263,18 +1266,18 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
             DecayDistance[i].LF = 0.0f;
             DecayDistance[i].HF = 0.0f;
         }
-        else if(SendSlots[i]->AuxSendAuto)
+        else if(slotparams->AuxSendAuto)
         {
-            RoomRolloff[i] = SendSlots[i]->RoomRolloff + props->RoomRolloffFactor;
+            RoomRolloff[i] = slotparams->RoomRolloff + props->RoomRolloffFactor;
             /* Calculate the distances to where this effect's decay reaches
              * -60dB.
              */
-            DecayDistance[i].Base = SendSlots[i]->DecayTime * SpeedOfSoundMetersPerSec;
-            DecayDistance[i].LF = DecayDistance[i].Base * SendSlots[i]->DecayLFRatio;
-            DecayDistance[i].HF = DecayDistance[i].Base * SendSlots[i]->DecayHFRatio;
-            if(SendSlots[i]->DecayHFLimit)
+            DecayDistance[i].Base = slotparams->DecayTime * SpeedOfSoundMetersPerSec;
+            DecayDistance[i].LF = DecayDistance[i].Base * slotparams->DecayLFRatio;
+            DecayDistance[i].HF = DecayDistance[i].Base * slotparams->DecayHFRatio;
+            if(slotparams->DecayHFLimit)
             {
-                const float airAbsorption{SendSlots[i]->AirAbsorptionGainHF};
+                const float airAbsorption{slotparams->AirAbsorptionGainHF};
                 if(airAbsorption < 1.0f)
                 {
                     /* Calculate the distance to where this effect's air
@@ -1299,9 +1302,9 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
         }
 
         if(!SendSlots[i])
-            voice->mSend[i].Buffer = {};
+            params.mSend[i].Buffer = {};
         else
-            voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            params.mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
     }
 
     /* Transform source to listener space (convert to head relative) */
@@ -1311,14 +1314,14 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
     if(!props->HeadRelative)
     {
         /* Transform source vectors */
-        Position = context->mParams.Matrix * Position;
-        Velocity = context->mParams.Matrix * Velocity;
-        Direction = context->mParams.Matrix * Direction;
+        Position = Context.Matrix * Position;
+        Velocity = Context.Matrix * Velocity;
+        Direction = Context.Matrix * Direction;
     }
     else
     {
         /* Offset the source velocity to be relative of the listener velocity */
-        Velocity += context->mParams.Velocity;
+        Velocity += Context.Velocity;
     }
 
     const bool directional{Direction.normalize() > 0.0f};
@@ -1334,8 +1337,7 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
     /* Calculate distance attenuation */
     float ClampedDist{Distance};
 
-    switch(context->mParams.SourceDistanceModel ? props->mDistanceModel
-        : context->mParams.mDistanceModel)
+    switch(Context.SourceDistanceModel ? props->mDistanceModel : Context.mDistanceModel)
     {
         case DistanceModel::InverseClamped:
             ClampedDist = clampf(ClampedDist, props->RefDistance, props->MaxDistance);
@@ -1434,13 +1436,13 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
 
     /* Apply gain and frequency filters */
     DryGain.Base = minf(clampf(DryGain.Base, props->MinGain, props->MaxGain) * props->Direct.Gain *
-        context->mParams.Gain, GainMixMax);
+        Context.Gain, GainMixMax);
     DryGain.HF *= props->Direct.GainHF;
     DryGain.LF *= props->Direct.GainLF;
     for(uint i{0};i < NumSends;i++)
     {
         WetGain[i].Base = minf(clampf(WetGain[i].Base, props->MinGain, props->MaxGain) *
-            props->Send[i].Gain * context->mParams.Gain, GainMixMax);
+            props->Send[i].Gain * Context.Gain, GainMixMax);
         WetGain[i].HF *= props->Send[i].GainHF;
         WetGain[i].LF *= props->Send[i].GainLF;
     }
@@ -1449,7 +1451,7 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
     if(ClampedDist > props->RefDistance && props->RolloffFactor > 0.0f)
     {
         const float meters_base{(ClampedDist-props->RefDistance) * props->RolloffFactor *
-            context->mParams.MetersPerUnit};
+            Context.MetersPerUnit};
         if(props->AirAbsorptionFactor > 0.0f)
         {
             const float hfattn{std::pow(AirAbsorbGainHF, meters_base*props->AirAbsorptionFactor)};
@@ -1490,14 +1492,14 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
     float Pitch{props->Pitch};
 
     /* Calculate velocity-based doppler effect */
-    float DopplerFactor{props->DopplerFactor * context->mParams.DopplerFactor};
+    float DopplerFactor{props->DopplerFactor * Context.DopplerFactor};
     if(DopplerFactor > 0.0f)
     {
-        const alu::Vector &lvelocity = context->mParams.Velocity;
-        float vss{Velocity.dot_product(ToSource) * -DopplerFactor};
-        float vls{lvelocity.dot_product(ToSource) * -DopplerFactor};
+        const alu::Vector &lvelocity = Context.Velocity;
+        const float vss{Velocity.dot_product(ToSource) * -DopplerFactor};
+        const float vls{lvelocity.dot_product(ToSource) * -DopplerFactor};
 
-        const float SpeedOfSound{context->mParams.SpeedOfSound};
+        const float SpeedOfSound{Context.SpeedOfSound};
         if(!(vls < SpeedOfSound))
         {
             /* Listener moving away from the source at the speed of sound.
@@ -1526,10 +1528,11 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
      */
     Pitch *= static_cast<float>(voice->mFrequency) / static_cast<float>(Device->Frequency);
     if(Pitch > float{MaxPitch})
-        voice->mStep = MaxPitch<<MixerFracBits;
+        params.mStep = MaxPitch<<MixerFracBits;
     else
-        voice->mStep = maxu(fastf2u(Pitch * MixerFracOne), 1);
-    voice->mResampler = PrepareResampler(props->mResampler, voice->mStep, &voice->mResampleState);
+        params.mStep = maxu(fastf2u(Pitch * MixerFracOne), 1);
+    params.mResampler = PrepareResampler(props->mResampler, params.mStep,
+        &params.mResampleState);
 
     float spread{0.0f};
     if(props->Radius > Distance)
@@ -1537,35 +1540,182 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ALCcontex
     else if(Distance > 0.0f)
         spread = std::asin(props->Radius/Distance) * 2.0f;
 
-    CalcPanningAndFilters(voice, ToSource[0], ToSource[1], ToSource[2]*ZScale,
-        Distance*context->mParams.MetersPerUnit, spread, DryGain, WetGain, SendSlots, props,
-        context->mParams, Device);
+    CalcPanningAndFilters(params, voice, ToSource[0], ToSource[1], ToSource[2]*ZScale,
+        Distance*Context.MetersPerUnit, spread, DryGain, WetGain, SendSlots, props, Context,
+        Device);
 }
 
-void CalcSourceParams(Voice *voice, ALCcontext *context, bool force)
+bool UsesAttenuation(const Voice *voice, const VoiceProps *props)
 {
-    VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)};
-    if(!props && !force) return;
+    return !((props->DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
+            && !IsAmbisonic(voice->mFmtChannels))
+        || props->mSpatializeMode==SpatializeMode::Off
+        || (props->mSpatializeMode==SpatializeMode::Auto && voice->mFmtChannels != FmtMono));
+}
+
+/* Gets the mixer's source parameters for the effect slot on each send. */
+void GetSendParams(const VoiceProps *props, const uint NumSends,
+    const EffectSlotSourceParams *(&SendParams)[MAX_SENDS])
+{
+    for(uint i{0};i < NumSends;i++)
+    {
+        const EffectSlot *slot{props->Send[i].Slot};
+        SendParams[i] = slot ? &slot->mSourceParams : nullptr;
+    }
+}
+
+/* Applies calculated mixing parameters as the voice's new targets. */
+void ApplyVoiceParams(Voice *voice, const VoiceMixParams &params, const uint NumSends)
+{
+    voice->mStep = params.mStep;
+    voice->mResampler = params.mResampler;
+    voice->mResampleState = params.mResampleState;
+    voice->mFlags = (voice->mFlags&~(VoiceHasHrtf | VoiceHasNfc)) | params.mFlags;
+
+    voice->mDirect.FilterType = params.mDirect.FilterType;
+    voice->mDirect.Buffer = params.mDirect.Buffer;
+    for(uint i{0};i < NumSends;i++)
+    {
+        voice->mSend[i].FilterType = params.mSend[i].FilterType;
+        voice->mSend[i].Buffer = params.mSend[i].Buffer;
+    }
 
-    if(props)
+    const bool hashrtf{(params.mFlags&VoiceHasHrtf) != 0};
+    for(size_t c{0};c < voice->mChans.size();c++)
     {
-        voice->mProps = *props;
+        const VoiceMixParams::ChannelParams &chanparams = params.mChans[c];
+
+        DirectParams &dryparams = voice->mChans[c].mDryParams;
+        dryparams.LowPass.copyParamsFrom(params.mDirect.LowPass);
+        dryparams.HighPass.copyParamsFrom(params.mDirect.HighPass);
+        if(c < params.mNfcChannels)
+            dryparams.NFCtrlFilter.adjust(params.mNfcW0);
+        /* The HRTF target is only used when mixing with HRTF. */
+        if(hashrtf)
+            dryparams.Hrtf.Target = chanparams.HrtfTarget;
+        dryparams.Gains.Target = chanparams.DryGains;
+        /* Find the output channels the voice channel needs to be mixed to. */
+        dryparams.Gains.updateActive(voice->mDirect.Buffer.size());
 
-        AtomicReplaceHead(context->mFreeVoiceProps, props);
+        for(uint i{0};i < NumSends;i++)
+        {
+            SendParams &wetparams = voice->mChans[c].mWetParams[i];
+            wetparams.LowPass.copyParamsFrom(params.mSend[i].LowPass);
+            wetparams.HighPass.copyParamsFrom(params.mSend[i].HighPass);
+            wetparams.Gains.Target = chanparams.WetGains[i];
+            wetparams.Gains.updateActive(voice->mSend[i].Buffer.size());
+        }
     }
+}
+
+/* Checks if the update has mixing parameters that were calculated with the
+ * mixer's current context, listener, and effect slot parameters.
+ */
+bool HasCurrentParams(const Voice *voice, const VoicePropsItem *props,
+    const ContextParams &Context, const uint NumSends)
+{
+    if(!props->mHasMixParams || props->mContextStamp != Context.ContextStamp
+        || props->mListenerStamp != Context.ListenerStamp)
+        return false;
+    if(props->mListenerPoseStamp != Context.ListenerPoseStamp
+        && UsesListenerPose(voice, props, Context))
+        return false;
+    for(uint i{0};i < NumSends;i++)
+    {
+        const EffectSlot *slot{props->Send[i].Slot};
+        if(slot && slot->mSourceParams.Stamp != props->mSlotStamps[i])
+            return false;
+    }
+    return true;
+}
+
+/* Updates the voice's properties with any pending update. Returns true if its
+ * parameters need to be recalculated.
+ */
+bool UpdateSourceProps(Voice *voice, ALCcontext *context, bool force)
+{
+    VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)};
+    if(!props) return force;
+
+    voice->mProps = *props;
+
+    /* Parameters that were calculated outside of the mixer only need to be
+     * applied, as long as nothing they were calculated with has changed since.
+     */
+    const uint NumSends{context->mDevice->NumAuxSends};
+    const bool calculated{HasCurrentParams(voice, props, context->mParams, NumSends)};
+    if(calculated)
+        ApplyVoiceParams(voice, *props->mMixParams, NumSends);
+
+    context->mVoicePropsPool.put(props);
+    return !calculated;
+}
+
+void CalcNonAttnSourceParams(Voice *voice, const ALCcontext *context)
+{
+    const ALCdevice *Device{context->mDevice.get()};
+    const EffectSlotSourceParams *SendParams[MAX_SENDS];
+    GetSendParams(&voice->mProps, Device->NumAuxSends, SendParams);
+
+    VoiceMixParams &params = *context->mMixParams;
+    CalcNonAttnSourceParams(params, voice, &voice->mProps, context->mParams, SendParams, Device);
+    ApplyVoiceParams(voice, params, Device->NumAuxSends);
+}
+
+void CalcAttnSourceParams(Voice *voice, const ALCcontext *context)
+{
+    const ALCdevice *Device{context->mDevice.get()};
+    const EffectSlotSourceParams *SendParams[MAX_SENDS];
+    GetSendParams(&voice->mProps, Device->NumAuxSends, SendParams);
+
+    VoiceMixParams &params = *context->mMixParams;
+    CalcAttnSourceParams(params, voice, &voice->mProps, context->mParams, SendParams, Device);
+    ApplyVoiceParams(voice, params, Device->NumAuxSends);
+}
+
+} // namespace
+
+bool UsesListenerPose(const Voice *voice, const VoiceProps *props, const ContextParams &context)
+{
+    if(!UsesAttenuation(voice, props))
+        return false;
+    /* Head-relative sources are only affected by the listener's velocity, for
+     * the doppler shift.
+     */
+    return !props->HeadRelative || props->DopplerFactor*context.DopplerFactor > 0.0f;
+}
 
-    if((voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
-            && voice->mFmtChannels != FmtBFormat2D && voice->mFmtChannels != FmtBFormat3D)
-        || voice->mProps.mSpatializeMode==SpatializeMode::Off
-        || (voice->mProps.mSpatializeMode==SpatializeMode::Auto && voice->mFmtChannels != FmtMono))
-        CalcNonAttnSourceParams(voice, &voice->mProps, context);
+void CalcVoiceParams(VoiceMixParams &params, const Voice *voice, const VoiceProps *props,
+    const ContextParams &context, const EffectSlotSourceParams *const (&sendparams)[MAX_SENDS],
+    const ALCdevice *device)
+{
+    if(!UsesAttenuation(voice, props))
+        CalcNonAttnSourceParams(params, voice, props, context, sendparams, device);
     else
-        CalcAttnSourceParams(voice, &voice->mProps, context);
+        CalcAttnSourceParams(params, voice, props, context, sendparams, device);
 }
 
+namespace {
 
 void SendSourceStateEvent(ALCcontext *context, uint id, VChangeState state)
 {
+    if(context->mEventQueueing.load(std::memory_order_acquire))
+    {
+        ALenum alstate{};
+        switch(state)
+        {
+        case VChangeState::Reset: alstate = AL_INITIAL; break;
+        case VChangeState::Stop: alstate = AL_STOPPED; break;
+        case VChangeState::Play: alstate = AL_PLAYING; break;
+        case VChangeState::Pause: alstate = AL_PAUSED; break;
+        /* Shouldn't happen */
+        case VChangeState::Restart: return;
+        }
+        context->queueEventRecord(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, id,
+            static_cast<ALuint>(alstate));
+        return;
+    }
+
     RingBuffer *ring{context->mAsyncEvents.get()};
     auto evt_vec = ring->getWriteVector();
     if(evt_vec.first.len < 1) return;
@@ -1592,12 +1742,14 @@ void ProcessVoiceChanges(ALCcontext *ctx)
         {
             if(Voice *voice{cur->mVoice})
             {
+                voice->beginPositionChange();
                 voice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
                 voice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
                 /* A source ID indicates the voice was playing or paused, which
                  * gets a reset/stop event.
                  */
                 sendevt = voice->mSourceID.exchange(0u, std::memory_order_relaxed) != 0u;
+                voice->endPositionChange();
                 Voice::State oldvstate{Voice::Playing};
                 voice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                     std::memory_order_relaxed, std::memory_order_acquire);
@@ -1625,9 +1777,11 @@ void ProcessVoiceChanges(ALCcontext *ctx)
              */
             if(Voice *oldvoice{cur->mOldVoice})
             {
+                oldvoice->beginPositionChange();
                 oldvoice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
                 oldvoice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
                 oldvoice->mSourceID.store(0u, std::memory_order_relaxed);
+                oldvoice->endPositionChange();
                 Voice::State oldvstate{Voice::Playing};
                 sendevt = !oldvoice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                     std::memory_order_relaxed, std::memory_order_acquire);
@@ -1643,12 +1797,15 @@ void ProcessVoiceChanges(ALCcontext *ctx)
         {
             /* Restarting a voice never sends a source change event. */
             Voice *oldvoice{cur->mOldVoice};
+            oldvoice->beginPositionChange();
             oldvoice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
             oldvoice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
+            const uint oldsid{oldvoice->mSourceID.exchange(0u, std::memory_order_relaxed)};
+            oldvoice->endPositionChange();
             /* If there's no sourceID, the old voice finished so don't start
              * the new one at its new offset.
              */
-            if(oldvoice->mSourceID.exchange(0u, std::memory_order_relaxed) != 0u)
+            if(oldsid != 0u)
             {
                 /* Otherwise, set the voice to stopping if it's not already (it
                  * might already be, if paused), and play the new voice as
@@ -1680,24 +1837,50 @@ void ProcessParamUpdates(ALCcontext *ctx, const EffectSlotArray &slots,
     IncrementRef(ctx->mUpdateCount);
     if LIKELY(!ctx->mHoldUpdates.load(std::memory_order_acquire))
     {
+        bool posechanged{false};
         bool force{CalcContextParams(ctx)};
-        force |= CalcListenerParams(ctx);
+        force |= CalcListenerParams(ctx, posechanged);
         auto sorted_slots = const_cast<EffectSlot**>(slots.data() + slots.size());
         for(EffectSlot *slot : slots)
             force |= CalcEffectSlotParams(slot, sorted_slots, ctx);
 
         for(Voice *voice : voices)
         {
-            /* Only update voices that have a source. */
-            if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
-                CalcSourceParams(voice, ctx, force);
+            /* Only update voices that have a source. Moving the listener only
+             * needs the voices that depend on its pose to be recalculated.
+             */
+            if(voice->mSourceID.load(std::memory_order_relaxed) == 0
+                || !UpdateSourceProps(voice, ctx, force
+                    || (posechanged && UsesListenerPose(voice, &voice->mProps, ctx->mParams))))
+                continue;
+
+            if(!UsesAttenuation(voice, &voice->mProps))
+                CalcNonAttnSourceParams(voice, ctx);
+            else
+                CalcAttnSourceParams(voice, ctx);
         }
     }
     IncrementRef(ctx->mUpdateCount);
 }
 
-void ProcessContexts(ALCdevice *device, const uint SamplesToDo)
+/* Checks if the given buffers have no audible samples. */
+bool IsSilent(const al::span<const FloatBufferLine> buffers, const size_t SamplesToDo)
 {
+    auto is_audible = [](const float sample) noexcept -> bool
+    { return std::fabs(sample) > GainSilenceThreshold; };
+    auto chan_is_silent = [SamplesToDo,is_audible](const FloatBufferLine &buffer) -> bool
+    { return std::none_of(buffer.cbegin(), buffer.cbegin()+SamplesToDo, is_audible); };
+    return std::all_of(buffers.begin(), buffers.end(), chan_is_silent);
+}
+
+/* Mixes the device's contexts, adding the time spent in each stage to
+ * stagetimes and counting the mixed and idle voices.
+ */
+void ProcessContexts(ALCdevice *device, const uint SamplesToDo,
+    MixerStats::StageTimes &stagetimes, uint &numactive, uint &numidle)
+{
+    TraceScope trace{"ProcessContexts"};
+
     ASSUME(SamplesToDo > 0);
 
     for(ALCcontext *ctx : *device->mContexts.load(std::memory_order_acquire))
@@ -1705,9 +1888,15 @@ void ProcessContexts(ALCdevice *device, const uint SamplesToDo)
         const EffectSlotArray &auxslots = *ctx->mActiveAuxSlots.load(std::memory_order_acquire);
         const al::span<Voice*> voices{ctx->getVoicesSpanAcquired()};
 
+        auto stagestart = MixerStats::clock::now();
+
         /* Process pending propery updates for objects on the context. */
         ProcessParamUpdates(ctx, auxslots, voices);
 
+        auto stageend = MixerStats::clock::now();
+        stagetimes[MixerStats::ParamUpdates] += stageend - stagestart;
+        stagestart = stageend;
+
         /* Clear auxiliary effect slot mixing buffers. */
         for(EffectSlot *slot : auxslots)
         {
@@ -1720,9 +1909,18 @@ void ProcessContexts(ALCdevice *device, const uint SamplesToDo)
         {
             const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
             if(vstate != Voice::Stopped && vstate != Voice::Pending)
+            {
                 voice->mix(vstate, ctx, SamplesToDo);
+                ++numactive;
+            }
+            else if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
+                ++numidle;
         }
 
+        stageend = MixerStats::clock::now();
+        stagetimes[MixerStats::Voices] += stageend - stagestart;
+        stagestart = stageend;
+
         /* Process effects. */
         if(const size_t num_slots{auxslots.size()})
         {
@@ -1782,10 +1980,20 @@ void ProcessContexts(ALCdevice *device, const uint SamplesToDo)
             for(const EffectSlot *slot : sorted_slots)
             {
                 EffectState *state{slot->mEffectState};
+                if(state->mIsIdle)
+                {
+                    /* Leave idle effects asleep until they get some input. */
+                    if(IsSilent(slot->Wet.Buffer, SamplesToDo))
+                        continue;
+                    state->mIsIdle = false;
+                }
+                TraceScope slottrace{"EffectState::process", "slot", slot->mId};
                 state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
             }
         }
 
+        stagetimes[MixerStats::Effects] += MixerStats::clock::now() - stagestart;
+
         /* Signal the event handler if there are any events to read. */
         RingBuffer *ring{ctx->mAsyncEvents.get()};
         if(ring->readSpace() > 0)
@@ -1904,6 +2112,11 @@ void Write(const al::span<const FloatBufferLine> InBuffer, void *OutBuffer, cons
 
 void ALCdevice::renderSamples(void *outBuffer, const uint numSamples, const size_t frameStep)
 {
+    TraceScope trace{"renderSamples", "samples", numSamples};
+    const auto periodstart = MixerStats::clock::now();
+    MixerStats::StageTimes stagetimes{};
+    uint numactive{0u}, numidle{0u};
+
     FPUCtl mixer_mode{};
     for(uint written{0u};written < numSamples;)
     {
@@ -1916,8 +2129,17 @@ void ALCdevice::renderSamples(void *outBuffer, const uint numSamples, const size
         /* Increment the mix count at the start (lsb should now be 1). */
         IncrementRef(MixCount);
 
-        /* Process and mix each context's sources and effects. */
-        ProcessContexts(this, samplesToDo);
+        /* The clock time at the end of this mix, for the voices to mark their
+         * updated positions with.
+         */
+        mMixEndTime = ClockBase + std::chrono::nanoseconds{
+            std::chrono::seconds{SamplesDone + samplesToDo}} / Frequency;
+
+        /* Process and mix each context's sources and effects. Only the last
+         * update's voice counts are kept.
+         */
+        numactive = numidle = 0u;
+        ProcessContexts(this, samplesToDo, stagetimes, numactive, numidle);
 
         /* Increment the clock time. Every second's worth of samples is
          * converted and added to clock base so that large sample counts don't
@@ -1927,6 +2149,7 @@ void ALCdevice::renderSamples(void *outBuffer, const uint numSamples, const size
         SamplesDone += samplesToDo;
         ClockBase += std::chrono::seconds{SamplesDone / Frequency};
         SamplesDone %= Frequency;
+        mClockTime.store(mMixEndTime.count(), std::memory_order_release);
 
         /* Increment the mix count at the end (lsb should now be 0). */
         IncrementRef(MixCount);
@@ -1934,10 +2157,21 @@ void ALCdevice::renderSamples(void *outBuffer, const uint numSamples, const size
         /* Apply any needed post-process for finalizing the Dry mix to the
          * RealOut (Ambisonic decode, UHJ encode, etc).
          */
+        auto stagestart = MixerStats::clock::now();
         postProcess(samplesToDo);
 
+        auto stageend = MixerStats::clock::now();
+        stagetimes[MixerStats::PostProcess] += stageend - stagestart;
+        stagestart = stageend;
+
         /* Apply compression, limiting sample amplitude if needed or desired. */
-        if(Limiter) Limiter->process(samplesToDo, RealOut.Buffer.data());
+        if(Limiter)
+        {
+            Limiter->process(samplesToDo, RealOut.Buffer.data());
+            stageend = MixerStats::clock::now();
+            stagetimes[MixerStats::Limiter] += stageend - stagestart;
+            stagestart = stageend;
+        }
 
         /* Apply delays and attenuation for mismatched speaker distances. */
         if(ChannelDelays)
@@ -1968,9 +2202,18 @@ void ALCdevice::renderSamples(void *outBuffer, const uint numSamples, const size
 #undef HANDLE_WRITE
             }
         }
+        /* Distance compensation and dithering are counted with the output
+         * conversion.
+         */
+        stagetimes[MixerStats::Write] += MixerStats::clock::now() - stagestart;
 
         written += samplesToDo;
     }
+
+    const auto periodtime = MixerStats::clock::now() - periodstart;
+    const auto deadline = std::chrono::duration_cast<MixerStats::clock::duration>(
+        std::chrono::nanoseconds{std::chrono::seconds{numSamples}} / Frequency);
+    mMixStats.update(stagetimes, periodtime, deadline, numactive, numidle);
 }
 
 void ALCdevice::handleDisconnect(const char *msg, ...)
@@ -1994,22 +2237,29 @@ void ALCdevice::handleDisconnect(const char *msg, ...)
         const uint enabledevt{ctx->mEnabledEvts.load(std::memory_order_acquire)};
         if((enabledevt&EventType_Disconnected))
         {
-            RingBuffer *ring{ctx->mAsyncEvents.get()};
-            auto evt_data = ring->getWriteVector().first;
-            if(evt_data.len > 0)
+            if(ctx->mEventQueueing.load(std::memory_order_acquire))
+                ctx->queueEventRecord(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0);
+            else
             {
-                ::new(evt_data.buf) AsyncEvent{evt};
-                ring->writeAdvance(1);
-                ctx->mEventSem.post();
+                RingBuffer *ring{ctx->mAsyncEvents.get()};
+                auto evt_data = ring->getWriteVector().first;
+                if(evt_data.len > 0)
+                {
+                    ::new(evt_data.buf) AsyncEvent{evt};
+                    ring->writeAdvance(1);
+                    ctx->mEventSem.post();
+                }
             }
         }
 
         auto voicelist = ctx->getVoicesSpanAcquired();
         auto stop_voice = [](Voice *voice) -> void
         {
+            voice->beginPositionChange();
             voice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
             voice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
             voice->mSourceID.store(0u, std::memory_order_relaxed);
+            voice->endPositionChange();
             voice->mPlayState.store(Voice::Stopped, std::memory_order_release);
         };
         std::for_each(voicelist.begin(), voicelist.end(), stop_voice);
@@ -4,6 +4,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 #include "alspan.h"
@@ -13,8 +14,15 @@
 
 struct ALCcontext;
 struct ALCdevice;
+struct ContextParams;
+struct ContextProps;
 struct EffectSlot;
+struct EffectSlotSourceParams;
+struct ListenerProps;
 struct MixParams;
+struct Voice;
+struct VoiceMixParams;
+struct VoiceProps;
 
 
 #define MAX_SENDS  6
@@ -26,6 +34,18 @@ using MixerFunc = void(*)(const al::span<const float> InSamples,
 
 extern MixerFunc MixSamples;
 
+using SparseMixerFunc = void(*)(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, float *CurrentGains, const float *TargetGains,
+    const al::span<const uint8_t> OutChans, const size_t Counter, const size_t OutPos);
+
+extern SparseMixerFunc MixSamplesSparse;
+
+using MatrixMixerFunc = void(*)(const al::span<const float*const> InSamples,
+    const al::span<float*const> OutSamples, const float *Gains, const size_t GainStride,
+    const size_t SamplesToDo);
+
+extern MatrixMixerFunc MixMatrix;
+
 
 constexpr float GainMixMax{1000.0f}; /* +60dB */
 
@@ -56,6 +76,30 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, HrtfRequestMode hrtf_appreq
 
 void aluInitEffectPanning(EffectSlot *slot, ALCcontext *context);
 
+/* Sets the context and listener parameters used for calculating source
+ * parameters, from the given property updates.
+ */
+void SetContextParams(ContextParams &params, const ContextProps &props);
+void SetListenerParams(ContextParams &params, const ListenerProps &props, const float gainboost);
+
+/**
+ * Checks if the voice's mixing parameters depend on the listener's position,
+ * orientation, or velocity. Other sources are only affected by the listener's
+ * gain, so they don't need recalculating when the listener moves.
+ */
+bool UsesListenerPose(const Voice *voice, const VoiceProps *props, const ContextParams &context);
+
+/**
+ * Calculates the mixing parameters for a voice playing with the given
+ * properties. The context parameters and the source parameters of the effect
+ * slot on each send (null for sends without a slot) are what the mixer would
+ * calculate them with. Only reads from the voice, so it can be used outside of
+ * the mixer.
+ */
+void CalcVoiceParams(VoiceMixParams &params, const Voice *voice, const VoiceProps *props,
+    const ContextParams &context, const EffectSlotSourceParams *const (&sendparams)[MAX_SENDS],
+    const ALCdevice *device);
+
 /**
  * Calculates ambisonic encoder coefficients using the X, Y, and Z direction
  * components, which must represent a normalized (unit length) vector, and the
@@ -448,8 +448,11 @@ int AlsaPlayback::mixerProc()
     const size_t samplebits{mDevice->bytesFromFmt() * 8};
     const snd_pcm_uframes_t update_size{mDevice->UpdateSize};
     const snd_pcm_uframes_t buffer_size{mDevice->BufferSize};
+    bool waited{false};
     while(!mKillNow.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         int state{verify_state(mPcmHandle)};
         if(state < 0)
         {
@@ -457,6 +460,14 @@ int AlsaPlayback::mixerProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+        {
+            /* Whatever was waited on before the underrun isn't what's being
+             * filled now, so don't count it as wakeup latency.
+             */
+            recordXRun();
+            waited = false;
+        }
 
         snd_pcm_sframes_t avails{snd_pcm_avail_update(mPcmHandle)};
         if(avails < 0)
@@ -470,6 +481,7 @@ int AlsaPlayback::mixerProc()
         {
             WARN("available samples exceeds the buffer size\n");
             snd_pcm_reset(mPcmHandle);
+            waited = false;
             continue;
         }
 
@@ -487,9 +499,21 @@ int AlsaPlayback::mixerProc()
             }
             if(snd_pcm_wait(mPcmHandle, 1000) == 0)
                 ERR("Wait timeout... buffer size too low?\n");
+            waited = true;
             continue;
         }
+        /* Anything more than an update's worth of space after waiting means
+         * the thread woke up late.
+         */
+        if(waited)
+        {
+            const snd_pcm_uframes_t extra{avail - update_size};
+            recordWakeupLatency(std::chrono::nanoseconds{std::chrono::seconds{extra}}
+                / mDevice->Frequency);
+        }
+        waited = false;
         avail -= avail%update_size;
+        recordCallback(static_cast<uint>(avail));
 
         // it is possible that contiguous areas are smaller, thus we use a loop
         std::lock_guard<std::mutex> _{mMutex};
@@ -532,8 +556,11 @@ int AlsaPlayback::mixerNoMMapProc()
     const size_t frame_step{mDevice->channelsFromFmt()};
     const snd_pcm_uframes_t update_size{mDevice->UpdateSize};
     const snd_pcm_uframes_t buffer_size{mDevice->BufferSize};
+    bool waited{false};
     while(!mKillNow.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         int state{verify_state(mPcmHandle)};
         if(state < 0)
         {
@@ -541,6 +568,14 @@ int AlsaPlayback::mixerNoMMapProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+        {
+            /* Whatever was waited on before the underrun isn't what's being
+             * filled now, so don't count it as wakeup latency.
+             */
+            recordXRun();
+            waited = false;
+        }
 
         snd_pcm_sframes_t avail{snd_pcm_avail_update(mPcmHandle)};
         if(avail < 0)
@@ -553,6 +588,7 @@ int AlsaPlayback::mixerNoMMapProc()
         {
             WARN("available samples exceeds the buffer size\n");
             snd_pcm_reset(mPcmHandle);
+            waited = false;
             continue;
         }
 
@@ -569,11 +605,23 @@ int AlsaPlayback::mixerNoMMapProc()
             }
             if(snd_pcm_wait(mPcmHandle, 1000) == 0)
                 ERR("Wait timeout... buffer size too low?\n");
+            waited = true;
             continue;
         }
+        /* Anything more than an update's worth of space after waiting means
+         * the thread woke up late.
+         */
+        if(waited)
+        {
+            const snd_pcm_uframes_t extra{static_cast<snd_pcm_uframes_t>(avail) - update_size};
+            recordWakeupLatency(std::chrono::nanoseconds{std::chrono::seconds{extra}}
+                / mDevice->Frequency);
+        }
+        waited = false;
 
         al::byte *WritePtr{mBuffer.data()};
         avail = snd_pcm_bytes_to_frames(mPcmHandle, static_cast<ssize_t>(mBuffer.size()));
+        recordCallback(static_cast<uint>(avail));
         std::lock_guard<std::mutex> _{mMutex};
         mDevice->renderSamples(WritePtr, static_cast<uint>(avail), frame_step);
         while(avail > 0)
@@ -589,6 +637,8 @@ int AlsaPlayback::mixerNoMMapProc()
 #endif
             case -EPIPE:
             case -EINTR:
+                if(ret == -EPIPE)
+                    recordXRun();
                 ret = snd_pcm_recover(mPcmHandle, static_cast<int>(ret), 1);
                 if(ret < 0)
                     avail = 0;
@@ -821,6 +871,7 @@ void AlsaPlayback::start()
 #undef CHECK
 
     try {
+        resetCallbackTiming();
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(thread_func), this};
     }
@@ -4,6 +4,7 @@
 #include "base.h"
 
 #include <atomic>
+#include <cinttypes>
 #include <thread>
 
 #ifdef _WIN32
@@ -20,6 +21,9 @@
 #include "core/logging.h"
 
 
+BackendBase::~BackendBase()
+{ stopStatsLogger(); }
+
 bool BackendBase::reset()
 { throw al::backend_exception{al::backend_error::DeviceError, "Invalid BackendBase call"}; }
 
@@ -29,16 +33,78 @@ void BackendBase::captureSamples(al::byte*, uint)
 uint BackendBase::availableSamples()
 { return 0; }
 
+void BackendBase::recordCallback(uint samples) noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    if(!mLastCallbackSamples)
+        mNextStatsLog = now + mStatsLogInterval;
+    else
+    {
+        const std::chrono::nanoseconds expected{
+            std::chrono::nanoseconds{std::chrono::seconds{mLastCallbackSamples}} /
+            mDevice->Frequency};
+        const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - mLastCallback);
+        mStats.mCallbackJitter.add((interval > expected) ? interval-expected : expected-interval);
+    }
+    mLastCallback = now;
+    mLastCallbackSamples = samples;
+
+    if(mStatsLogInterval.count() > 0 && now >= mNextStatsLog)
+    {
+        mNextStatsLog = now + mStatsLogInterval;
+        mStatsLogDue.store(true, std::memory_order_release);
+    }
+}
+
+void BackendBase::startStatsLogger()
+{
+    if(mStatsLogInterval.count() <= 0 || mStatsLogger.joinable())
+        return;
+
+    mStatsLoggerKill.store(false, std::memory_order_release);
+    mStatsLogger = std::thread{[this]()
+    {
+        while(!mStatsLoggerKill.load(std::memory_order_acquire))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            logStatsIfDue();
+        }
+    }};
+}
+
+void BackendBase::stopStatsLogger() noexcept
+{
+    if(!mStatsLogger.joinable())
+        return;
+    mStatsLoggerKill.store(true, std::memory_order_release);
+    mStatsLogger.join();
+}
+
+void BackendBase::logStats() noexcept
+{
+    const uint64_t xruns{mStats.mXRuns.load(std::memory_order_relaxed)};
+    const uint64_t newxruns{xruns - mLastLoggedXRuns};
+    mLastLoggedXRuns = xruns;
+
+    const MixerStats &mixstats = mDevice->mMixStats;
+    WARN("Backend stats: %" PRIu64 " xruns (%" PRIu64 " new), callback jitter p99 %.3fms max "
+        "%.3fms, wakeup latency p99 %.3fms max %.3fms, period time p99 %.3fms max %.3fms, %"
+        PRIu64 " deadline misses\n", xruns, newxruns,
+        static_cast<double>(mStats.mCallbackJitter.getPercentile(0.99)) / 1000000.0,
+        static_cast<double>(mStats.mCallbackJitter.getMax()) / 1000000.0,
+        static_cast<double>(mStats.mWakeupLatency.getPercentile(0.99)) / 1000000.0,
+        static_cast<double>(mStats.mWakeupLatency.getMax()) / 1000000.0,
+        static_cast<double>(mixstats.mPeriodTimes.getPercentile(0.99)) / 1000000.0,
+        static_cast<double>(mixstats.mPeriodTimes.getMax()) / 1000000.0,
+        uint64_t{mixstats.mDeadlineMisses.load(std::memory_order_relaxed)});
+}
+
 ClockLatency BackendBase::getClockLatency()
 {
     ClockLatency ret;
 
-    uint refcount;
-    do {
-        refcount = mDevice->waitForMix();
-        ret.ClockTime = GetDeviceClockTime(mDevice);
-        std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != ReadRef(mDevice->MixCount));
+    ret.ClockTime = mDevice->getClockTime();
 
     /* NOTE: The device will generally have about all but one periods filled at
      * any given time during playback. Without a more accurate measurement from
@@ -1,14 +1,18 @@
 #ifndef ALC_BACKENDS_BASE_H
 #define ALC_BACKENDS_BASE_H
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "albyte.h"
 #include "alcmain.h"
 #include "core/except.h"
+#include "mixstats.h"
 
 
 using uint = unsigned int;
@@ -18,6 +22,27 @@ struct ClockLatency {
     std::chrono::nanoseconds Latency;
 };
 
+/* Statistics on how well the backend is keeping up with the device. */
+struct BackendStats {
+    /* Underruns (or overruns, for capture) reported by or detected in the
+     * backend.
+     */
+    std::atomic<uint64_t> mXRuns{0u};
+    /* How far the time between callbacks strays from the length of audio
+     * handled by the previous callback.
+     */
+    TimeHistogram mCallbackJitter;
+    /* How late the mixer thread wakes up after there's space to mix into. */
+    TimeHistogram mWakeupLatency;
+
+    void reset() noexcept
+    {
+        mXRuns.store(0u, std::memory_order_relaxed);
+        mCallbackJitter.reset();
+        mWakeupLatency.reset();
+    }
+};
+
 struct BackendBase {
     virtual void open(const char *name) = 0;
 
@@ -32,10 +57,50 @@ struct BackendBase {
 
     ALCdevice *const mDevice;
 
+    BackendStats mStats;
+    /* How often to log the stats while running, or 0 to not log them. */
+    std::chrono::seconds mStatsLogInterval{0};
+
     BackendBase(ALCdevice *device) noexcept : mDevice{device} { }
-    virtual ~BackendBase() = default;
+    virtual ~BackendBase();
 
 protected:
+    /** Records an xrun. This is safe to call from any thread. */
+    void recordXRun() noexcept
+    { mStats.mXRuns.fetch_add(1u, std::memory_order_relaxed); }
+    /**
+     * Records the start of a callback (or a mixer thread wakeup) that will
+     * handle the given number of samples, and flags the stats to be logged
+     * when they're due. Must only be called from one thread at a time.
+     */
+    void recordCallback(uint samples) noexcept;
+    /**
+     * Logs the stats if recordCallback flagged them as due. This formats and
+     * writes the log message, so it must not be called from a real-time
+     * callback.
+     */
+    void logStatsIfDue() noexcept
+    {
+        if UNLIKELY(mStatsLogDue.load(std::memory_order_relaxed)
+            && mStatsLogDue.exchange(false, std::memory_order_acquire))
+            logStats();
+    }
+    /**
+     * Starts and stops a thread that logs the stats when they're due, for
+     * backends with no thread of their own to call logStatsIfDue from. The
+     * thread is only started if the stats are to be logged.
+     */
+    void startStatsLogger();
+    void stopStatsLogger() noexcept;
+    /**
+     * Restarts the callback timing, so time spent stopped isn't counted as
+     * jitter. Should be called when starting, before any callbacks.
+     */
+    void resetCallbackTiming() noexcept { mLastCallbackSamples = 0u; }
+    /** Records how late the mixer thread woke up. */
+    void recordWakeupLatency(std::chrono::nanoseconds latency) noexcept
+    { mStats.mWakeupLatency.add(latency); }
+
     /** Sets the default channel order used by most non-WaveFormatEx-based APIs. */
     void setDefaultChannelOrder();
     /** Sets the default channel order used by WaveFormatEx. */
@@ -45,6 +110,19 @@ protected:
     /** Sets the channel order given the WaveFormatEx mask. */
     void setChannelOrderFromWFXMask(uint chanmask);
 #endif
+
+private:
+    std::chrono::steady_clock::time_point mLastCallback;
+    uint mLastCallbackSamples{0u};
+
+    std::chrono::steady_clock::time_point mNextStatsLog;
+    std::atomic<bool> mStatsLogDue{false};
+    uint64_t mLastLoggedXRuns{0u};
+
+    std::atomic<bool> mStatsLoggerKill{false};
+    std::thread mStatsLogger;
+
+    void logStats() noexcept;
 };
 using BackendPtr = std::unique_ptr<BackendBase>;
 
@@ -36,6 +36,7 @@
 #include "alconfig.h"
 #include "compat.h"
 #include "core/logging.h"
+#include "core/trace.h"
 #include "dynload.h"
 #include "ringbuffer.h"
 #include "threads.h"
@@ -64,6 +65,7 @@ namespace {
     MAGIC(jack_get_sample_rate);   \
     MAGIC(jack_set_error_function); \
     MAGIC(jack_set_process_callback); \
+    MAGIC(jack_set_xrun_callback); \
     MAGIC(jack_set_buffer_size_callback); \
     MAGIC(jack_set_buffer_size);   \
     MAGIC(jack_get_buffer_size);
@@ -91,6 +93,7 @@ decltype(jack_error_callback) * pjack_error_callback;
 #define jack_get_sample_rate pjack_get_sample_rate
 #define jack_set_error_function pjack_set_error_function
 #define jack_set_process_callback pjack_set_process_callback
+#define jack_set_xrun_callback pjack_set_xrun_callback
 #define jack_set_buffer_size_callback pjack_set_buffer_size_callback
 #define jack_set_buffer_size pjack_set_buffer_size
 #define jack_get_buffer_size pjack_get_buffer_size
@@ -243,6 +246,10 @@ struct JackPlayback final : public BackendBase {
     static int processC(jack_nframes_t numframes, void *arg) noexcept
     { return static_cast<JackPlayback*>(arg)->process(numframes); }
 
+    int xrun() noexcept;
+    static int xrunC(void *arg) noexcept
+    { return static_cast<JackPlayback*>(arg)->xrun(); }
+
     int mixerProc();
 
     void open(const char *name) override;
@@ -261,6 +268,8 @@ struct JackPlayback final : public BackendBase {
     std::atomic<bool> mPlaying{false};
     RingBufferPtr mRing;
     al::semaphore mSem;
+    /* When the process callback last woke the mixer thread. */
+    std::atomic<std::chrono::steady_clock::rep> mWakeTime{0};
 
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
@@ -285,6 +294,9 @@ JackPlayback::~JackPlayback()
 
 int JackPlayback::process(jack_nframes_t numframes) noexcept
 {
+    TraceScope trace{"JackPlayback::process", "samples", numframes};
+    recordCallback(numframes);
+
     std::array<jack_default_audio_sample_t*,MAX_OUTPUT_CHANNELS> out;
     size_t numchans{0};
     for(auto port : mPort)
@@ -335,7 +347,13 @@ int JackPlayback::process(jack_nframes_t numframes) noexcept
         }
 
         mRing->readAdvance(total);
+        mWakeTime.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+            std::memory_order_relaxed);
         mSem.post();
+
+        /* The mixer didn't keep up. */
+        if UNLIKELY(numframes > total)
+            recordXRun();
     }
 
     if(numframes > total)
@@ -348,6 +366,12 @@ int JackPlayback::process(jack_nframes_t numframes) noexcept
     return 0;
 }
 
+int JackPlayback::xrun() noexcept
+{
+    recordXRun();
+    return 0;
+}
+
 int JackPlayback::mixerProc()
 {
     SetRTPriority();
@@ -358,9 +382,16 @@ int JackPlayback::mixerProc()
     while(!mKillNow.load(std::memory_order_acquire)
         && mDevice->Connected.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         if(mRing->writeSpace() < mDevice->UpdateSize)
         {
             mSem.wait();
+            if(auto waketime = mWakeTime.exchange(0, std::memory_order_relaxed))
+            {
+                const std::chrono::steady_clock::duration woken{waketime};
+                recordWakeupLatency(std::chrono::steady_clock::now().time_since_epoch() - woken);
+            }
             continue;
         }
 
@@ -422,6 +453,7 @@ void JackPlayback::open(const char *name)
     }
 
     jack_set_process_callback(mClient, &JackPlayback::processC, this);
+    jack_set_xrun_callback(mClient, &JackPlayback::xrunC, this);
 
     mDevice->DeviceName = name;
 }
@@ -483,6 +515,7 @@ bool JackPlayback::reset()
 
 void JackPlayback::start()
 {
+    resetCallbackTiming();
     if(jack_activate(mClient))
         throw al::backend_exception{al::backend_error::DeviceError, "Failed to activate client"};
 
@@ -69,10 +69,13 @@ int NullBackend::mixerProc()
     althrd_setname(MIXER_THREAD_NAME);
 
     int64_t done{0};
+    bool waited{false};
     auto start = std::chrono::steady_clock::now();
     while(!mKillNow.load(std::memory_order_acquire)
         && mDevice->Connected.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         auto now = std::chrono::steady_clock::now();
 
         /* This converts from nanoseconds to nanosamples, then to samples. */
@@ -80,8 +83,23 @@ int NullBackend::mixerProc()
         if(avail-done < mDevice->UpdateSize)
         {
             std::this_thread::sleep_for(restTime);
+            waited = true;
             continue;
         }
+
+        /* Anything more than an update's worth of samples after sleeping
+         * means the thread woke up late, and being more than a full buffer
+         * behind would have been an underrun on a real device.
+         */
+        const int64_t todo{avail - done};
+        if(waited)
+            recordWakeupLatency(nanoseconds{seconds{todo - mDevice->UpdateSize}}
+                / mDevice->Frequency);
+        waited = false;
+        if(todo > mDevice->BufferSize)
+            recordXRun();
+        recordCallback(static_cast<uint>(todo - todo%mDevice->UpdateSize));
+
         while(avail-done >= mDevice->UpdateSize)
         {
             mDevice->renderSamples(nullptr, mDevice->UpdateSize, 0u);
@@ -125,6 +143,7 @@ bool NullBackend::reset()
 void NullBackend::start()
 {
     try {
+        resetCallbackTiming();
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(&NullBackend::mixerProc), this};
     }
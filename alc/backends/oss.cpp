@@ -265,6 +265,8 @@ int OSSPlayback::mixerProc()
     while(!mKillNow.load(std::memory_order_acquire)
         && mDevice->Connected.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         pollfd pollitem{};
         pollitem.fd = mFd;
         pollitem.events = POLLOUT;
@@ -286,6 +288,7 @@ int OSSPlayback::mixerProc()
 
         al::byte *write_ptr{mMixData.data()};
         size_t to_write{mMixData.size()};
+        recordCallback(static_cast<uint>(to_write/frame_size));
         mDevice->renderSamples(write_ptr, static_cast<uint>(to_write/frame_size), frame_step);
         while(to_write > 0 && !mKillNow.load(std::memory_order_acquire))
         {
@@ -417,6 +420,7 @@ bool OSSPlayback::reset()
 void OSSPlayback::start()
 {
     try {
+        resetCallbackTiming();
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(&OSSPlayback::mixerProc), this};
     }
@@ -40,6 +40,7 @@
 #include "alconfig.h"
 #include "compat.h"
 #include "core/logging.h"
+#include "core/trace.h"
 #include "dynload.h"
 #include "strutils.h"
 
@@ -591,6 +592,7 @@ void PulseMainloop::close(pa_context *context, pa_stream *stream)
         pa_stream_set_state_callback(stream, nullptr, nullptr);
         pa_stream_set_moved_callback(stream, nullptr, nullptr);
         pa_stream_set_write_callback(stream, nullptr, nullptr);
+        pa_stream_set_underflow_callback(stream, nullptr, nullptr);
         pa_stream_set_buffer_attr_callback(stream, nullptr, nullptr);
         pa_stream_disconnect(stream);
         pa_stream_unref(stream);
@@ -676,6 +678,10 @@ struct PulsePlayback final : public BackendBase {
     static void streamWriteCallbackC(pa_stream *stream, size_t nbytes, void *pdata) noexcept
     { static_cast<PulsePlayback*>(pdata)->streamWriteCallback(stream, nbytes); }
 
+    void streamUnderflowCallback(pa_stream *stream) noexcept;
+    static void streamUnderflowCallbackC(pa_stream *stream, void *pdata) noexcept
+    { static_cast<PulsePlayback*>(pdata)->streamUnderflowCallback(stream); }
+
     void sinkInfoCallback(pa_context *context, const pa_sink_info *info, int eol) noexcept;
     static void sinkInfoCallbackC(pa_context *context, const pa_sink_info *info, int eol, void *pdata) noexcept
     { static_cast<PulsePlayback*>(pdata)->sinkInfoCallback(context, info, eol); }
@@ -743,6 +749,9 @@ void PulsePlayback::streamStateCallback(pa_stream *stream) noexcept
 
 void PulsePlayback::streamWriteCallback(pa_stream *stream, size_t nbytes) noexcept
 {
+    TraceScope trace{"PulsePlayback::streamWriteCallback", "samples",
+        static_cast<uint32_t>(nbytes/mFrameSize)};
+    recordCallback(static_cast<uint>(nbytes/mFrameSize));
     do {
         pa_free_cb_t free_func{nullptr};
         auto buflen = static_cast<size_t>(-1);
@@ -765,6 +774,9 @@ void PulsePlayback::streamWriteCallback(pa_stream *stream, size_t nbytes) noexce
     } while(nbytes > 0);
 }
 
+void PulsePlayback::streamUnderflowCallback(pa_stream*) noexcept
+{ recordXRun(); }
+
 void PulsePlayback::sinkInfoCallback(pa_context*, const pa_sink_info *info, int eol) noexcept
 {
     struct ChannelMap {
@@ -891,6 +903,7 @@ bool PulsePlayback::reset()
         pa_stream_set_state_callback(mStream, nullptr, nullptr);
         pa_stream_set_moved_callback(mStream, nullptr, nullptr);
         pa_stream_set_write_callback(mStream, nullptr, nullptr);
+        pa_stream_set_underflow_callback(mStream, nullptr, nullptr);
         pa_stream_set_buffer_attr_callback(mStream, nullptr, nullptr);
         pa_stream_disconnect(mStream);
         pa_stream_unref(mStream);
@@ -1029,7 +1042,9 @@ void PulsePlayback::start()
 {
     auto plock = mMainloop.getUniqueLock();
 
+    resetCallbackTiming();
     pa_stream_set_write_callback(mStream, &PulsePlayback::streamWriteCallbackC, this);
+    pa_stream_set_underflow_callback(mStream, &PulsePlayback::streamUnderflowCallbackC, this);
     pa_operation *op{pa_stream_cork(mStream, 0, &PulseMainloop::streamSuccessCallbackC,
         &mMainloop)};
 
@@ -1058,16 +1073,24 @@ void PulsePlayback::start()
     }
 
     mMainloop.waitForOperation(op, plock);
+
+    /* The write callback runs on the mainloop's thread, which can't block on
+     * logging, so a separate thread logs the stats.
+     */
+    startStatsLogger();
 }
 
 void PulsePlayback::stop()
 {
+    stopStatsLogger();
+
     auto plock = mMainloop.getUniqueLock();
 
     pa_operation *op{pa_stream_cork(mStream, 1, &PulseMainloop::streamSuccessCallbackC,
         &mMainloop)};
     mMainloop.waitForOperation(op, plock);
     pa_stream_set_write_callback(mStream, nullptr, nullptr);
+    pa_stream_set_underflow_callback(mStream, nullptr, nullptr);
 }
 
 
@@ -131,10 +131,13 @@ int WaveBackend::mixerProc()
     const size_t frameSize{mDevice->frameSizeFromFmt()};
 
     int64_t done{0};
+    bool waited{false};
     auto start = std::chrono::steady_clock::now();
     while(!mKillNow.load(std::memory_order_acquire) &&
           mDevice->Connected.load(std::memory_order_acquire))
     {
+        logStatsIfDue();
+
         auto now = std::chrono::steady_clock::now();
 
         /* This converts from nanoseconds to nanosamples, then to samples. */
@@ -143,8 +146,23 @@ int WaveBackend::mixerProc()
         if(avail-done < mDevice->UpdateSize)
         {
             std::this_thread::sleep_for(restTime);
+            waited = true;
             continue;
         }
+
+        /* Anything more than an update's worth of samples after sleeping
+         * means the thread woke up late, and being more than a full buffer
+         * behind would have been an underrun on a real device.
+         */
+        const int64_t todo{avail - done};
+        if(waited)
+            recordWakeupLatency(nanoseconds{seconds{todo - mDevice->UpdateSize}}
+                / mDevice->Frequency);
+        waited = false;
+        if(todo > mDevice->BufferSize)
+            recordXRun();
+        recordCallback(static_cast<uint>(todo - todo%mDevice->UpdateSize));
+
         while(avail-done >= mDevice->UpdateSize)
         {
             mDevice->renderSamples(mBuffer.data(), mDevice->UpdateSize, frameStep);
@@ -339,6 +357,7 @@ void WaveBackend::start()
     if(mDataStart > 0 && fseek(mFile, 0, SEEK_END) != 0)
         WARN("Failed to seek on output file\n");
     try {
+        resetCallbackTiming();
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(&WaveBackend::mixerProc), this};
     }
@@ -11,9 +11,11 @@
 #include <numeric>
 
 #include "almalloc.h"
+#include "alnumeric.h"
 #include "alu.h"
 #include "core/ambdec.h"
 #include "core/filters/splitter.h"
+#include "core/mixer/defs.h"
 #include "front_stablizer.h"
 #include "math_defs.h"
 #include "opthelpers.h"
@@ -68,7 +70,7 @@ BFormatDec::BFormatDec(const AmbDecConf *conf, const bool allow_2band, const siz
             for(size_t i{0u};i < conf->NumSpeakers;++i)
             {
                 const size_t chanidx{chanmap[i]};
-                mChannelDec[j].mGains.Single[chanidx] = conf->Matrix[i][k] * gain;
+                mMatrix[chanidx][j] = conf->Matrix[i][k] * gain;
             }
             ++k;
         }
@@ -90,8 +92,8 @@ BFormatDec::BFormatDec(const AmbDecConf *conf, const bool allow_2band, const siz
             for(size_t i{0u};i < conf->NumSpeakers;++i)
             {
                 const size_t chanidx{chanmap[i]};
-                mChannelDec[j].mGains.Dual[sHFBand][chanidx] = conf->HFMatrix[i][k] * hfGain;
-                mChannelDec[j].mGains.Dual[sLFBand][chanidx] = conf->LFMatrix[i][k] * lfGain;
+                mMatrix[chanidx][j*sNumBands + sHFBand] = conf->HFMatrix[i][k] * hfGain;
+                mMatrix[chanidx][j*sNumBands + sLFBand] = conf->LFMatrix[i][k] * lfGain;
             }
             ++k;
         }
@@ -106,22 +108,18 @@ BFormatDec::BFormatDec(const size_t inchans, const al::span<const ChannelDec> co
     {
         for(size_t j{0};j < mChannelDec.size();++j)
         {
-            float *outcoeffs{mChannelDec[j].mGains.Single};
-            for(const ChannelDec &incoeffs : coeffs)
-                *(outcoeffs++) = incoeffs[j];
+            for(size_t i{0};i < coeffs.size();++i)
+                mMatrix[i][j] = coeffs[i][j];
         }
     }
     else
     {
         for(size_t j{0};j < mChannelDec.size();++j)
         {
-            float *outcoeffs{mChannelDec[j].mGains.Dual[sHFBand]};
-            for(const ChannelDec &incoeffs : coeffs)
-                *(outcoeffs++) = incoeffs[j];
-
-            outcoeffs = mChannelDec[j].mGains.Dual[sLFBand];
-            for(const ChannelDec &incoeffs : coeffslf)
-                *(outcoeffs++) = incoeffs[j];
+            for(size_t i{0};i < coeffs.size();++i)
+                mMatrix[i][j*sNumBands + sHFBand] = coeffs[i][j];
+            for(size_t i{0};i < coeffslf.size();++i)
+                mMatrix[i][j*sNumBands + sLFBand] = coeffslf[i][j];
         }
     }
 }
@@ -131,30 +129,56 @@ void BFormatDec::process(const al::span<FloatBufferLine> OutBuffer,
     const FloatBufferLine *InSamples, const size_t SamplesToDo)
 {
     ASSUME(SamplesToDo > 0);
+    static_assert(MaxAmbiChannels <= MaxMatrixInputs, "Too many inputs for matrix mixing");
+
+    std::array<float*,MAX_OUTPUT_CHANNELS> outputs;
+    std::transform(OutBuffer.begin(), OutBuffer.end(), outputs.begin(),
+        [](FloatBufferLine &line) noexcept { return line.data(); });
+    const al::span<float*const> output{outputs.data(), OutBuffer.size()};
 
     if(mDualBand)
     {
-        const al::span<float> hfSamples{mSamples[sHFBand].data(), SamplesToDo};
-        const al::span<float> lfSamples{mSamples[sLFBand].data(), SamplesToDo};
-        for(auto &chandec : mChannelDec)
+        /* Split the channels a bank at a time. If there are fewer channels
+         * than lanes left, the first channel fills the unused lanes, and its
+         * duplicated results are ignored.
+         */
+        constexpr size_t NumLanes{BandSplitterBank::NumLanes};
+        BandSplitterBank splitters;
+        for(size_t base{0};base < mChannelDec.size();base += NumLanes)
         {
-            chandec.mXOver.process({InSamples->data(), SamplesToDo}, hfSamples.data(),
-                lfSamples.data());
-            MixSamples(hfSamples, OutBuffer, chandec.mGains.Dual[sHFBand],
-                chandec.mGains.Dual[sHFBand], 0, 0);
-            MixSamples(lfSamples, OutBuffer, chandec.mGains.Dual[sLFBand],
-                chandec.mGains.Dual[sLFBand], 0, 0);
-            ++InSamples;
+            const size_t numchans{minz(mChannelDec.size()-base, NumLanes)};
+
+            std::array<const float*,NumLanes> input;
+            std::array<float*,NumLanes> hfout, lfout;
+            for(size_t j{0};j < NumLanes;++j)
+            {
+                const size_t chan{base + ((j < numchans) ? j : 0)};
+                splitters.load(j, mChannelDec[chan].mXOver);
+                input[j] = InSamples[chan].data();
+                hfout[j] = mSamples[sHFBand][j].data();
+                lfout[j] = mSamples[sLFBand][j].data();
+            }
+            splitters.process(input, hfout, lfout, SamplesToDo);
+
+            /* Decode the bands together, ordered the same as the matrix. */
+            std::array<const float*,NumLanes*sNumBands> bands;
+            for(size_t j{0};j < numchans;++j)
+            {
+                splitters.store(j, mChannelDec[base+j].mXOver);
+                bands[j*sNumBands + sHFBand] = hfout[j];
+                bands[j*sNumBands + sLFBand] = lfout[j];
+            }
+            MixMatrix({bands.data(), numchans*sNumBands}, output,
+                mMatrix[0].data() + base*sNumBands, sMatrixStride, SamplesToDo);
         }
     }
     else
     {
-        for(auto &chandec : mChannelDec)
-        {
-            MixSamples({InSamples->data(), SamplesToDo}, OutBuffer, chandec.mGains.Single,
-                chandec.mGains.Single, 0, 0);
-            ++InSamples;
-        }
+        std::array<const float*,MaxAmbiChannels> inputs;
+        for(size_t j{0};j < mChannelDec.size();++j)
+            inputs[j] = InSamples[j].data();
+        MixMatrix({inputs.data(), mChannelDec.size()}, output, mMatrix[0].data(), sMatrixStride,
+            SamplesToDo);
     }
 }
 
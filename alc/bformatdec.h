@@ -24,16 +24,22 @@ class BFormatDec {
     static constexpr size_t sNumBands{2};
 
     struct ChannelDecoder {
-        union MatrixU {
-            float Dual[sNumBands][MAX_OUTPUT_CHANNELS];
-            float Single[MAX_OUTPUT_CHANNELS];
-        } mGains{};
-
         /* NOTE: BandSplitter filter is unused with single-band decoding. */
         BandSplitter mXOver;
     };
 
-    alignas(16) std::array<FloatBufferLine,2> mSamples;
+    /* The decoding matrix, holding a row of input channel gains for each
+     * output. With dual-band decoding, each input has a gain for each band,
+     * so the HF and LF gains alternate. Single-band decoding only uses the
+     * first MaxAmbiChannels gains of each row.
+     */
+    static constexpr size_t sMatrixStride{MaxAmbiChannels * sNumBands};
+    using MatrixRow = std::array<float,sMatrixStride>;
+    std::array<MatrixRow,MAX_OUTPUT_CHANNELS> mMatrix{};
+
+    /* Band-split samples for each lane of the splitter bank. */
+    using SplitterLines = std::array<FloatBufferLine,BandSplitterBank::NumLanes>;
+    alignas(16) std::array<SplitterLines,sNumBands> mSamples;
 
     const std::unique_ptr<FrontStablizer> mStablizer;
     const bool mDualBand{false};
@@ -33,6 +33,7 @@ uint ChannelsFromFmt(FmtChannels chans, uint ambiorder) noexcept
     case FmtX71: return 8;
     case FmtBFormat2D: return (ambiorder*2) + 1;
     case FmtBFormat3D: return (ambiorder+1) * (ambiorder+1);
+    case FmtUHJ2: return 2;
     }
     return 0;
 }
@@ -27,6 +27,7 @@ enum FmtChannels : unsigned char {
     FmtX71, /* (WFX order) */
     FmtBFormat2D,
     FmtBFormat3D,
+    FmtUHJ2, /* 2-channel UHJ, aka "BHJ", stereo-compatible */
 };
 
 enum class AmbiLayout : unsigned char {
@@ -44,6 +45,12 @@ uint ChannelsFromFmt(FmtChannels chans, uint ambiorder) noexcept;
 inline uint FrameSizeFromFmt(FmtChannels chans, FmtType type, uint ambiorder) noexcept
 { return ChannelsFromFmt(chans, ambiorder) * BytesFromFmt(type); }
 
+/* UHJ formats are decoded to (and mixed as) B-Format, so are also ambisonic. */
+inline bool IsAmbisonic(FmtChannels chans) noexcept
+{ return chans == FmtBFormat2D || chans == FmtBFormat3D || chans == FmtUHJ2; }
+inline bool Is2DAmbisonic(FmtChannels chans) noexcept
+{ return chans == FmtBFormat2D || chans == FmtUHJ2; }
+
 
 using CallbackType = int(*)(void*, void*, int);
 
@@ -172,6 +172,13 @@ struct EffectState : public al::intrusive_ref<EffectState> {
 
     al::span<FloatBufferLine> mOutTarget;
 
+    /* Set by an effect's process method when it would produce no more output
+     * given silent input (e.g. once a reverb tail has fully decayed). The mixer
+     * skips processing an idle effect while its input remains silent, and
+     * clears this before processing it again. Effects that never set it are
+     * always processed.
+     */
+    bool mIsIdle{false};
 
     virtual ~EffectState() = default;
 
@@ -17,13 +17,25 @@
 #include "bformatdec.h"
 #include "buffer_storage.h"
 #include "core/ambidefs.h"
+#include "core/cpu_caps.h"
 #include "core/filters/splitter.h"
 #include "core/fmt_traits.h"
 #include "core/logging.h"
+#include "core/mixer/defs.h"
+#include "core/uhjfilter.h"
 #include "effects/base.h"
 #include "effectslot.h"
 #include "math_defs.h"
 #include "polyphase_resampler.h"
+#include "vector.h"
+
+struct CTag;
+#ifdef HAVE_SSE
+struct SSETag;
+#endif
+#ifdef HAVE_NEON
+struct NEONTag;
+#endif
 
 
 namespace {
@@ -41,7 +53,9 @@ namespace {
  * To apply the reverberation, each impulse response segment is convolved with
  * its paired input segment (using complex multiplies, far cheaper than FIRs),
  * accumulating into a 256-bin FFT buffer. The input history is then shifted to
- * align with later impulse response segments for next time.
+ * align with later impulse response segments for next time. The segments are
+ * stored as single-precision floats with split real and imaginary components,
+ * so the multiply-accumulate can be vectorized.
  *
  * An inverse FFT is then applied to the accumulated FFT buffer to get a 256-
  * sample time-domain response for output, which is split in two halves. The
@@ -75,6 +89,42 @@ void LoadSamples(double *RESTRICT dst, const al::byte *src, const size_t srcstep
 #undef HANDLE_FMT
 }
 
+/* Decodes a 2-channel UHJ impulse response to first-order horizontal B-Format
+ * (W, X, and Y, with FuMa ordering and scaling), in-place. The samples array
+ * holds three consecutive channels of numSamples each, with the left and right
+ * input channels in the first two.
+ */
+void DecodeUhjSamples(double *samples, const size_t numSamples)
+{
+    using DecodeBufferLine = std::array<float,UhjDecoder::sMaxSamples+UhjDecoder::sFilterDelay>;
+
+    auto decoder = std::make_unique<UhjDecoder>();
+    al::vector<DecodeBufferLine,16> lines(3);
+    float *lineptrs[3]{lines[0].data(), lines[1].data(), lines[2].data()};
+
+    for(size_t pos{0};pos < numSamples;)
+    {
+        /* The decoder looks ahead of the samples being decoded, so load as
+         * much as is available and silence the rest.
+         */
+        const size_t todo{minz(numSamples-pos, UhjDecoder::sMaxSamples)};
+        const size_t toload{minz(numSamples-pos, todo+UhjDecoder::sFilterDelay)};
+        for(size_t c{0};c < 2;++c)
+        {
+            const double *src{samples + c*numSamples + pos};
+            auto iter = std::transform(src, src+toload, lines[c].begin(),
+                [](const double d) noexcept -> float { return static_cast<float>(d); });
+            std::fill(iter, lines[c].end(), 0.0f);
+        }
+
+        decoder->decode(lineptrs, todo, todo);
+
+        for(size_t c{0};c < 3;++c)
+            std::copy_n(lines[c].cbegin(), todo, samples + c*numSamples + pos);
+        pos += todo;
+    }
+}
+
 
 inline auto& GetAmbiScales(AmbiScaling scaletype) noexcept
 {
@@ -107,6 +157,30 @@ using complex_d = std::complex<double>;
 constexpr size_t ConvolveUpdateSize{256};
 constexpr size_t ConvolveUpdateSamples{ConvolveUpdateSize / 2};
 
+/* The number of frequency bins kept for each segment (DC, Nyquist, and the
+ * positive frequencies in between), padded to a multiple of 4 for SIMD. Each
+ * segment stores all its real components followed by the imaginary ones.
+ */
+constexpr size_t ConvolveBinCount{(ConvolveUpdateSize/2 + 1 + 3) & ~size_t{3}};
+constexpr size_t ConvolveSegmentSize{ConvolveBinCount * 2};
+
+
+using ComplexMacFunc = void(*)(float *RESTRICT Accum, const float *RESTRICT Input,
+    const float *RESTRICT Filter, const size_t Count);
+
+inline ComplexMacFunc SelectComplexMac()
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return ComplexMac_<NEONTag>;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return ComplexMac_<SSETag>;
+#endif
+    return ComplexMac_<CTag>;
+}
+
 
 void apply_fir(al::span<float> dst, const float *RESTRICT src, const float *RESTRICT filter)
 {
@@ -166,6 +240,7 @@ struct ConvolutionState final : public EffectState {
     al::vector<std::array<float,ConvolveUpdateSamples*2>,16> mOutput;
 
     alignas(16) std::array<complex_d,ConvolveUpdateSize> mFftBuffer{};
+    alignas(16) std::array<float,ConvolveSegmentSize> mFftAccum{};
 
     size_t mCurrentSegment{0};
     size_t mNumConvolveSegs{0};
@@ -179,7 +254,9 @@ struct ConvolutionState final : public EffectState {
     };
     using ChannelDataArray = al::FlexArray<ChannelData>;
     std::unique_ptr<ChannelDataArray> mChans;
-    std::unique_ptr<complex_d[]> mComplexData;
+    al::vector<float,16> mComplexData;
+
+    ComplexMacFunc mComplexMac{ComplexMac_<CTag>};
 
 
     ConvolutionState() = default;
@@ -210,39 +287,75 @@ void ConvolutionState::NormalMix(const al::span<FloatBufferLine> samplesOut,
 void ConvolutionState::UpsampleMix(const al::span<FloatBufferLine> samplesOut,
     const size_t samplesToDo)
 {
-    for(auto &chan : *mChans)
+    /* Filter the channels a bank at a time. If there are fewer channels than
+     * lanes left, the unused lanes repeat the first channel, writing back the
+     * same result for it.
+     */
+    constexpr size_t NumLanes{BandSplitterBank::NumLanes};
+    BandSplitterBank splitters;
+    auto &chans = *mChans;
+    for(size_t base{0};base < chans.size();base += NumLanes)
     {
-        const al::span<float> src{chan.mBuffer.data(), samplesToDo};
-        chan.mFilter.processHfScale(src, chan.mHfScale);
-        MixSamples(src, samplesOut, chan.Current, chan.Target, samplesToDo, 0);
+        const size_t numchans{minz(chans.size()-base, NumLanes)};
+
+        std::array<float*,NumLanes> samples;
+        BandSplitterBank::LaneArray hfscales;
+        for(size_t j{0};j < NumLanes;++j)
+        {
+            auto &chan = chans[base + ((j < numchans) ? j : 0)];
+            splitters.load(j, chan.mFilter);
+            samples[j] = chan.mBuffer.data();
+            hfscales[j] = chan.mHfScale;
+        }
+        splitters.processHfScale(samples, hfscales, samplesToDo);
+
+        for(size_t j{0};j < numchans;++j)
+        {
+            auto &chan = chans[base+j];
+            splitters.store(j, chan.mFilter);
+            MixSamples({samples[j], samplesToDo}, samplesOut, chan.Current, chan.Target,
+                samplesToDo, 0);
+        }
     }
 }
 
 
 void ConvolutionState::deviceUpdate(const ALCdevice *device, const Buffer &buffer)
 {
-    constexpr uint MaxConvolveAmbiOrder{1u};
-
     mFifoPos = 0;
     mInput.fill(0.0f);
     decltype(mFilter){}.swap(mFilter);
     decltype(mOutput){}.swap(mOutput);
     mFftBuffer.fill(complex_d{});
+    mFftAccum.fill(0.0f);
 
     mCurrentSegment = 0;
     mNumConvolveSegs = 0;
 
     mChans = nullptr;
-    mComplexData = nullptr;
+    decltype(mComplexData){}.swap(mComplexData);
+
+    mComplexMac = SelectComplexMac();
 
     /* An empty buffer doesn't need a convolution filter. */
     if(!buffer.storage || buffer.storage->mSampleLen < 1) return;
 
+    /* Ambisonic impulse responses are limited to the device's mixing order,
+     * since any higher-order channels couldn't be rendered. Each IR channel is
+     * convolved with the same input history, so the forward FFT on the input
+     * is only done once per segment regardless of the channel count.
+     */
+    const uint ambiOrder{minu(buffer.storage->mAmbiOrder, device->mAmbiOrder)};
+
+    /* 2-channel UHJ responses are decoded to first-order horizontal B-Format,
+     * the same as UHJ voices.
+     */
+    const bool isUhj{buffer.storage->mChannels == FmtUHJ2};
+
     constexpr size_t m{ConvolveUpdateSize/2 + 1};
     auto bytesPerSample = BytesFromFmt(buffer.storage->mType);
     auto realChannels = ChannelsFromFmt(buffer.storage->mChannels, buffer.storage->mAmbiOrder);
-    auto numChannels = ChannelsFromFmt(buffer.storage->mChannels,
-        minu(buffer.storage->mAmbiOrder, MaxConvolveAmbiOrder));
+    auto numChannels = isUhj ? size_t{3} : ChannelsFromFmt(buffer.storage->mChannels, ambiOrder);
 
     mChans = ChannelDataArray::Create(numChannels);
 
@@ -273,25 +386,52 @@ void ConvolutionState::deviceUpdate(const ALCdevice *device, const Buffer &buffe
     mNumConvolveSegs = (resampledCount+(ConvolveUpdateSamples-1)) / ConvolveUpdateSamples;
     mNumConvolveSegs = maxz(mNumConvolveSegs, 2) - 1;
 
-    const size_t complex_length{mNumConvolveSegs * m * (numChannels+1)};
-    mComplexData = std::make_unique<complex_d[]>(complex_length);
-    std::fill_n(mComplexData.get(), complex_length, complex_d{});
+    mComplexData.resize(mNumConvolveSegs * ConvolveSegmentSize * (numChannels+1), 0.0f);
 
-    mChannels = buffer.storage->mChannels;
-    mAmbiLayout = buffer.storage->mAmbiLayout;
-    mAmbiScaling = buffer.storage->mAmbiScaling;
-    mAmbiOrder = minu(buffer.storage->mAmbiOrder, MaxConvolveAmbiOrder);
+    if(isUhj)
+    {
+        mChannels = FmtBFormat2D;
+        mAmbiLayout = AmbiLayout::FuMa;
+        mAmbiScaling = AmbiScaling::FuMa;
+        mAmbiOrder = 1;
+    }
+    else
+    {
+        mChannels = buffer.storage->mChannels;
+        mAmbiLayout = buffer.storage->mAmbiLayout;
+        mAmbiScaling = buffer.storage->mAmbiScaling;
+        mAmbiOrder = ambiOrder;
+    }
 
     auto srcsamples = std::make_unique<double[]>(maxz(buffer.storage->mSampleLen, resampledCount));
-    complex_d *filteriter = mComplexData.get() + mNumConvolveSegs*m;
-    for(size_t c{0};c < numChannels;++c)
+    auto load_samples = [&](double *dst, const size_t c) -> void
     {
         /* Load the samples from the buffer, and resample to match the device. */
-        LoadSamples(srcsamples.get(), buffer.samples.data() + bytesPerSample*c, realChannels,
+        LoadSamples(dst, buffer.samples.data() + bytesPerSample*c, realChannels,
             buffer.storage->mType, buffer.storage->mSampleLen);
         if(device->Frequency != buffer.storage->mSampleRate)
-            resampler.process(buffer.storage->mSampleLen, srcsamples.get(), resampledCount,
-                srcsamples.get());
+            resampler.process(buffer.storage->mSampleLen, dst, resampledCount, dst);
+    };
+
+    std::unique_ptr<double[]> uhjsamples;
+    if(isUhj)
+    {
+        uhjsamples = std::make_unique<double[]>(resampledCount * 3);
+        for(size_t c{0};c < 2;++c)
+        {
+            load_samples(srcsamples.get(), c);
+            std::copy_n(srcsamples.get(), resampledCount, uhjsamples.get() + c*resampledCount);
+        }
+        DecodeUhjSamples(uhjsamples.get(), resampledCount);
+    }
+
+    float *filteriter = mComplexData.data() + mNumConvolveSegs*ConvolveSegmentSize;
+    for(size_t c{0};c < numChannels;++c)
+    {
+        if(uhjsamples)
+            std::copy_n(uhjsamples.get() + c*resampledCount, resampledCount, srcsamples.get());
+        else
+            load_samples(srcsamples.get(), c);
 
         /* Store the first segment's samples in reverse in the time-domain, to
          * apply as a FIR filter.
@@ -310,7 +450,12 @@ void ConvolutionState::deviceUpdate(const ALCdevice *device, const Buffer &buffe
             std::fill(iter, mFftBuffer.end(), complex_d{});
 
             forward_fft(mFftBuffer);
-            filteriter = std::copy_n(mFftBuffer.cbegin(), m, filteriter);
+            for(size_t i{0};i < m;++i)
+            {
+                filteriter[i] = static_cast<float>(mFftBuffer[i].real());
+                filteriter[ConvolveBinCount+i] = static_cast<float>(mFftBuffer[i].imag());
+            }
+            filteriter += ConvolveSegmentSize;
         }
     }
 }
@@ -380,10 +525,12 @@ void ConvolutionState::update(const ALCcontext *context, const EffectSlot *slot,
         if(device->mAmbiOrder > mAmbiOrder)
         {
             mMix = &ConvolutionState::UpsampleMix;
+            const uint8_t *OrderFromChan{(mChannels == FmtBFormat2D) ?
+                AmbiIndex::OrderFrom2DChannel().data() :
+                AmbiIndex::OrderFromChannel().data()};
             const auto scales = BFormatDec::GetHFOrderScales(mAmbiOrder, device->mAmbiOrder);
-            (*mChans)[0].mHfScale = scales[0];
-            for(size_t i{1};i < mChans->size();++i)
-                (*mChans)[i].mHfScale = scales[1];
+            for(auto &chan : *mChans)
+                chan.mHfScale = scales[*(OrderFromChan++)];
         }
         mOutTarget = target.Main->Buffer;
 
@@ -416,6 +563,7 @@ void ConvolutionState::update(const ALCcontext *context, const EffectSlot *slot,
         case FmtX71: chanmap = X71Map; break;
         case FmtBFormat2D:
         case FmtBFormat3D:
+        case FmtUHJ2:
             break;
         }
 
@@ -494,32 +642,41 @@ void ConvolutionState::process(const size_t samplesToDo,
         std::fill(fftiter, mFftBuffer.end(), complex_d{});
         forward_fft(mFftBuffer);
 
-        std::copy_n(mFftBuffer.cbegin(), m, &mComplexData[curseg*m]);
+        float *RESTRICT newseg{&mComplexData[curseg*ConvolveSegmentSize]};
+        for(size_t i{0};i < m;++i)
+        {
+            newseg[i] = static_cast<float>(mFftBuffer[i].real());
+            newseg[ConvolveBinCount+i] = static_cast<float>(mFftBuffer[i].imag());
+        }
 
-        const complex_d *RESTRICT filter{mComplexData.get() + mNumConvolveSegs*m};
+        const float *RESTRICT filter{mComplexData.data() + mNumConvolveSegs*ConvolveSegmentSize};
         for(size_t c{0};c < chans.size();++c)
         {
-            std::fill_n(mFftBuffer.begin(), m, complex_d{});
+            mFftAccum.fill(0.0f);
 
             /* Convolve each input segment with its IR filter counterpart
              * (aligned in time).
              */
-            const complex_d *RESTRICT input{&mComplexData[curseg*m]};
+            const float *RESTRICT input{&mComplexData[curseg*ConvolveSegmentSize]};
             for(size_t s{curseg};s < mNumConvolveSegs;++s)
             {
-                for(size_t i{0};i < m;++i,++input,++filter)
-                    mFftBuffer[i] += *input * *filter;
+                mComplexMac(mFftAccum.data(), input, filter, ConvolveBinCount);
+                input += ConvolveSegmentSize;
+                filter += ConvolveSegmentSize;
             }
-            input = mComplexData.get();
+            input = mComplexData.data();
             for(size_t s{0};s < curseg;++s)
             {
-                for(size_t i{0};i < m;++i,++input,++filter)
-                    mFftBuffer[i] += *input * *filter;
+                mComplexMac(mFftAccum.data(), input, filter, ConvolveBinCount);
+                input += ConvolveSegmentSize;
+                filter += ConvolveSegmentSize;
             }
 
             /* Reconstruct the mirrored/negative frequencies to do a proper
              * inverse FFT.
              */
+            for(size_t i{0};i < m;++i)
+                mFftBuffer[i] = complex_d{mFftAccum[i], mFftAccum[ConvolveBinCount+i]};
             for(size_t i{m};i < ConvolveUpdateSize;++i)
                 mFftBuffer[i] = std::conj(mFftBuffer[ConvolveUpdateSize-i]);
 
@@ -24,6 +24,7 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 
 #include "alcmain.h"
@@ -77,6 +78,11 @@ namespace {
  * http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt                   */
 
 
+/* The four bands are applied in series, with multiple channels processed at
+ * once.
+ */
+using FilterBank = BiquadBank<4>;
+
 struct EqualizerState final : public EffectState {
     struct {
         /* Effect parameters */
@@ -87,7 +93,7 @@ struct EqualizerState final : public EffectState {
         float TargetGains[MAX_OUTPUT_CHANNELS]{};
     } mChans[MaxAmbiChannels];
 
-    FloatBufferLine mSampleBuffer{};
+    alignas(16) std::array<FloatBufferLine,FilterBank::NumLanes> mSampleBuffer{};
 
 
     void deviceUpdate(const ALCdevice *device, const Buffer &buffer) override;
@@ -156,16 +162,36 @@ void EqualizerState::update(const ALCcontext *context, const EffectSlot *slot,
 
 void EqualizerState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
-    const al::span<float> buffer{mSampleBuffer.data(), samplesToDo};
-    auto chan = std::addressof(mChans[0]);
-    for(const auto &input : samplesIn)
+    constexpr size_t NumLanes{FilterBank::NumLanes};
+    for(size_t base{0u};base < samplesIn.size();base += NumLanes)
     {
-        const al::span<const float> inbuf{input.data(), samplesToDo};
-        DualBiquad{chan->filter[0], chan->filter[1]}.process(inbuf, buffer.begin());
-        DualBiquad{chan->filter[2], chan->filter[3]}.process(buffer, buffer.begin());
-
-        MixSamples(buffer, samplesOut, chan->CurrentGains, chan->TargetGains, samplesToDo, 0u);
-        ++chan;
+        const size_t numchans{minz(samplesIn.size()-base, NumLanes)};
+
+        /* Any unused lanes just filter the first channel again, with the
+         * result going unused.
+         */
+        FilterBank bank;
+        std::array<const float*,NumLanes> src;
+        std::array<float*,NumLanes> dst;
+        for(size_t j{0u};j < NumLanes;++j)
+        {
+            const size_t c{base + ((j < numchans) ? j : 0u)};
+            for(size_t f{0u};f < 4;++f)
+                bank.load(j, f, mChans[c].filter[f]);
+            src[j] = samplesIn[c].data();
+            dst[j] = mSampleBuffer[j].data();
+        }
+        bank.process(src, dst, samplesToDo);
+
+        for(size_t j{0u};j < numchans;++j)
+        {
+            auto &chan = mChans[base+j];
+            for(size_t f{0u};f < 4;++f)
+                bank.store(j, f, chan.filter[f]);
+
+            MixSamples({mSampleBuffer[j].data(), samplesToDo}, samplesOut, chan.CurrentGains,
+                chan.TargetGains, samplesToDo, 0u);
+        }
     }
 }
 
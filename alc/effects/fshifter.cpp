@@ -28,8 +28,11 @@
 
 #include "alcmain.h"
 #include "alcomplex.h"
+#include "alconfig.h"
 #include "alcontext.h"
+#include "alstring.h"
 #include "alu.h"
+#include "core/logging.h"
 #include "effectslot.h"
 #include "math_defs.h"
 
@@ -60,7 +63,95 @@ std::array<double,HIL_SIZE> InitHannWindow()
 alignas(16) const std::array<double,HIL_SIZE> HannWindow = InitHannWindow();
 
 
+/* The streaming Hilbert transform uses a pair of allpass chains (a phase-
+ * splitter), whose outputs maintain a 90 degree phase difference over most of
+ * the spectrum. The coefficients are derived from an elliptic polyphase half-
+ * band filter design (as described by Laurent de Soras for HIIR), frequency-
+ * shifted by fs/4, with the coefficients alternating between the two chains.
+ * The transition width sets the lowest (and highest) frequency for which the
+ * phase difference holds, while more stages increase the accuracy.
+ */
+constexpr size_t MinIirStages{4};
+constexpr size_t MaxIirStages{20};
+constexpr size_t DefaultIirStages{12};
+constexpr double IirLowFrequency{20.0};
+
+void CalcPhaseSplitterCoeffs(const al::span<float> coeffs, const double transition)
+{
+    constexpr double Pi{al::MathDefs<double>::Pi()};
+
+    double k{std::tan((1.0 - transition*2.0) * (Pi/4.0))};
+    k *= k;
+    const double kksqrt{std::pow(1.0 - k*k, 0.25)};
+    const double e{0.5 * (1.0 - kksqrt) / (1.0 + kksqrt)};
+    const double e4{e*e*e*e};
+    const double q{e * (1.0 + e4*(2.0 + e4*(15.0 + 150.0*e4)))};
+
+    const double order{static_cast<double>(coeffs.size()*2 + 1)};
+    for(size_t idx{0};idx < coeffs.size();++idx)
+    {
+        const double c{static_cast<double>(idx+1)};
+
+        double num{0.0}, sign{1.0};
+        for(int i{0};;++i)
+        {
+            const double term{std::pow(q, i*(i+1)) * std::sin((i*2+1)*c*Pi/order) * sign};
+            num += term;
+            sign = -sign;
+            if(!(std::abs(term) > 1e-100)) break;
+        }
+        num *= std::pow(q, 0.25);
+
+        double den{0.5};
+        sign = -1.0;
+        for(int i{1};;++i)
+        {
+            const double term{std::pow(q, i*i) * std::cos(i*2*c*Pi/order) * sign};
+            den += term;
+            sign = -sign;
+            if(!(std::abs(term) > 1e-100)) break;
+        }
+
+        const double wwsq{(num/den) * (num/den)};
+        const double x{std::sqrt((1.0 - wwsq*k) * (1.0 - wwsq/k)) / (1.0 + wwsq)};
+        coeffs[idx] = static_cast<float>((1.0 - x) / (1.0 + x));
+    }
+}
+
+/* An allpass section in z^-2, H(z) = (c - z^-2) / (1 - c*z^-2). */
+struct AllpassStage {
+    float mCoeff{};
+    float mX[2]{};
+    float mY[2]{};
+
+    void process(const al::span<float> samples)
+    {
+        const float coeff{mCoeff};
+        float x1{mX[0]}, x2{mX[1]};
+        float y1{mY[0]}, y2{mY[1]};
+        for(float &sample : samples)
+        {
+            const float x{sample};
+            const float y{coeff*(x + y2) - x2};
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+            sample = y;
+        }
+        mX[0] = x1; mX[1] = x2;
+        mY[0] = y1; mY[1] = y2;
+    }
+};
+
+
 struct FshifterState final : public EffectState {
+    /* Use the streaming allpass Hilbert transform instead of the FFT. */
+    bool mUseIir{false};
+    size_t mNumIirStages{};
+    AllpassStage mIirReal[MaxIirStages/2];
+    AllpassStage mIirImag[MaxIirStages/2];
+    float mIirLastSample{};
+    alignas(16) float mIirBuffer[2][BufferLineSize]{};
+
     /* Effect parameters */
     size_t mCount{};
     size_t mPos{};
@@ -84,6 +175,9 @@ struct FshifterState final : public EffectState {
     } mGains[2];
 
 
+    void processFft(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn);
+    void processIir(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn);
+
     void deviceUpdate(const ALCdevice *device, const Buffer &buffer) override;
     void update(const ALCcontext *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
@@ -93,8 +187,36 @@ struct FshifterState final : public EffectState {
     DEF_NEWDEL(FshifterState)
 };
 
-void FshifterState::deviceUpdate(const ALCdevice*, const Buffer&)
+void FshifterState::deviceUpdate(const ALCdevice *device, const Buffer&)
 {
+    const char *devname{device->DeviceName.c_str()};
+
+    mUseIir = false;
+    if(auto hilbertopt = ConfigValueStr(devname, "fshifter", "hilbert"))
+    {
+        if(al::strcasecmp(hilbertopt->c_str(), "iir") == 0)
+            mUseIir = true;
+        else if(al::strcasecmp(hilbertopt->c_str(), "fft") != 0)
+            ERR("Invalid frequency shifter Hilbert transform: %s\n", hilbertopt->c_str());
+    }
+
+    /* The stages are split evenly between the two allpass chains. */
+    size_t numstages{ConfigValueUInt(devname, "fshifter", "iir-stages").value_or(DefaultIirStages)};
+    numstages = clampz(numstages, MinIirStages, MaxIirStages) & ~size_t{1};
+    mNumIirStages = numstages / 2;
+
+    std::array<float,MaxIirStages> coeffs{};
+    CalcPhaseSplitterCoeffs({coeffs.data(), numstages},
+        IirLowFrequency / static_cast<double>(device->Frequency));
+    for(size_t i{0};i < mNumIirStages;++i)
+    {
+        mIirReal[i] = AllpassStage{};
+        mIirReal[i].mCoeff = coeffs[i*2];
+        mIirImag[i] = AllpassStage{};
+        mIirImag[i].mCoeff = coeffs[i*2 + 1];
+    }
+    mIirLastSample = 0.0f;
+
     /* (Re-)initializing parameters and clear the buffers. */
     mCount = 0;
     mPos = FIFO_LATENCY;
@@ -158,7 +280,8 @@ void FshifterState::update(const ALCcontext *context, const EffectSlot *slot,
     ComputePanGains(target.Main, rcoeffs.data(), slot->Gain, mGains[1].Target);
 }
 
-void FshifterState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+void FshifterState::processFft(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn)
 {
     for(size_t base{0u};base < samplesToDo;)
     {
@@ -198,6 +321,46 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         std::copy_n(mOutputAccum + mPos, HIL_STEP, mOutFIFO);
         std::fill_n(mOutputAccum + mPos, HIL_STEP, complex_d{});
     }
+}
+
+void FshifterState::processIir(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn)
+{
+    /* The imaginary chain takes the input delayed by one sample, which gives
+     * it a -90 degree phase relative to the real chain (the Hilbert transform
+     * of the real output).
+     */
+    const al::span<float> realbuf{mIirBuffer[0], samplesToDo};
+    const al::span<float> imagbuf{mIirBuffer[1], samplesToDo};
+    float lastsample{mIirLastSample};
+    for(size_t i{0};i < samplesToDo;++i)
+    {
+        realbuf[i] = samplesIn[0][i];
+        imagbuf[i] = lastsample;
+        lastsample = samplesIn[0][i];
+    }
+    mIirLastSample = lastsample;
+
+    for(size_t i{0};i < mNumIirStages;++i)
+    {
+        mIirReal[i].process(realbuf);
+        mIirImag[i].process(imagbuf);
+    }
+
+    /* The FFT-based transform produces the conjugate of the analytic signal,
+     * with an overall gain of 0.75 from its windowing. Match both so the
+     * shift direction and output level don't depend on the method.
+     */
+    for(size_t i{0};i < samplesToDo;++i)
+        mOutdata[i] = complex_d{realbuf[i]*0.75, imagbuf[i]*-0.75};
+}
+
+void FshifterState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+{
+    if(mUseIir)
+        processIir(samplesToDo, samplesIn);
+    else
+        processFft(samplesToDo, samplesIn);
 
     /* Process frequency shifter using the analytic signal obtained. */
     float *RESTRICT BufferOut{mBufferOut};
@@ -20,6 +20,10 @@
 
 #include "config.h"
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 #include <cmath>
 #include <cstdlib>
 #include <array>
@@ -28,44 +32,133 @@
 
 #include "alcmain.h"
 #include "alcomplex.h"
+#include "alconfig.h"
 #include "alcontext.h"
 #include "alnumeric.h"
+#include "alstring.h"
 #include "alu.h"
+#include "core/logging.h"
 #include "effectslot.h"
 #include "math_defs.h"
 
 
 namespace {
 
-using complex_d = std::complex<double>;
+using complex_f = std::complex<float>;
 
-#define STFT_SIZE      1024
-#define STFT_HALF_SIZE (STFT_SIZE>>1)
-#define OVERSAMP       (1<<2)
+constexpr size_t StftSize{1024};
+constexpr size_t StftHalfSize{StftSize >> 1};
+/* The number of non-mirrored frequency bins, padded to a multiple of 4 for the
+ * vectorized phase analysis and synthesis.
+ */
+constexpr size_t StftBins{StftHalfSize + 1};
+constexpr size_t StftPaddedBins{(StftBins+3) & ~size_t{3}};
 
-#define STFT_STEP    (STFT_SIZE / OVERSAMP)
-#define FIFO_LATENCY (STFT_STEP * (OVERSAMP-1))
+/* The overlap (number of STFT frames covering each sample) for each quality
+ * mode. High quality uses a 4x overlap with Hann windowing for both analysis
+ * and synthesis. Low quality uses a 2x overlap, and skips the synthesis window
+ * since the overlapped Hann analysis window already sums to unity.
+ */
+constexpr size_t HighQualityOversamp{4};
+constexpr size_t LowQualityOversamp{2};
 
 /* Define a Hann window, used to filter the STFT input and output. */
-std::array<double,STFT_SIZE> InitHannWindow()
+std::array<float,StftSize> InitHannWindow()
 {
-    std::array<double,STFT_SIZE> ret;
-    /* Create lookup table of the Hann window for the desired size, i.e. STFT_SIZE */
-    for(size_t i{0};i < STFT_SIZE>>1;i++)
+    std::array<float,StftSize> ret;
+    /* Create lookup table of the Hann window for the desired size, i.e. StftSize */
+    for(size_t i{0};i < StftSize>>1;i++)
     {
-        constexpr double scale{al::MathDefs<double>::Pi() / double{STFT_SIZE}};
+        constexpr double scale{al::MathDefs<double>::Pi() / double{StftSize}};
         const double val{std::sin(static_cast<double>(i+1) * scale)};
-        ret[i] = ret[STFT_SIZE-1-i] = val * val;
+        ret[i] = ret[StftSize-1-i] = static_cast<float>(val * val);
     }
     return ret;
 }
-alignas(16) const std::array<double,STFT_SIZE> HannWindow = InitHannWindow();
+alignas(16) const std::array<float,StftSize> HannWindow = InitHannWindow();
 
 
-struct FrequencyBin {
-    double Amplitude;
-    double FreqBin;
-};
+/* Fast approximations for the phase vocoder. These are accurate to around
+ * 1e-5 radians, which is well below what matters for the STFT bins, and
+ * avoid the libm calls that prevent vectorizing the per-bin processing.
+ */
+constexpr float PiF{al::MathDefs<float>::Pi()};
+constexpr float TauF{al::MathDefs<float>::Tau()};
+
+/* Wraps a phase value to the -pi...+pi range. */
+inline float wrap_phase(float phase) noexcept
+{ return phase - TauF*fast_roundf(phase * (1.0f/TauF)); }
+
+inline float fast_atan2(float y, float x) noexcept
+{
+    const float ax{std::abs(x)}, ay{std::abs(y)};
+    const float a{minf(ax, ay) / maxf(maxf(ax, ay), 1e-30f)};
+    const float s{a * a};
+    float r{((-0.0464964749f*s + 0.15931422f)*s - 0.327622764f)*s*a + a};
+    if(ay > ax) r = PiF*0.5f - r;
+    if(x < 0.0f) r = PiF - r;
+    return std::copysign(r, y);
+}
+
+/* Sine of an angle in the -pi/2...+pi/2 range. */
+inline float fast_sin_half(float x) noexcept
+{
+    const float s{x * x};
+    return x * (1.0f + s*(-1.0f/6.0f + s*(1.0f/120.0f + s*(-1.0f/5040.0f +
+        s*(1.0f/362880.0f)))));
+}
+
+/* Calculates the cosine and sine of an angle in the -pi...+pi range. */
+inline complex_f fast_polar(float mag, float phase) noexcept
+{
+    /* cos(x) = sin(pi/2 - |x|), and sin(x) = sin(+-pi - x) for |x| > pi/2. */
+    const float c{fast_sin_half(PiF*0.5f - std::abs(phase))};
+    const float sx{(std::abs(phase) > PiF*0.5f) ? (std::copysign(PiF, phase) - phase) : phase};
+    return complex_f{mag * c, mag * fast_sin_half(sx)};
+}
+
+#ifdef HAVE_SSE_INTRINSICS
+
+inline __m128 wrap_phase4(__m128 phase) noexcept
+{
+    const __m128 tau4{_mm_set1_ps(TauF)};
+    const __m128 cycles4{_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(phase,
+        _mm_set1_ps(1.0f/TauF))))};
+    return _mm_sub_ps(phase, _mm_mul_ps(tau4, cycles4));
+}
+
+inline __m128 fast_atan2_4(__m128 y, __m128 x) noexcept
+{
+    const __m128 signmask4{_mm_set1_ps(-0.0f)};
+    const __m128 ax{_mm_andnot_ps(signmask4, x)};
+    const __m128 ay{_mm_andnot_ps(signmask4, y)};
+    const __m128 a{_mm_div_ps(_mm_min_ps(ax, ay),
+        _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(1e-30f)))};
+    const __m128 s{_mm_mul_ps(a, a)};
+    __m128 r{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.0464964749f), s), _mm_set1_ps(0.15931422f))};
+    r = _mm_sub_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.327622764f));
+    r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+
+    __m128 mask{_mm_cmpgt_ps(ay, ax)};
+    r = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(PiF*0.5f), r)),
+        _mm_andnot_ps(mask, r));
+    mask = _mm_cmplt_ps(x, _mm_setzero_ps());
+    r = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(PiF), r)), _mm_andnot_ps(mask, r));
+    return _mm_or_ps(r, _mm_and_ps(signmask4, y));
+}
+
+inline __m128 fast_sin_half4(__m128 x) noexcept
+{
+    const __m128 s{_mm_mul_ps(x, x)};
+    __m128 r{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.0f/362880.0f), s),
+        _mm_set1_ps(-1.0f/5040.0f))};
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(1.0f/120.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-1.0f/6.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(r, x);
+}
+
+#endif
 
 
 struct PshifterState final : public EffectState {
@@ -73,18 +166,28 @@ struct PshifterState final : public EffectState {
     size_t mCount;
     size_t mPos;
     uint mPitchShiftI;
-    double mPitchShift;
+    float mPitchShift;
+
+    /* Quality-dependent STFT parameters */
+    size_t mOversamp;
+    size_t mStep;
+    float mExpectedCycles;
+    float mOutputScale;
 
     /* Effects buffers */
-    std::array<double,STFT_SIZE> mFIFO;
-    std::array<double,STFT_HALF_SIZE+1> mLastPhase;
-    std::array<double,STFT_HALF_SIZE+1> mSumPhase;
-    std::array<double,STFT_SIZE> mOutputAccum;
+    alignas(16) std::array<float,StftSize> mFIFO;
+    alignas(16) std::array<float,StftPaddedBins> mLastPhase;
+    alignas(16) std::array<float,StftPaddedBins> mSumPhase;
+    alignas(16) std::array<float,StftSize> mOutputAccum;
 
-    std::array<complex_d,STFT_SIZE> mFftBuffer;
+    alignas(16) std::array<float,StftSize> mFftSamples;
+    alignas(16) std::array<complex_f,StftPaddedBins> mFftBuffer;
 
-    std::array<FrequencyBin,STFT_HALF_SIZE+1> mAnalysisBuffer;
-    std::array<FrequencyBin,STFT_HALF_SIZE+1> mSynthesisBuffer;
+    /* Analysis and synthesis bins, with separate amplitudes and frequencies. */
+    alignas(16) std::array<float,StftPaddedBins> mAnalysisAmp;
+    alignas(16) std::array<float,StftPaddedBins> mAnalysisFreq;
+    alignas(16) std::array<float,StftPaddedBins> mSynthesisAmp;
+    alignas(16) std::array<float,StftPaddedBins> mSynthesisFreq;
 
     alignas(16) FloatBufferLine mBufferOut;
 
@@ -93,6 +196,9 @@ struct PshifterState final : public EffectState {
     float mTargetGains[MAX_OUTPUT_CHANNELS];
 
 
+    void analyzeBins();
+    void synthesizeBins();
+
     void deviceUpdate(const ALCdevice *device, const Buffer &buffer) override;
     void update(const ALCcontext *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
@@ -102,21 +208,154 @@ struct PshifterState final : public EffectState {
     DEF_NEWDEL(PshifterState)
 };
 
-void PshifterState::deviceUpdate(const ALCdevice*, const Buffer&)
+/* Converts the FFT'd bins to amplitudes and true frequencies (in bins), given
+ * the phase difference from the last analysis frame.
+ */
+void PshifterState::analyzeBins()
+{
+    const size_t phasemask{mOversamp - 1};
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 expected4{_mm_set1_ps(mExpectedCycles)};
+    const __m128 invexpected4{_mm_set1_ps(1.0f / mExpectedCycles)};
+    for(size_t k{0u};k < StftPaddedBins;k+=4)
+    {
+        const __m128 lo{_mm_load_ps(reinterpret_cast<const float*>(&mFftBuffer[k]))};
+        const __m128 hi{_mm_load_ps(reinterpret_cast<const float*>(&mFftBuffer[k+2]))};
+        const __m128 re4{_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))};
+        const __m128 im4{_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))};
+
+        const __m128 amp4{_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re4, re4), _mm_mul_ps(im4, im4)))};
+        const __m128 phase4{fast_atan2_4(im4, re4)};
+
+        /* Compute phase difference and subtract expected phase difference.
+         * The expected difference for bin k is k*expected_cycles, which is
+         * equivalent to (k%oversamp)*expected_cycles after wrapping.
+         */
+        const __m128 k4{_mm_setr_ps(static_cast<float>(k), static_cast<float>(k+1),
+            static_cast<float>(k+2), static_cast<float>(k+3))};
+        const __m128 kmod4{_mm_setr_ps(static_cast<float>(k&phasemask),
+            static_cast<float>((k+1)&phasemask), static_cast<float>((k+2)&phasemask),
+            static_cast<float>((k+3)&phasemask))};
+        __m128 tmp{_mm_sub_ps(_mm_sub_ps(phase4, _mm_load_ps(&mLastPhase[k])),
+            _mm_mul_ps(kmod4, expected4))};
+        tmp = wrap_phase4(tmp);
+
+        _mm_store_ps(&mAnalysisAmp[k], amp4);
+        _mm_store_ps(&mAnalysisFreq[k], _mm_add_ps(k4, _mm_mul_ps(tmp, invexpected4)));
+        _mm_store_ps(&mLastPhase[k], phase4);
+    }
+#else
+    const float invexpected{1.0f / mExpectedCycles};
+    for(size_t k{0u};k < StftPaddedBins;k++)
+    {
+        const float re{mFftBuffer[k].real()}, im{mFftBuffer[k].imag()};
+        const float amplitude{std::sqrt(re*re + im*im)};
+        const float phase{fast_atan2(im, re)};
+
+        /* Compute phase difference and subtract expected phase difference.
+         * The expected difference for bin k is k*expected_cycles, which is
+         * equivalent to (k%oversamp)*expected_cycles after wrapping.
+         */
+        float tmp{(phase - mLastPhase[k]) -
+            static_cast<float>(k&phasemask)*mExpectedCycles};
+
+        /* Map delta phase into +/- Pi interval */
+        tmp = wrap_phase(tmp);
+
+        /* Compute the k-th partials' true frequency and store the amplitude
+         * and frequency bin in the analysis buffer.
+         */
+        mAnalysisAmp[k] = amplitude;
+        mAnalysisFreq[k] = static_cast<float>(k) + tmp*invexpected;
+
+        /* Store the actual phase[k] for the next frame. */
+        mLastPhase[k] = phase;
+    }
+#endif
+}
+
+/* Accumulates the synthesis bins' phase, and converts them back to complex
+ * FFT bins.
+ */
+void PshifterState::synthesizeBins()
+{
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 expected4{_mm_set1_ps(mExpectedCycles)};
+    const __m128 signmask4{_mm_set1_ps(-0.0f)};
+    const __m128 halfpi4{_mm_set1_ps(PiF*0.5f)};
+    for(size_t k{0u};k < StftPaddedBins;k+=4)
+    {
+        /* Calculate actual delta phase and accumulate it to get bin phase. The
+         * accumulated phase is kept wrapped to maintain precision.
+         */
+        __m128 phase4{_mm_add_ps(_mm_load_ps(&mSumPhase[k]),
+            _mm_mul_ps(_mm_load_ps(&mSynthesisFreq[k]), expected4))};
+        phase4 = wrap_phase4(phase4);
+        _mm_store_ps(&mSumPhase[k], phase4);
+
+        /* cos(x) = sin(pi/2 - |x|), and sin(x) = sin(+-pi - x) for |x| > pi/2. */
+        const __m128 absphase4{_mm_andnot_ps(signmask4, phase4)};
+        const __m128 cos4{fast_sin_half4(_mm_sub_ps(halfpi4, absphase4))};
+        const __m128 mask{_mm_cmpgt_ps(absphase4, halfpi4)};
+        const __m128 flipped4{_mm_sub_ps(_mm_or_ps(_mm_set1_ps(PiF),
+            _mm_and_ps(signmask4, phase4)), phase4)};
+        const __m128 sin4{fast_sin_half4(_mm_or_ps(_mm_and_ps(mask, flipped4),
+            _mm_andnot_ps(mask, phase4)))};
+
+        const __m128 amp4{_mm_load_ps(&mSynthesisAmp[k])};
+        const __m128 re4{_mm_mul_ps(amp4, cos4)};
+        const __m128 im4{_mm_mul_ps(amp4, sin4)};
+        _mm_store_ps(reinterpret_cast<float*>(&mFftBuffer[k]), _mm_unpacklo_ps(re4, im4));
+        _mm_store_ps(reinterpret_cast<float*>(&mFftBuffer[k+2]), _mm_unpackhi_ps(re4, im4));
+    }
+#else
+    for(size_t k{0u};k < StftPaddedBins;k++)
+    {
+        /* Calculate actual delta phase and accumulate it to get bin phase. The
+         * accumulated phase is kept wrapped to maintain precision.
+         */
+        mSumPhase[k] = wrap_phase(mSumPhase[k] + mSynthesisFreq[k]*mExpectedCycles);
+
+        mFftBuffer[k] = fast_polar(mSynthesisAmp[k], mSumPhase[k]);
+    }
+#endif
+}
+
+
+void PshifterState::deviceUpdate(const ALCdevice *device, const Buffer&)
 {
+    mOversamp = HighQualityOversamp;
+    if(auto qualopt = ConfigValueStr(device->DeviceName.c_str(), "pshifter", "quality"))
+    {
+        if(al::strcasecmp(qualopt->c_str(), "low") == 0)
+            mOversamp = LowQualityOversamp;
+        else if(al::strcasecmp(qualopt->c_str(), "high") != 0)
+            ERR("Invalid pitch shifter quality: %s\n", qualopt->c_str());
+    }
+    mStep = StftSize / mOversamp;
+    mExpectedCycles = TauF / static_cast<float>(mOversamp);
+    /* Hann-windowed analysis and synthesis with a 4x overlap results in a
+     * gain of 1.5, while a Hann-windowed analysis alone with a 2x overlap has
+     * unity gain. Keep the output level the same for either mode.
+     */
+    mOutputScale = ((mOversamp == HighQualityOversamp) ? 1.0f : 1.5f) / float{StftSize};
+
     /* (Re-)initializing parameters and clear the buffers. */
     mCount       = 0;
-    mPos         = FIFO_LATENCY;
+    mPos         = mStep * (mOversamp-1);
     mPitchShiftI = MixerFracOne;
-    mPitchShift  = 1.0;
-
-    std::fill(mFIFO.begin(),            mFIFO.end(),            0.0);
-    std::fill(mLastPhase.begin(),       mLastPhase.end(),       0.0);
-    std::fill(mSumPhase.begin(),        mSumPhase.end(),        0.0);
-    std::fill(mOutputAccum.begin(),     mOutputAccum.end(),     0.0);
-    std::fill(mFftBuffer.begin(),       mFftBuffer.end(),       complex_d{});
-    std::fill(mAnalysisBuffer.begin(),  mAnalysisBuffer.end(),  FrequencyBin{});
-    std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
+    mPitchShift  = 1.0f;
+
+    mFIFO.fill(0.0f);
+    mLastPhase.fill(0.0f);
+    mSumPhase.fill(0.0f);
+    mOutputAccum.fill(0.0f);
+    mFftSamples.fill(0.0f);
+    mFftBuffer.fill(complex_f{});
+    mAnalysisAmp.fill(0.0f);
+    mAnalysisFreq.fill(0.0f);
+    mSynthesisAmp.fill(0.0f);
+    mSynthesisFreq.fill(0.0f);
 
     std::fill(std::begin(mCurrentGains), std::end(mCurrentGains), 0.0f);
     std::fill(std::begin(mTargetGains),  std::end(mTargetGains),  0.0f);
@@ -128,7 +367,7 @@ void PshifterState::update(const ALCcontext*, const EffectSlot *slot,
     const int tune{props->Pshifter.CoarseTune*100 + props->Pshifter.FineTune};
     const float pitch{std::pow(2.0f, static_cast<float>(tune) / 1200.0f)};
     mPitchShiftI = fastf2u(pitch*MixerFracOne);
-    mPitchShift  = mPitchShiftI * double{1.0/MixerFracOne};
+    mPitchShift  = static_cast<float>(mPitchShiftI) * (1.0f/MixerFracOne);
 
     const auto coeffs = CalcDirectionCoeffs({0.0f, 0.0f, -1.0f}, 0.0f);
 
@@ -142,106 +381,79 @@ void PshifterState::process(const size_t samplesToDo, const al::span<const Float
      * http://blogs.zynaptiq.com/bernsee/pitch-shifting-using-the-ft/
      */
 
-    /* Cycle offset per update expected of each frequency bin (bin 0 is none,
-     * bin 1 is x1, bin 2 is x2, etc).
-     */
-    constexpr double expected_cycles{al::MathDefs<double>::Tau() / OVERSAMP};
-
     for(size_t base{0u};base < samplesToDo;)
     {
-        const size_t todo{minz(STFT_STEP-mCount, samplesToDo-base)};
+        const size_t todo{minz(mStep-mCount, samplesToDo-base)};
 
         /* Retrieve the output samples from the FIFO and fill in the new input
          * samples.
          */
         auto fifo_iter = mFIFO.begin()+mPos + mCount;
-        std::transform(fifo_iter, fifo_iter+todo, mBufferOut.begin()+base,
-            [](double d) noexcept -> float { return static_cast<float>(d); });
+        std::copy_n(fifo_iter, todo, mBufferOut.begin()+base);
 
         std::copy_n(samplesIn[0].begin()+base, todo, fifo_iter);
         mCount += todo;
         base += todo;
 
         /* Check whether FIFO buffer is filled with new samples. */
-        if(mCount < STFT_STEP) break;
+        if(mCount < mStep) break;
         mCount = 0;
-        mPos = (mPos+STFT_STEP) & (mFIFO.size()-1);
+        mPos = (mPos+mStep) & (mFIFO.size()-1);
 
-        /* Time-domain signal windowing, store in FftBuffer, and apply a
-         * forward FFT to get the frequency-domain signal.
+        /* Time-domain signal windowing, and apply a forward real FFT to get
+         * the frequency-domain signal. Since the real FFT is symmetric, only
+         * StftHalfSize+1 bins are needed.
          */
-        for(size_t src{mPos}, k{0u};src < STFT_SIZE;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * HannWindow[k];
-        for(size_t src{0u}, k{STFT_SIZE-mPos};src < mPos;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * HannWindow[k];
-        forward_fft(mFftBuffer);
-
-        /* Analyze the obtained data. Since the real FFT is symmetric, only
-         * STFT_HALF_SIZE+1 samples are needed.
-         */
-        for(size_t k{0u};k < STFT_HALF_SIZE+1;k++)
-        {
-            const double amplitude{std::abs(mFftBuffer[k])};
-            const double phase{std::arg(mFftBuffer[k])};
-
-            /* Compute phase difference and subtract expected phase difference */
-            double tmp{(phase - mLastPhase[k]) - static_cast<double>(k)*expected_cycles};
-
-            /* Map delta phase into +/- Pi interval */
-            int qpd{double2int(tmp / al::MathDefs<double>::Pi())};
-            tmp -= al::MathDefs<double>::Pi() * (qpd + (qpd%2));
-
-            /* Get deviation from bin frequency from the +/- Pi interval */
-            tmp /= expected_cycles;
+        for(size_t src{mPos}, k{0u};src < StftSize;++src,++k)
+            mFftSamples[k] = mFIFO[src] * HannWindow[k];
+        for(size_t src{0u}, k{StftSize-mPos};src < mPos;++src,++k)
+            mFftSamples[k] = mFIFO[src] * HannWindow[k];
+        forward_real_fft(mFftSamples, al::span<complex_f>{mFftBuffer.data(), StftBins});
 
-            /* Compute the k-th partials' true frequency and store the
-             * amplitude and frequency bin in the analysis buffer.
-             */
-            mAnalysisBuffer[k].Amplitude = amplitude;
-            mAnalysisBuffer[k].FreqBin = static_cast<double>(k) + tmp;
-
-            /* Store the actual phase[k] for the next frame. */
-            mLastPhase[k] = phase;
-        }
+        /* Analyze the obtained data. */
+        analyzeBins();
 
         /* Shift the frequency bins according to the pitch adjustment,
          * accumulating the amplitudes of overlapping frequency bins.
          */
-        std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
-        const size_t bin_count{minz(STFT_HALF_SIZE+1,
-            (((STFT_HALF_SIZE+1)<<MixerFracBits) - (MixerFracOne>>1) - 1)/mPitchShiftI + 1)};
+        mSynthesisAmp.fill(0.0f);
+        mSynthesisFreq.fill(0.0f);
+        const size_t bin_count{minz(StftBins,
+            ((StftBins<<MixerFracBits) - (MixerFracOne>>1) - 1)/mPitchShiftI + 1)};
         for(size_t k{0u};k < bin_count;k++)
         {
             const size_t j{(k*mPitchShiftI + (MixerFracOne>>1)) >> MixerFracBits};
-            mSynthesisBuffer[j].Amplitude += mAnalysisBuffer[k].Amplitude;
-            mSynthesisBuffer[j].FreqBin    = mAnalysisBuffer[k].FreqBin * mPitchShift;
+            mSynthesisAmp[j] += mAnalysisAmp[k];
+            mSynthesisFreq[j] = mAnalysisFreq[k] * mPitchShift;
         }
 
         /* Reconstruct the frequency-domain signal from the adjusted frequency
          * bins.
          */
-        for(size_t k{0u};k < STFT_HALF_SIZE+1;k++)
-        {
-            /* Calculate actual delta phase and accumulate it to get bin phase */
-            mSumPhase[k] += mSynthesisBuffer[k].FreqBin * expected_cycles;
-
-            mFftBuffer[k] = std::polar(mSynthesisBuffer[k].Amplitude, mSumPhase[k]);
-        }
-        for(size_t k{STFT_HALF_SIZE+1};k < STFT_SIZE;++k)
-            mFftBuffer[k] = std::conj(mFftBuffer[STFT_SIZE-k]);
+        synthesizeBins();
 
-        /* Apply an inverse FFT to get the time-domain siganl, and accumulate
-         * for the output with windowing.
+        /* Apply an inverse real FFT to get the time-domain signal, and
+         * accumulate for the output with windowing.
          */
-        inverse_fft(mFftBuffer);
-        for(size_t dst{mPos}, k{0u};dst < STFT_SIZE;++dst,++k)
-            mOutputAccum[dst] += HannWindow[k]*mFftBuffer[k].real() * (4.0/OVERSAMP/STFT_SIZE);
-        for(size_t dst{0u}, k{STFT_SIZE-mPos};dst < mPos;++dst,++k)
-            mOutputAccum[dst] += HannWindow[k]*mFftBuffer[k].real() * (4.0/OVERSAMP/STFT_SIZE);
+        inverse_real_fft(al::span<complex_f>{mFftBuffer.data(), StftBins}, mFftSamples);
+        if(mOversamp == HighQualityOversamp)
+        {
+            for(size_t dst{mPos}, k{0u};dst < StftSize;++dst,++k)
+                mOutputAccum[dst] += HannWindow[k]*mFftSamples[k] * mOutputScale;
+            for(size_t dst{0u}, k{StftSize-mPos};dst < mPos;++dst,++k)
+                mOutputAccum[dst] += HannWindow[k]*mFftSamples[k] * mOutputScale;
+        }
+        else
+        {
+            for(size_t dst{mPos}, k{0u};dst < StftSize;++dst,++k)
+                mOutputAccum[dst] += mFftSamples[k] * mOutputScale;
+            for(size_t dst{0u}, k{StftSize-mPos};dst < mPos;++dst,++k)
+                mOutputAccum[dst] += mFftSamples[k] * mOutputScale;
+        }
 
         /* Copy out the accumulated result, then clear for the next iteration. */
-        std::copy_n(mOutputAccum.begin() + mPos, STFT_STEP, mFIFO.begin() + mPos);
-        std::fill_n(mOutputAccum.begin() + mPos, STFT_STEP, 0.0);
+        std::copy_n(mOutputAccum.begin() + mPos, mStep, mFIFO.begin() + mPos);
+        std::fill_n(mOutputAccum.begin() + mPos, mStep, 0.0f);
     }
 
     /* Now, mix the processed sound data to the output. */
@@ -30,10 +30,13 @@
 #include <functional>
 
 #include "alcmain.h"
+#include "alconfig.h"
 #include "alcontext.h"
 #include "alnumeric.h"
+#include "alstring.h"
 #include "bformatdec.h"
 #include "core/filters/biquad.h"
+#include "core/logging.h"
 #include "effectslot.h"
 #include "vector.h"
 #include "vecmat.h"
@@ -297,10 +300,6 @@ struct T60Filter {
 
     void calcCoeffs(const float length, const float lfDecayTime, const float mfDecayTime,
         const float hfDecayTime, const float lf0norm, const float hf0norm);
-
-    /* Applies the two T60 damping filter sections. */
-    void process(const al::span<float> samples)
-    { DualBiquad{HFFilter, LFFilter}.process(samples, samples.data()); }
 };
 
 struct EarlyReflections {
@@ -417,17 +416,25 @@ struct ReverbState final : public EffectState {
 
     bool mDoFading{};
 
+    /* Low quality processing skips the late reverb modulation and uses a fixed
+     * diffusion, which avoids the LFO, the interpolated feedback reads, and
+     * cross-fades from diffusion and modulation changes.
+     */
+    bool mLowQuality{false};
+
     /* Maximum number of samples to process at once. */
     size_t mMaxUpdate[2]{MAX_UPDATE_SAMPLES, MAX_UPDATE_SAMPLES};
 
     /* The current write offset for all delay lines. */
     size_t mOffset{};
 
+    /* The number of samples the input and output have been silent for. Once
+     * this covers all the delay lines, the reverb is considered idle.
+     */
+    size_t mSilentSamples{0u};
+
     /* Temporary storage used when processing. */
-    union {
-        alignas(16) FloatBufferLine mTempLine{};
-        alignas(16) std::array<ReverbUpdateLine,NUM_LINES> mTempSamples;
-    };
+    alignas(16) std::array<ReverbUpdateLine,NUM_LINES> mTempSamples{};
     alignas(16) std::array<ReverbUpdateLine,NUM_LINES> mEarlySamples{};
     alignas(16) std::array<ReverbUpdateLine,NUM_LINES> mLateSamples{};
 
@@ -439,24 +446,25 @@ struct ReverbState final : public EffectState {
     std::array<std::array<BandSplitter,NUM_LINES>,2> mAmbiSplitter;
 
 
-    static void DoMixRow(const al::span<float> OutBuffer, const al::span<const float> Gains,
-        const float *InSamples, const size_t InStride)
+    /* Mixes the input lines through a 4x4 conversion matrix, replacing the
+     * contents of the output lines.
+     */
+    static void DoMixMatrix(const al::span<float*const,NUM_LINES> OutLines,
+        const float (&Gains)[NUM_LINES][NUM_LINES], const al::span<const float*const> InLines,
+        const size_t todo)
     {
-        std::fill(OutBuffer.begin(), OutBuffer.end(), 0.0f);
-        for(const float gain : Gains)
-        {
-            const float *RESTRICT input{al::assume_aligned<16>(InSamples)};
-            InSamples += InStride;
-
-            if(!(std::fabs(gain) > GainSilenceThreshold))
-                continue;
+        for(float *line : OutLines)
+            std::fill_n(line, todo, 0.0f);
+        MixMatrix(InLines, OutLines, &Gains[0][0], NUM_LINES, todo);
+    }
 
-            for(float &sample : OutBuffer)
-            {
-                sample += *input * gain;
-                ++input;
-            }
-        }
+    static std::array<const float*,NUM_LINES> GetLines(
+        const std::array<ReverbUpdateLine,NUM_LINES> &samples) noexcept
+    {
+        std::array<const float*,NUM_LINES> ret;
+        for(size_t c{0u};c < NUM_LINES;c++)
+            ret[c] = samples[c].data();
+        return ret;
     }
 
 
@@ -465,20 +473,22 @@ struct ReverbState final : public EffectState {
     {
         ASSUME(todo > 0);
 
-        /* Convert back to B-Format, and mix the results to output. */
-        const al::span<float> tmpspan{al::assume_aligned<16>(mTempLine.data()), todo};
+        /* Convert back to B-Format, and mix the results to output. The temp
+         * samples are unused by now, so they can hold the converted lines.
+         */
+        std::array<float*,NUM_LINES> tmplines;
         for(size_t c{0u};c < NUM_LINES;c++)
-        {
-            DoMixRow(tmpspan, A2B[c], mEarlySamples[0].data(), mEarlySamples[0].size());
-            MixSamples(tmpspan, samplesOut, mEarly.CurrentGain[c], mEarly.PanGain[c], counter,
-                offset);
-        }
+            tmplines[c] = mTempSamples[c].data();
+
+        DoMixMatrix(tmplines, A2B, GetLines(mEarlySamples), todo);
         for(size_t c{0u};c < NUM_LINES;c++)
-        {
-            DoMixRow(tmpspan, A2B[c], mLateSamples[0].data(), mLateSamples[0].size());
-            MixSamples(tmpspan, samplesOut, mLate.CurrentGain[c], mLate.PanGain[c], counter,
-                offset);
-        }
+            MixSamples({tmplines[c], todo}, samplesOut, mEarly.CurrentGain[c], mEarly.PanGain[c],
+                counter, offset);
+
+        DoMixMatrix(tmplines, A2B, GetLines(mLateSamples), todo);
+        for(size_t c{0u};c < NUM_LINES;c++)
+            MixSamples({tmplines[c], todo}, samplesOut, mLate.CurrentGain[c], mLate.PanGain[c],
+                counter, offset);
     }
 
     void MixOutAmbiUp(const al::span<FloatBufferLine> samplesOut, const size_t counter,
@@ -486,29 +496,38 @@ struct ReverbState final : public EffectState {
     {
         ASSUME(todo > 0);
 
-        const al::span<float> tmpspan{al::assume_aligned<16>(mTempLine.data()), todo};
+        /* Apply scaling to the B-Format's HF response to "upsample" it to
+         * higher-order output. All four channels are split together, using
+         * the temp samples (which are unused by now) to hold them.
+         */
+        static_assert(NUM_LINES == BandSplitterBank::NumLanes, "Unexpected splitter lanes");
+        const BandSplitterBank::LaneArray hfscales{{mOrderScales[0], mOrderScales[1],
+            mOrderScales[1], mOrderScales[1]}};
+        std::array<float*,NUM_LINES> tmplines;
         for(size_t c{0u};c < NUM_LINES;c++)
-        {
-            DoMixRow(tmpspan, A2B[c], mEarlySamples[0].data(), mEarlySamples[0].size());
+            tmplines[c] = mTempSamples[c].data();
 
-            /* Apply scaling to the B-Format's HF response to "upsample" it to
-             * higher-order output.
-             */
-            const float hfscale{(c==0) ? mOrderScales[0] : mOrderScales[1]};
-            mAmbiSplitter[0][c].processHfScale(tmpspan, hfscale);
-
-            MixSamples(tmpspan, samplesOut, mEarly.CurrentGain[c], mEarly.PanGain[c], counter,
-                offset);
-        }
+        BandSplitterBank splitters;
+        DoMixMatrix(tmplines, A2B, GetLines(mEarlySamples), todo);
+        for(size_t c{0u};c < NUM_LINES;c++)
+            splitters.load(c, mAmbiSplitter[0][c]);
+        splitters.processHfScale(tmplines, hfscales, todo);
         for(size_t c{0u};c < NUM_LINES;c++)
         {
-            DoMixRow(tmpspan, A2B[c], mLateSamples[0].data(), mLateSamples[0].size());
-
-            const float hfscale{(c==0) ? mOrderScales[0] : mOrderScales[1]};
-            mAmbiSplitter[1][c].processHfScale(tmpspan, hfscale);
+            splitters.store(c, mAmbiSplitter[0][c]);
+            MixSamples({tmplines[c], todo}, samplesOut, mEarly.CurrentGain[c], mEarly.PanGain[c],
+                counter, offset);
+        }
 
-            MixSamples(tmpspan, samplesOut, mLate.CurrentGain[c], mLate.PanGain[c], counter,
-                offset);
+        DoMixMatrix(tmplines, A2B, GetLines(mLateSamples), todo);
+        for(size_t c{0u};c < NUM_LINES;c++)
+            splitters.load(c, mAmbiSplitter[1][c]);
+        splitters.processHfScale(tmplines, hfscales, todo);
+        for(size_t c{0u};c < NUM_LINES;c++)
+        {
+            splitters.store(c, mAmbiSplitter[1][c]);
+            MixSamples({tmplines[c], todo}, samplesOut, mLate.CurrentGain[c], mLate.PanGain[c],
+                counter, offset);
         }
     }
 
@@ -527,6 +546,8 @@ struct ReverbState final : public EffectState {
     void lateFaded(const size_t offset, const size_t todo, const float fade,
         const float fadeStep);
 
+    float calcOutputPeak(const size_t todo) const noexcept;
+
     void deviceUpdate(const ALCdevice *device, const Buffer &buffer) override;
     void update(const ALCcontext *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
@@ -611,6 +632,15 @@ void ReverbState::deviceUpdate(const ALCdevice *device, const Buffer&)
 {
     const auto frequency = static_cast<float>(device->Frequency);
 
+    mLowQuality = false;
+    if(auto qualopt = ConfigValueStr(device->DeviceName.c_str(), "reverb", "quality"))
+    {
+        if(al::strcasecmp(qualopt->c_str(), "low") == 0)
+            mLowQuality = true;
+        else if(al::strcasecmp(qualopt->c_str(), "high") != 0)
+            ERR("Invalid reverb quality: %s\n", qualopt->c_str());
+    }
+
     /* Allocate the delay lines. */
     allocLines(frequency);
 
@@ -661,6 +691,8 @@ void ReverbState::deviceUpdate(const ALCdevice *device, const Buffer&)
     mDoFading = true;
     std::fill(std::begin(mMaxUpdate), std::end(mMaxUpdate), MAX_UPDATE_SAMPLES);
     mOffset = 0;
+    mSilentSamples = 0;
+    mIsIdle = false;
 
     if(device->mAmbiOrder > 1)
     {
@@ -1009,11 +1041,17 @@ void ReverbState::update(const ALCcontext *Context, const EffectSlot *Slot,
     updateDelayLine(props->Reverb.ReflectionsDelay, props->Reverb.LateReverbDelay,
         density_mult, props->Reverb.DecayTime, frequency);
 
+    /* Low quality ignores the diffusion and modulation properties. */
+    const float diffusion{mLowQuality ? AL_EAXREVERB_DEFAULT_DIFFUSION : props->Reverb.Diffusion};
+    const float modTime{mLowQuality ? AL_EAXREVERB_DEFAULT_MODULATION_TIME
+        : props->Reverb.ModulationTime};
+    const float modDepth{mLowQuality ? 0.0f : props->Reverb.ModulationDepth};
+
     /* Update the early lines. */
-    mEarly.updateLines(density_mult, props->Reverb.Diffusion, props->Reverb.DecayTime, frequency);
+    mEarly.updateLines(density_mult, diffusion, props->Reverb.DecayTime, frequency);
 
     /* Get the mixing matrix coefficients. */
-    CalcMatrixCoeffs(props->Reverb.Diffusion, &mMixX, &mMixY);
+    CalcMatrixCoeffs(diffusion, &mMixX, &mMixY);
 
     /* If the HF limit parameter is flagged, calculate an appropriate limit
      * based on the air absorption parameter.
@@ -1030,11 +1068,10 @@ void ReverbState::update(const ALCcontext *Context, const EffectSlot *Slot,
         AL_EAXREVERB_MIN_DECAY_TIME, AL_EAXREVERB_MAX_DECAY_TIME)};
 
     /* Update the modulator rate and depth. */
-    mLate.Mod.updateModulator(props->Reverb.ModulationTime, props->Reverb.ModulationDepth,
-        frequency);
+    mLate.Mod.updateModulator(modTime, modDepth, frequency);
 
     /* Update the late lines. */
-    mLate.updateLines(density_mult, props->Reverb.Diffusion, lfDecayTime,
+    mLate.updateLines(density_mult, diffusion, lfDecayTime,
         props->Reverb.DecayTime, hfDecayTime, lf0norm, hf0norm, frequency);
 
     /* Update early and late 3D panning. */
@@ -1053,13 +1090,13 @@ void ReverbState::update(const ALCcontext *Context, const EffectSlot *Slot,
         /* Diffusion and decay times influences the decay rate (gain) of the
          * late reverb T60 filter.
          */
-        mParams.Diffusion != props->Reverb.Diffusion ||
+        mParams.Diffusion != diffusion ||
         mParams.DecayTime != props->Reverb.DecayTime ||
         mParams.HFDecayTime != hfDecayTime ||
         mParams.LFDecayTime != lfDecayTime ||
         /* Modulation time and depth both require fading the modulation delay. */
-        mParams.ModulationTime != props->Reverb.ModulationTime ||
-        mParams.ModulationDepth != props->Reverb.ModulationDepth ||
+        mParams.ModulationTime != modTime ||
+        mParams.ModulationDepth != modDepth ||
         /* HF/LF References control the weighting used to calculate the density
          * gain.
          */
@@ -1068,12 +1105,12 @@ void ReverbState::update(const ALCcontext *Context, const EffectSlot *Slot,
     if(mDoFading)
     {
         mParams.Density = props->Reverb.Density;
-        mParams.Diffusion = props->Reverb.Diffusion;
+        mParams.Diffusion = diffusion;
         mParams.DecayTime = props->Reverb.DecayTime;
         mParams.HFDecayTime = hfDecayTime;
         mParams.LFDecayTime = lfDecayTime;
-        mParams.ModulationTime = props->Reverb.ModulationTime;
-        mParams.ModulationDepth = props->Reverb.ModulationDepth;
+        mParams.ModulationTime = modTime;
+        mParams.ModulationDepth = modDepth;
         mParams.HFReference = props->Reverb.HFReference;
         mParams.LFReference = props->Reverb.LFReference;
     }
@@ -1206,6 +1243,13 @@ void VecAllpass::processFaded(const al::span<ReverbUpdateLine,NUM_LINES> samples
     const float xCoeff, const float yCoeff, float fadeCount, const float fadeStep,
     const size_t todo)
 {
+    /* If none of the line lengths are changing, there's nothing to fade. */
+    bool changing{false};
+    for(size_t j{0u};j < NUM_LINES;j++)
+        changing |= (Offset[j][0] != Offset[j][1]);
+    if(!changing)
+        return processUnfaded(samples, offset, xCoeff, yCoeff, todo);
+
     const DelayLineI delay{Delay};
     const float feedCoeff{Coeff};
 
@@ -1353,6 +1397,25 @@ void ReverbState::earlyFaded(const size_t offset, const size_t todo, const float
         const float newCoeffStep{mEarlyDelayCoeff[j][1] * fadeStep};
         float fadeCount{fade};
 
+        /* When the tap isn't moving, the old and new taps read the same
+         * samples, so just ramp the coefficient in place.
+         */
+        if(early_delay_tap0 == early_delay_tap1)
+        {
+            const float coeffStep{oldCoeffStep + newCoeffStep};
+            for(size_t i{0u};i < todo;)
+            {
+                early_delay_tap0 &= main_delay.Mask;
+                size_t td{minz(main_delay.Mask+1 - early_delay_tap0, todo - i)};
+                do {
+                    fadeCount += 1.0f;
+                    mTempSamples[j][i++] = main_delay.Line[early_delay_tap0++][j] *
+                        (oldCoeff + coeffStep*fadeCount);
+                } while(--td);
+            }
+            continue;
+        }
+
         for(size_t i{0u};i < todo;)
         {
             early_delay_tap0 &= main_delay.Mask;
@@ -1381,6 +1444,23 @@ void ReverbState::earlyFaded(const size_t offset, const size_t todo, const float
         float *out{mEarlySamples[j].data()};
         float fadeCount{fade};
 
+        if(feedb_tap0 == feedb_tap1)
+        {
+            const float feedb_coeffStep{feedb_oldCoeffStep + feedb_newCoeffStep};
+            for(size_t i{0u};i < todo;)
+            {
+                feedb_tap0 &= early_delay.Mask;
+                size_t td{minz(early_delay.Mask+1 - feedb_tap0, todo - i)};
+                do {
+                    fadeCount += 1.0f;
+                    out[i] = mTempSamples[j][i] + early_delay.Line[feedb_tap0++][j] *
+                        (feedb_oldCoeff + feedb_coeffStep*fadeCount);
+                    ++i;
+                } while(--td);
+            }
+            continue;
+        }
+
         for(size_t i{0u};i < todo;)
         {
             feedb_tap0 &= early_delay.Mask;
@@ -1406,6 +1486,29 @@ void ReverbState::earlyFaded(const size_t offset, const size_t todo, const float
 }
 
 
+/* Applies the two T60 damping filter sections to each line, with the four
+ * lines processed together.
+ */
+void ApplyT60Filters(const al::span<T60Filter,NUM_LINES> filters,
+    const al::span<ReverbUpdateLine,NUM_LINES> samples, const size_t todo)
+{
+    BiquadBank<2> bank;
+    std::array<const float*,NUM_LINES> src;
+    std::array<float*,NUM_LINES> dst;
+    for(size_t j{0u};j < NUM_LINES;j++)
+    {
+        bank.load(j, 0, filters[j].HFFilter);
+        bank.load(j, 1, filters[j].LFFilter);
+        src[j] = dst[j] = samples[j].data();
+    }
+    bank.process(src, dst, todo);
+    for(size_t j{0u};j < NUM_LINES;j++)
+    {
+        bank.store(j, 0, filters[j].HFFilter);
+        bank.store(j, 1, filters[j].LFFilter);
+    }
+}
+
 void Modulation::calcDelays(size_t todo)
 {
     constexpr float inv_scale{MOD_FRACONE / al::MathDefs<float>::Tau()};
@@ -1463,7 +1566,8 @@ void ReverbState::lateUnfaded(const size_t offset, const size_t todo)
     ASSUME(todo > 0);
 
     /* First, calculate the modulated delays for the late feedback. */
-    mLate.Mod.calcDelays(todo);
+    if(!mLowQuality)
+        mLate.Mod.calcDelays(todo);
 
     /* Next, load decorrelated samples from the main and feedback delay lines.
      * Filter the signal to apply its frequency-dependent decay.
@@ -1475,6 +1579,24 @@ void ReverbState::lateUnfaded(const size_t offset, const size_t todo)
         const float midGain{mLate.T60[j].MidGain[0]};
         const float densityGain{mLate.DensityGain[0] * midGain};
 
+        /* Without modulation, the feedback can be read directly. */
+        if(mLowQuality)
+        {
+            for(size_t i{0u};i < todo;)
+            {
+                late_delay_tap &= main_delay.Mask;
+                late_feedb_tap &= late_delay.Mask;
+                size_t td{minz(todo - i, minz(main_delay.Mask+1 - late_delay_tap,
+                    late_delay.Mask+1 - late_feedb_tap))};
+                do {
+                    mTempSamples[j][i] = late_delay.Line[late_feedb_tap++][j]*midGain +
+                        main_delay.Line[late_delay_tap++][j]*densityGain;
+                    ++i;
+                } while(--td);
+            }
+            continue;
+        }
+
         for(size_t i{0u};i < todo;)
         {
             late_delay_tap &= main_delay.Mask;
@@ -1503,8 +1625,8 @@ void ReverbState::lateUnfaded(const size_t offset, const size_t todo)
                 ++i;
             } while(--td);
         }
-        mLate.T60[j].process({mTempSamples[j].data(), todo});
     }
+    ApplyT60Filters(mLate.T60, mTempSamples, todo);
 
     /* Apply a vector all-pass to improve micro-surface diffusion, and write
      * out the results for mixing.
@@ -1526,7 +1648,8 @@ void ReverbState::lateFaded(const size_t offset, const size_t todo, const float
 
     ASSUME(todo > 0);
 
-    mLate.Mod.calcFadedDelays(todo, fade, fadeStep);
+    if(!mLowQuality)
+        mLate.Mod.calcFadedDelays(todo, fade, fadeStep);
 
     for(size_t j{0u};j < NUM_LINES;j++)
     {
@@ -1544,6 +1667,65 @@ void ReverbState::lateFaded(const size_t offset, const size_t todo, const float
         size_t late_feedb_tap1{offset - mLate.Offset[j][1]};
         float fadeCount{fade};
 
+        /* When the line lengths aren't changing, the old and new taps read the
+         * same samples, so just ramp the gains in place.
+         */
+        if(late_delay_tap0 == late_delay_tap1 && late_feedb_tap0 == late_feedb_tap1)
+        {
+            const float gainStep{oldMidStep + midStep};
+            const float densityGainStep{oldDensityStep + densityStep};
+            for(size_t i{0u};i < todo;)
+            {
+                late_delay_tap0 &= main_delay.Mask;
+                size_t td{minz(todo - i, main_delay.Mask+1 - late_delay_tap0)};
+                do {
+                    fadeCount += 1.0f;
+
+                    float out;
+                    if(mLowQuality)
+                        out = late_delay.Line[late_feedb_tap0 & late_delay.Mask][j];
+                    else
+                    {
+                        const float fdelay{mLate.Mod.ModDelays[i]};
+                        const size_t delay{float2uint(fdelay)};
+                        const float frac{fdelay - static_cast<float>(delay)};
+
+                        const size_t tap{late_feedb_tap0 - delay};
+                        const float out0{late_delay.Line[tap & late_delay.Mask][j]};
+                        const float out1{late_delay.Line[(tap-1) & late_delay.Mask][j]};
+                        out = lerp(out0, out1, frac);
+                    }
+                    ++late_feedb_tap0;
+
+                    mTempSamples[j][i] = out*(oldMidGain + gainStep*fadeCount) +
+                        main_delay.Line[late_delay_tap0++][j] *
+                        (oldDensityGain + densityGainStep*fadeCount);
+                    ++i;
+                } while(--td);
+            }
+            continue;
+        }
+
+        if(mLowQuality)
+        {
+            for(size_t i{0u};i < todo;++i)
+            {
+                fadeCount += 1.0f;
+
+                const float out0{late_delay.Line[late_feedb_tap0++ & late_delay.Mask][j]};
+                const float out1{late_delay.Line[late_feedb_tap1++ & late_delay.Mask][j]};
+
+                const float fade0{oldDensityGain + oldDensityStep*fadeCount};
+                const float fade1{densityStep*fadeCount};
+                const float gfade0{oldMidGain + oldMidStep*fadeCount};
+                const float gfade1{midStep*fadeCount};
+                mTempSamples[j][i] = out0*gfade0 + out1*gfade1 +
+                    main_delay.Line[late_delay_tap0++ & main_delay.Mask][j]*fade0 +
+                    main_delay.Line[late_delay_tap1++ & main_delay.Mask][j]*fade1;
+            }
+            continue;
+        }
+
         for(size_t i{0u};i < todo;)
         {
             late_delay_tap0 &= main_delay.Mask;
@@ -1574,8 +1756,8 @@ void ReverbState::lateFaded(const size_t offset, const size_t todo, const float
                 ++i;
             } while(--td);
         }
-        mLate.T60[j].process({mTempSamples[j].data(), todo});
     }
+    ApplyT60Filters(mLate.T60, mTempSamples, todo);
 
     mLate.VecAp.processFaded(mTempSamples, offset, mixX, mixY, fade, fadeStep, todo);
     for(size_t j{0u};j < NUM_LINES;j++)
@@ -1584,33 +1766,79 @@ void ReverbState::lateFaded(const size_t offset, const size_t todo, const float
     VectorScatterRevDelayIn(late_delay, offset, mixX, mixY, mTempSamples, todo);
 }
 
+/* Returns the largest magnitude of the given samples. */
+inline float CalcPeak(const al::span<const float> samples) noexcept
+{
+    float peak{0.0f};
+    for(const float sample : samples)
+        peak = maxf(peak, std::fabs(sample));
+    return peak;
+}
+
+float ReverbState::calcOutputPeak(const size_t todo) const noexcept
+{
+    float peak{0.0f};
+    for(size_t c{0u};c < NUM_LINES;c++)
+    {
+        peak = maxf(peak, CalcPeak({mEarlySamples[c].data(), todo}));
+        peak = maxf(peak, CalcPeak({mLateSamples[c].data(), todo}));
+    }
+    return peak;
+}
+
 void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
     size_t offset{mOffset};
 
     ASSUME(samplesToDo > 0);
 
-    /* Convert B-Format to A-Format for processing. */
+    /* Track the peak input and output level, to know when the tail has fully
+     * decayed.
+     */
+    float peak{0.0f};
+
+    /* Convert B-Format to A-Format for processing, feeding the initial delay
+     * line.
+     */
     const size_t numInput{minz(samplesIn.size(), NUM_LINES)};
-    const al::span<float> tmpspan{al::assume_aligned<16>(mTempLine.data()), samplesToDo};
+    std::array<const float*,NUM_LINES> inputs;
+    std::array<float*,NUM_LINES> tmplines;
     for(size_t c{0u};c < NUM_LINES;c++)
+        tmplines[c] = mTempSamples[c].data();
+    for(size_t base{0};base < samplesToDo;)
     {
-        std::fill(tmpspan.begin(), tmpspan.end(), 0.0f);
+        const size_t todo{minz(samplesToDo-base, MAX_UPDATE_SAMPLES)};
+
         for(size_t i{0};i < numInput;++i)
-        {
-            const float gain{B2A[c][i]};
-            const float *RESTRICT input{al::assume_aligned<16>(samplesIn[i].data())};
+            inputs[i] = samplesIn[i].data() + base;
+        DoMixMatrix(tmplines, B2A, {inputs.data(), numInput}, todo);
 
-            for(float &sample : tmpspan)
-            {
-                sample += *input * gain;
-                ++input;
-            }
-        }
+        for(size_t c{0u};c < NUM_LINES;c++)
+            mDelay.write(offset+base, c, tmplines[c], todo);
+        base += todo;
+    }
 
-        /* Band-pass the incoming samples and feed the initial delay line. */
-        DualBiquad{mFilter[c].Lp, mFilter[c].Hp}.process(tmpspan, tmpspan.data());
-        mDelay.write(offset, c, tmpspan.cbegin(), samplesToDo);
+    /* Band-pass the incoming samples in the delay line, all lines at once. */
+    BiquadBank<2> filter;
+    for(size_t c{0u};c < NUM_LINES;c++)
+    {
+        filter.load(c, 0, mFilter[c].Lp);
+        filter.load(c, 1, mFilter[c].Hp);
+    }
+    for(size_t base{0};base < samplesToDo;)
+    {
+        const size_t pos{(offset+base) & mDelay.Mask};
+        const size_t todo{minz(samplesToDo-base, mDelay.Mask+1 - pos)};
+        const al::span<std::array<float,NUM_LINES>> line{mDelay.Line+pos, todo};
+        filter.process(line);
+        for(const auto &sample : line)
+            peak = maxf(peak, CalcPeak(sample));
+        base += todo;
+    }
+    for(size_t c{0u};c < NUM_LINES;c++)
+    {
+        filter.store(c, 0, mFilter[c].Lp);
+        filter.store(c, 1, mFilter[c].Hp);
     }
 
     /* Process reverb for these samples. */
@@ -1629,6 +1857,9 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
             /* Generate non-faded early reflections and late reverb. */
             earlyUnfaded(offset, todo);
             lateUnfaded(offset, todo);
+            /* The output level only matters once the input has gone silent. */
+            if(peak <= GainSilenceThreshold)
+                peak = maxf(peak, calcOutputPeak(todo));
 
             /* Finally, mix early reflections and late reverb. */
             (this->*mMixOut)(samplesOut, samplesToDo-base, base, todo);
@@ -1650,6 +1881,8 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
             auto fadeCount = static_cast<float>(base);
             earlyFaded(offset, todo, fadeCount, fadeStep);
             lateFaded(offset, todo, fadeCount, fadeStep);
+            if(peak <= GainSilenceThreshold)
+                peak = maxf(peak, calcOutputPeak(todo));
 
             (this->*mMixOut)(samplesOut, samplesToDo-base, base, todo);
 
@@ -1676,6 +1909,18 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
         mDoFading = false;
     }
     mOffset = offset;
+
+    /* Once the input and output have been silent long enough for everything
+     * in the delay lines to have passed through, the reverb has nothing left
+     * to output until it gets more input.
+     */
+    if(peak > GainSilenceThreshold)
+        mSilentSamples = 0;
+    else
+    {
+        mSilentSamples = minz(mSilentSamples+samplesToDo, mSampleBuffer.size());
+        mIsIdle = (mSilentSamples == mSampleBuffer.size());
+    }
 }
 
 
@@ -18,6 +18,32 @@ EffectSlotArray *EffectSlot::CreatePtrArray(size_t count) noexcept
     return new(ptr) EffectSlotArray{count};
 }
 
+void EffectSlotSourceParams::set(const EffectSlotProps &props) noexcept
+{
+    AuxSendAuto = props.AuxSendAuto;
+    EffectType = props.Type;
+    if(props.Type == EffectSlotType::Reverb || props.Type == EffectSlotType::EAXReverb)
+    {
+        RoomRolloff = props.Props.Reverb.RoomRolloffFactor;
+        DecayTime = props.Props.Reverb.DecayTime;
+        DecayLFRatio = props.Props.Reverb.DecayLFRatio;
+        DecayHFRatio = props.Props.Reverb.DecayHFRatio;
+        DecayHFLimit = props.Props.Reverb.DecayHFLimit;
+        AirAbsorptionGainHF = props.Props.Reverb.AirAbsorptionGainHF;
+    }
+    else
+    {
+        RoomRolloff = 0.0f;
+        DecayTime = 0.0f;
+        DecayLFRatio = 0.0f;
+        DecayHFRatio = 0.0f;
+        DecayHFLimit = false;
+        AirAbsorptionGainHF = 1.0f;
+    }
+    Stamp = props.Stamp;
+}
+
+
 EffectSlot::~EffectSlot()
 {
     if(mWetBuffer)
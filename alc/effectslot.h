@@ -45,12 +45,34 @@ struct EffectSlotProps {
 
     al::intrusive_ptr<EffectState> State;
 
+    /* Identifies this update, for the slot's source parameters. */
+    uint Stamp;
+
     std::atomic<EffectSlotProps*> next;
 
     DEF_NEWDEL(EffectSlotProps)
 };
 
 
+/* The effect slot parameters that affect the sources sending to it. */
+struct EffectSlotSourceParams {
+    bool AuxSendAuto{true};
+    EffectSlotType EffectType{EffectSlotType::None};
+
+    float RoomRolloff{0.0f}; /* Added to the source's room rolloff, not multiplied. */
+    float DecayTime{0.0f};
+    float DecayLFRatio{0.0f};
+    float DecayHFRatio{0.0f};
+    bool DecayHFLimit{false};
+    float AirAbsorptionGainHF{1.0f};
+
+    /* The stamp of the property update these were set from. */
+    uint Stamp{0u};
+
+    void set(const EffectSlotProps &props) noexcept;
+};
+
+
 struct EffectSlot {
     std::atomic<EffectSlotProps*> Update{nullptr};
 
@@ -62,19 +84,15 @@ struct EffectSlot {
     MixParams Wet;
 
     float Gain{1.0f};
-    bool  AuxSendAuto{true};
     EffectSlot *Target{nullptr};
 
-    EffectSlotType EffectType{EffectSlotType::None};
     EffectProps mEffectProps{};
     EffectState *mEffectState{nullptr};
 
-    float RoomRolloff{0.0f}; /* Added to the source's room rolloff, not multiplied. */
-    float DecayTime{0.0f};
-    float DecayLFRatio{0.0f};
-    float DecayHFRatio{0.0f};
-    bool DecayHFLimit{false};
-    float AirAbsorptionGainHF{1.0f};
+    /* The ID of the AL effect slot this belongs to, for tracing. */
+    uint mId{0u};
+
+    EffectSlotSourceParams mSourceParams;
 
     /* Mixing buffer used by the Wet mix. */
     WetBuffer *mWetBuffer{nullptr};
@@ -66,6 +66,80 @@ AL_API void AL_APIENTRY alAuxiliaryEffectSlotStopvSOFT(ALsizei n, const ALuint *
 #endif
 #endif
 
+#ifndef AL_SOFT_UHJ
+#define AL_SOFT_UHJ
+#define AL_FORMAT_UHJ2CHN8_SOFT                  0x19A2
+#define AL_FORMAT_UHJ2CHN16_SOFT                 0x19A3
+#define AL_FORMAT_UHJ2CHN_FLOAT32_SOFT           0x19A4
+#endif
+
+#ifndef AL_SOFTX_property_pools
+#define AL_SOFTX_property_pools
+#define ALC_SOURCE_PROPERTY_POOL_SIZE_SOFTX      0x19A7
+#define AL_SOURCE_PROPERTY_HIGH_WATER_SOFTX      0x19A8
+#define AL_EFFECTSLOT_PROPERTY_HIGH_WATER_SOFTX  0x19A9
+#define AL_LISTENER_PROPERTY_HIGH_WATER_SOFTX    0x19AA
+#define ALC_EFFECTSLOT_PROPERTY_POOL_SIZE_SOFTX  0x19BA
+#endif
+
+#ifndef ALC_SOFTX_reserved_voices
+#define ALC_SOFTX_reserved_voices
+#define ALC_RESERVED_VOICES_SOFTX                0x19AB
+#endif
+
+#ifndef AL_SOFTX_event_queue
+#define AL_SOFTX_event_queue
+#define AL_EVENT_QUEUE_SOFTX                     0x19AC
+#define AL_EVENT_MESSAGES_SOFTX                  0x19AD
+#define AL_EVENT_FD_SOFTX                        0x19AE
+typedef struct ALeventRecordSOFT {
+    ALenum type;
+    ALuint object;
+    ALuint param;
+} ALeventRecordSOFT;
+typedef ALsizei (AL_APIENTRY*LPALREADEVENTSSOFT)(ALsizei count, ALeventRecordSOFT *events);
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API ALsizei AL_APIENTRY alReadEventsSOFT(ALsizei count, ALeventRecordSOFT *events);
+#endif
+#endif
+
+#ifndef ALC_SOFTX_mixer_stats
+#define ALC_SOFTX_mixer_stats
+#define ALC_MIXER_PERIODS_SOFTX                  0x19AF
+#define ALC_MIXER_TOTAL_TIME_SOFTX               0x19B0
+#define ALC_MIXER_STAGE_TIMES_SOFTX              0x19B1
+#define ALC_MIXER_MAX_PERIOD_TIME_SOFTX          0x19B2
+#define ALC_MIXER_PERIOD_PERCENTILES_SOFTX       0x19B3
+#define ALC_MIXER_DEADLINE_MISSES_SOFTX          0x19B4
+#define ALC_MIXER_ACTIVE_VOICES_SOFTX            0x19B5
+#define ALC_MIXER_IDLE_VOICES_SOFTX              0x19B6
+#endif
+
+#ifndef ALC_SOFTX_backend_stats
+#define ALC_SOFTX_backend_stats
+#define ALC_BACKEND_XRUNS_SOFTX                  0x19B7
+#define ALC_BACKEND_CALLBACK_JITTER_SOFTX        0x19B8
+#define ALC_BACKEND_WAKEUP_LATENCY_SOFTX         0x19B9
+#endif
+
+#ifndef AL_SOFTX_source_batch
+#define AL_SOFTX_source_batch
+typedef void (AL_APIENTRY*LPALSOURCESFVSOFT)(ALsizei nsources, const ALuint *sources, ALsizei nparams, const ALenum *params, const ALfloat *values);
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alSourcesfvSOFT(ALsizei nsources, const ALuint *sources, ALsizei nparams, const ALenum *params, const ALfloat *values);
+#endif
+#endif
+
+#ifndef AL_SOFTX_source_commands
+#define AL_SOFTX_source_commands
+typedef void (AL_APIENTRY*LPALBEGINSOURCECOMMANDSSOFT)(void);
+typedef void (AL_APIENTRY*LPALCOMMITSOURCECOMMANDSSOFT)(void);
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alBeginSourceCommandsSOFT(void);
+AL_API void AL_APIENTRY alCommitSourceCommandsSOFT(void);
+#endif
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,171 @@
+#ifndef ALC_MIXSTATS_H
+#define ALC_MIXSTATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "albit.h"
+#include "alnumeric.h"
+
+
+/* A histogram of times, with four buckets per octave of nanoseconds up to
+ * about 2 seconds, along with the largest time added. Only one thread may add
+ * times (using plain loads and stores, no read-modify-write), while any thread
+ * may read it. Readers can see an update partially applied, which is fine for
+ * the purposes here.
+ */
+class TimeHistogram {
+    static constexpr size_t HistogramSize{128};
+
+    std::array<std::atomic<uint32_t>,HistogramSize> mCounts;
+    std::atomic<uint64_t> mMax{0u};
+
+    static size_t getIndex(uint64_t ns) noexcept
+    {
+        if(ns < 4) return static_cast<size_t>(ns);
+        /* Smear the top bit down to find its position. */
+        uint64_t bits{ns};
+        bits |= bits>>1; bits |= bits>>2; bits |= bits>>4;
+        bits |= bits>>8; bits |= bits>>16; bits |= bits>>32;
+        const int msb{clampi(al::popcount(bits) - 1, 2, 31)};
+        ns = minu64(ns, (uint64_t{8}<<(msb-2)) - 1);
+        return static_cast<size_t>(msb<<2) | ((ns>>(msb-2))&3);
+    }
+    /* The (exclusive) upper limit of the given bucket, in nanoseconds. */
+    static uint64_t getLimit(size_t idx) noexcept
+    {
+        if(idx < 4) return idx + 1;
+        const int msb{static_cast<int>(idx>>2)};
+        return ((idx&3) + 5) << (msb-2);
+    }
+
+public:
+    TimeHistogram() noexcept { reset(); }
+    TimeHistogram(const TimeHistogram&) = delete;
+    TimeHistogram& operator=(const TimeHistogram&) = delete;
+
+    void reset() noexcept
+    {
+        for(auto &count : mCounts)
+            count.store(0u, std::memory_order_relaxed);
+        mMax.store(0u, std::memory_order_relaxed);
+    }
+
+    void add(std::chrono::nanoseconds time) noexcept
+    {
+        const auto ns = static_cast<uint64_t>(std::max(time.count(),
+            std::chrono::nanoseconds::rep{0}));
+        std::atomic<uint32_t> &count = mCounts[getIndex(ns)];
+        count.store(count.load(std::memory_order_relaxed)+1u, std::memory_order_relaxed);
+        if(ns > mMax.load(std::memory_order_relaxed))
+            mMax.store(ns, std::memory_order_relaxed);
+    }
+
+    uint64_t getMax() const noexcept { return mMax.load(std::memory_order_relaxed); }
+
+    /* Returns the approximate time, in nanoseconds, that the given fraction
+     * (0...1) of the added times were no longer than.
+     */
+    uint64_t getPercentile(double frac) const noexcept
+    {
+        std::array<uint32_t,HistogramSize> counts;
+        uint64_t total{0u};
+        for(size_t i{0};i < HistogramSize;++i)
+        {
+            counts[i] = mCounts[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if(total == 0) return 0u;
+
+        const uint64_t maxtime{getMax()};
+        const auto target = static_cast<uint64_t>(static_cast<double>(total)*frac + 0.5);
+        uint64_t sum{0u};
+        for(size_t i{0};i < HistogramSize;++i)
+        {
+            sum += counts[i];
+            if(sum >= target && sum > 0)
+                return minu64(getLimit(i), maxtime);
+        }
+        return maxtime;
+    }
+};
+
+
+/* Timing statistics for a device's mixer. Everything is written only by the
+ * mixer thread, once per call to ALCdevice::renderSamples, and may be read by
+ * any thread at any time.
+ */
+struct MixerStats {
+    using clock = std::chrono::steady_clock;
+
+    enum Stage : size_t {
+        ParamUpdates,
+        Voices,
+        Effects,
+        PostProcess,
+        Limiter,
+        Write,
+
+        StageCount
+    };
+    using StageTimes = std::array<clock::duration,StageCount>;
+
+    std::atomic<uint64_t> mPeriods{0u};
+    std::atomic<uint64_t> mTotalTime{0u};
+    std::array<std::atomic<uint64_t>,StageCount> mStageTimes;
+    std::atomic<uint64_t> mDeadlineMisses{0u};
+    TimeHistogram mPeriodTimes;
+
+    /* Voices that were mixed in the last period, and voices that are held by
+     * a paused source without being mixed.
+     */
+    std::atomic<uint> mActiveVoices{0u};
+    std::atomic<uint> mIdleVoices{0u};
+
+    MixerStats() noexcept { reset(); }
+    MixerStats(const MixerStats&) = delete;
+    MixerStats& operator=(const MixerStats&) = delete;
+
+    /* Must not be called while the mixer is running. */
+    void reset() noexcept
+    {
+        mPeriods.store(0u, std::memory_order_relaxed);
+        mTotalTime.store(0u, std::memory_order_relaxed);
+        for(auto &stagetime : mStageTimes)
+            stagetime.store(0u, std::memory_order_relaxed);
+        mDeadlineMisses.store(0u, std::memory_order_relaxed);
+        mPeriodTimes.reset();
+        mActiveVoices.store(0u, std::memory_order_relaxed);
+        mIdleVoices.store(0u, std::memory_order_relaxed);
+    }
+
+    /* Called by the mixer at the end of each period. */
+    void update(const StageTimes &stagetimes, const clock::duration periodtime,
+        const clock::duration deadline, const uint active, const uint idle) noexcept
+    {
+        auto accum = [](std::atomic<uint64_t> &val, uint64_t add) noexcept -> void
+        { val.store(val.load(std::memory_order_relaxed)+add, std::memory_order_relaxed); };
+        auto to_ns = [](const clock::duration time) noexcept -> uint64_t
+        {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+        };
+
+        for(size_t i{0};i < StageCount;++i)
+            accum(mStageTimes[i], to_ns(stagetimes[i]));
+        accum(mTotalTime, to_ns(periodtime));
+        if(periodtime > deadline)
+            accum(mDeadlineMisses, 1u);
+        mPeriodTimes.add(periodtime);
+
+        mActiveVoices.store(active, std::memory_order_relaxed);
+        mIdleVoices.store(idle, std::memory_order_relaxed);
+        accum(mPeriods, 1u);
+    }
+};
+
+#endif /* ALC_MIXSTATS_H */
@@ -1024,8 +1024,19 @@ no_hrtf:
     }
     if(device->mRenderMode == RenderMode::Normal)
     {
-        device->Uhj_Encoder = std::make_unique<Uhj2Encoder>();
-        TRACE("UHJ enabled\n");
+        UhjLength uhjlen{UhjLengthDefault};
+        if(auto lenopt = ConfigValueUInt(device->DeviceName.c_str(), "uhj", "encode-length"))
+        {
+            switch(*lenopt)
+            {
+            case 128: uhjlen = UhjLength::Length128; break;
+            case 256: uhjlen = UhjLength::Length256; break;
+            case 512: uhjlen = UhjLength::Length512; break;
+            default: ERR("Unsupported uhj/encode-length: %u\n", *lenopt);
+            }
+        }
+        device->Uhj_Encoder = std::make_unique<Uhj2Encoder>(uhjlen);
+        TRACE("UHJ enabled (%zu sample filter delay)\n", device->Uhj_Encoder->mFilterDelay);
         InitUhjPanning(device);
         device->PostProcess = &ALCdevice::ProcessUhj;
         return;
@@ -0,0 +1,132 @@
+#ifndef ALC_PROPPOOL_H
+#define ALC_PROPPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "almalloc.h"
+#include "atomic.h"
+#include "vector.h"
+
+
+/* A pool of property update containers (types with an atomic next pointer).
+ * Containers are allocated in clusters that live as long as the pool, and
+ * unused ones are kept in a lock-free list so the mixer can return them
+ * without blocking or freeing anything. Each container is padded out to a
+ * whole cache line, so containers being written by the app and read by the
+ * mixer don't share one. New clusters are allocated with ClusterSize
+ * containers when the pool runs out.
+ */
+template<typename T, size_t ClusterSize>
+class PropsPool {
+    struct alignas(64) Entry {
+        T mItem;
+
+        DEF_NEWDEL(Entry)
+    };
+    using Cluster = std::unique_ptr<Entry[]>;
+
+    std::atomic<T*> mFreeList{nullptr};
+
+    /* Counts for containers currently taken from the pool, and the most that
+     * have been taken at once.
+     */
+    std::atomic<size_t> mInUse{0u};
+    std::atomic<size_t> mHighWater{0u};
+
+    std::mutex mClusterLock;
+    al::vector<Cluster> mClusters;
+    size_t mTotal{0u};
+
+    void addCluster(size_t count)
+    {
+        Cluster cluster{new Entry[count]};
+        for(size_t i{1};i < count;++i)
+            cluster[i-1].mItem.next.store(&cluster[i].mItem, std::memory_order_relaxed);
+
+        T *first{&cluster[0].mItem};
+        T *last{&cluster[count-1].mItem};
+        T *oldhead{mFreeList.load(std::memory_order_acquire)};
+        do {
+            last->next.store(oldhead, std::memory_order_relaxed);
+        } while(!mFreeList.compare_exchange_weak(oldhead, first, std::memory_order_acq_rel,
+            std::memory_order_acquire));
+
+        mClusters.emplace_back(std::move(cluster));
+        mTotal += count;
+    }
+
+public:
+    PropsPool() = default;
+    PropsPool(const PropsPool&) = delete;
+    PropsPool& operator=(const PropsPool&) = delete;
+
+    /** Allocates enough containers for the pool to hold at least count. */
+    void reserve(size_t count)
+    {
+        std::lock_guard<std::mutex> _{mClusterLock};
+        if(count > mTotal)
+            addCluster(count - mTotal);
+    }
+
+    /**
+     * Takes an unused container from the pool, allocating a new cluster if
+     * there are none. Must not be called by the mixer.
+     */
+    T *get()
+    {
+        /* Only one thread may pop from the free list at a time, or a
+         * container could be taken and put back between another thread
+         * reading the head's next pointer and replacing the head with it.
+         * Containers being put back concurrently don't need the lock.
+         */
+        std::lock_guard<std::mutex> _{mClusterLock};
+        T *item{mFreeList.load(std::memory_order_acquire)};
+        do {
+            if(!item)
+            {
+                addCluster(ClusterSize);
+                item = mFreeList.load(std::memory_order_acquire);
+            }
+        } while(!mFreeList.compare_exchange_weak(item, item->next.load(std::memory_order_relaxed),
+            std::memory_order_acq_rel, std::memory_order_acquire));
+
+        const size_t inuse{mInUse.fetch_add(1u, std::memory_order_relaxed) + 1u};
+        size_t highwater{mHighWater.load(std::memory_order_relaxed)};
+        while(inuse > highwater && !mHighWater.compare_exchange_weak(highwater, inuse,
+            std::memory_order_relaxed))
+        {
+        }
+        return item;
+    }
+
+    /** Returns a container to the pool. This is safe to call in the mixer. */
+    void put(T *item) noexcept
+    {
+        mInUse.fetch_sub(1u, std::memory_order_relaxed);
+        AtomicReplaceHead(mFreeList, item);
+    }
+
+    /** Calls func on each unused container in the pool. */
+    template<typename F>
+    void forEachFree(F&& func)
+    {
+        T *item{mFreeList.load(std::memory_order_acquire)};
+        while(item)
+        {
+            func(*item);
+            item = item->next.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t getHighWater() const noexcept { return mHighWater.load(std::memory_order_relaxed); }
+    size_t getTotal() noexcept
+    {
+        std::lock_guard<std::mutex> _{mClusterLock};
+        return mTotal;
+    }
+};
+
+#endif /* ALC_PROPPOOL_H */
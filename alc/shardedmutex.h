@@ -0,0 +1,57 @@
+#ifndef ALC_SHARDEDMUTEX_H
+#define ALC_SHARDEDMUTEX_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+
+
+/* A reader/writer lock split into a number of shards, each on its own cache
+ * line. Locking it exclusively locks every shard in order, so lock_guard and
+ * unique_lock work on it like any other mutex. A shared lock only takes one
+ * shard, picked by the calling thread, so readers on separate threads don't
+ * write to the same memory.
+ *
+ * Data that's partitioned by ID can instead be guarded by the shard for its
+ * ID, locked shared or exclusively. Such a lock must only use shard() or the
+ * whole lock, never lock_shared(), as the shard picked by the thread wouldn't
+ * exclude another thread holding the ID's shard.
+ */
+class ShardedSharedMutex {
+public:
+    static constexpr size_t NumShards{16};
+
+private:
+    struct alignas(64) Shard {
+        std::shared_timed_mutex mMutex;
+    };
+    std::array<Shard,NumShards> mShards;
+
+    static size_t threadShard() noexcept
+    {
+        static std::atomic<size_t> sNextShard{0u};
+        thread_local const size_t tShard{sNextShard.fetch_add(1u, std::memory_order_relaxed)
+            % NumShards};
+        return tShard;
+    }
+
+public:
+    void lock()
+    {
+        for(auto &shard : mShards)
+            shard.mMutex.lock();
+    }
+    void unlock()
+    {
+        for(auto iter = mShards.rbegin();iter != mShards.rend();++iter)
+            iter->mMutex.unlock();
+    }
+
+    void lock_shared() { mShards[threadShard()].mMutex.lock_shared(); }
+    void unlock_shared() { mShards[threadShard()].mMutex.unlock_shared(); }
+
+    std::shared_timed_mutex &shard(size_t id) noexcept { return mShards[id%NumShards].mMutex; }
+};
+
+#endif /* ALC_SHARDEDMUTEX_H */
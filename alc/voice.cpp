@@ -54,6 +54,7 @@
 #include "core/logging.h"
 #include "core/mixer/defs.h"
 #include "core/mixer/hrtfdefs.h"
+#include "core/trace.h"
 #include "hrtf.h"
 #include "inprogext.h"
 #include "opthelpers.h"
@@ -75,6 +76,8 @@ struct CopyTag;
 Resampler ResamplerDefault{Resampler::Linear};
 
 MixerFunc MixSamples{Mix_<CTag>};
+SparseMixerFunc MixSamplesSparse{MixSparse_<CTag>};
+MatrixMixerFunc MixMatrix{MixMatrix_<CTag>};
 
 namespace {
 
@@ -100,6 +103,32 @@ inline MixerFunc SelectMixer()
     return Mix_<CTag>;
 }
 
+inline SparseMixerFunc SelectSparseMixer()
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixSparse_<NEONTag>;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixSparse_<SSETag>;
+#endif
+    return MixSparse_<CTag>;
+}
+
+inline MatrixMixerFunc SelectMatrixMixer()
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixMatrix_<NEONTag>;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixMatrix_<SSETag>;
+#endif
+    return MixMatrix_<CTag>;
+}
+
 inline HrtfMixerFunc SelectHrtfMixer()
 {
 #ifdef HAVE_NEON
@@ -170,6 +199,8 @@ void aluInitMixer()
     }
 
     MixSamples = SelectMixer();
+    MixSamplesSparse = SelectSparseMixer();
+    MixMatrix = SelectMatrixMixer();
     MixHrtfBlendSamples = SelectHrtfBlendMixer();
     MixHrtfSamples = SelectHrtfMixer();
 }
@@ -179,6 +210,12 @@ namespace {
 
 void SendSourceStoppedEvent(ALCcontext *context, uint id)
 {
+    if(context->mEventQueueing.load(std::memory_order_acquire))
+    {
+        context->queueEventRecord(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, id, AL_STOPPED);
+        return;
+    }
+
     RingBuffer *ring{context->mAsyncEvents.get()};
     auto evt_vec = ring->getWriteVector();
     if(evt_vec.first.len < 1) return;
@@ -217,6 +254,69 @@ const float *DoFilters(BiquadFilter &lpfilter, BiquadFilter &hpfilter, float *ds
     return src.data();
 }
 
+/* The filters for one of a voice channel's output paths, and the samples to
+ * filter.
+ */
+struct FilterPath {
+    BiquadFilter *LowPass;
+    BiquadFilter *HighPass;
+    int Type;
+    const float *Src;
+};
+
+/* The most paths filtered together. A group of channels with a direct path
+ * and a send fills the lanes.
+ */
+constexpr size_t MaxFilterPaths{BiquadBank<2,8>::NumLanes};
+
+/* Filters the input for multiple paths at once, writing each path's output
+ * to the matching destination line. None of the paths may be AF_None.
+ */
+template<typename FilterBank>
+void DoFilterBank(const al::span<const FilterPath> paths, FloatBufferLine *dst,
+    const size_t count)
+{
+    constexpr size_t NumLanes{FilterBank::NumLanes};
+    ASSUME(paths.size() <= NumLanes);
+
+    FilterBank bank;
+    std::array<const float*,NumLanes> srclines;
+    std::array<float*,NumLanes> dstlines;
+    for(size_t j{0};j < NumLanes;++j)
+    {
+        /* Unused lanes filter with the first path again. Its history isn't
+         * stored back, so the result is simply ignored.
+         */
+        const FilterPath &path = paths[(j < paths.size()) ? j : 0];
+        if(path.Type == AF_HighPass)
+            bank.setPassthru(j, 0);
+        else
+            bank.load(j, 0, *path.LowPass);
+        if(path.Type == AF_LowPass)
+            bank.setPassthru(j, 1);
+        else
+            bank.load(j, 1, *path.HighPass);
+
+        srclines[j] = path.Src;
+        dstlines[j] = dst[j].data();
+    }
+
+    bank.process(srclines, dstlines, count);
+
+    for(size_t j{0};j < paths.size();++j)
+    {
+        const FilterPath &path = paths[j];
+        if(path.Type == AF_HighPass)
+            path.LowPass->clear();
+        else
+            bank.store(j, 0, *path.LowPass);
+        if(path.Type == AF_LowPass)
+            path.HighPass->clear();
+        else
+            bank.store(j, 1, *path.HighPass);
+    }
+}
+
 
 void LoadSamples(float *RESTRICT dst, const al::byte *src, const size_t srcstep, FmtType srctype,
     const size_t samples) noexcept
@@ -402,36 +502,43 @@ void DoHrtfMix(const float *samples, const uint DstBufferSize, DirectParams &par
 void DoNfcMix(const al::span<const float> samples, FloatBufferLine *OutBuffer, DirectParams &parms,
     const float *TargetGains, const uint Counter, const uint OutPos, ALCdevice *Device)
 {
-    using FilterProc = void (NfcFilter::*)(const al::span<const float>, float*);
-    static constexpr FilterProc NfcProcess[MaxAmbiOrder+1]{
-        nullptr, &NfcFilter::process1, &NfcFilter::process2, &NfcFilter::process3};
-
     float *CurrentGains{parms.Gains.Current.data()};
     MixSamples(samples, {OutBuffer, 1u}, CurrentGains, TargetGains, Counter, OutPos);
     ++OutBuffer;
     ++CurrentGains;
     ++TargetGains;
 
-    const al::span<float> nfcsamples{Device->NfcSampleData, samples.size()};
-    size_t order{1};
-    while(const size_t chancount{Device->NumChannelsPerOrder[order]})
+    /* Filter all the used orders together, then mix each of them. */
+    std::array<float*,MaxAmbiOrder> nfcsamples;
+    size_t numorders{0};
+    while(numorders < MaxAmbiOrder && Device->NumChannelsPerOrder[numorders+1] > 0)
     {
-        (parms.NFCtrlFilter.*NfcProcess[order])(samples, nfcsamples.data());
-        MixSamples(nfcsamples, {OutBuffer, chancount}, CurrentGains, TargetGains, Counter, OutPos);
+        nfcsamples[numorders] = Device->NfcSampleData[numorders].data();
+        ++numorders;
+    }
+    parms.NFCtrlFilter.process(samples, {nfcsamples.data(), numorders});
+
+    for(size_t i{0};i < numorders;++i)
+    {
+        const size_t chancount{Device->NumChannelsPerOrder[i+1]};
+        MixSamples({nfcsamples[i], samples.size()}, {OutBuffer, chancount}, CurrentGains,
+            TargetGains, Counter, OutPos);
         OutBuffer += chancount;
         CurrentGains += chancount;
         TargetGains += chancount;
-        if(++order == MaxAmbiOrder+1)
-            break;
     }
 }
 
 } // namespace
 
+Voice::~Voice() = default;
+
 void Voice::mix(const State vstate, ALCcontext *Context, const uint SamplesToDo)
 {
     static constexpr std::array<float,MAX_OUTPUT_CHANNELS> SilentTarget{};
 
+    TraceScope trace{gTraceVoices, "Voice::mix", "source", mSourceID.load(std::memory_order_relaxed)};
+
     ASSUME(SamplesToDo > 0);
 
     /* Get voice info */
@@ -454,9 +561,16 @@ void Voice::mix(const State vstate, ALCcontext *Context, const uint SamplesToDo)
 
     ASSUME(SampleSize > 0);
 
-    const size_t FrameSize{mChans.size() * SampleSize};
+    /* The number of channels in the buffer, which may differ from the number
+     * being mixed if it gets decoded.
+     */
+    const size_t NumChannels{ChannelsFromFmt(mFmtChannels, mAmbiOrder)};
+    const size_t FrameSize{NumChannels * SampleSize};
     ASSUME(FrameSize > 0);
 
+    /* UHJ decoding needs to look ahead of the samples being decoded. */
+    const uint DecodePadding{mDecoder ? uint{UhjDecoder::sFilterDelay} : 0u};
+
     ALCdevice *Device{Context->mDevice.get()};
     const uint NumSends{Device->NumAuxSends};
     const uint IrSize{Device->mIrSize};
@@ -542,7 +656,7 @@ void Voice::mix(const State vstate, ALCcontext *Context, const uint SamplesToDo)
         if((mFlags&(VoiceIsCallback|VoiceCallbackStopped)) == VoiceIsCallback && BufferListItem)
         {
             /* Exclude resampler pre-padding from the needed size. */
-            const uint toLoad{SrcBufferSize - (MaxResamplerPadding>>1)};
+            const uint toLoad{SrcBufferSize - (MaxResamplerPadding>>1) + DecodePadding};
             if(toLoad > mNumCallbackSamples)
             {
                 const size_t byteOffset{mNumCallbackSamples*FrameSize};
@@ -563,109 +677,238 @@ void Voice::mix(const State vstate, ALCcontext *Context, const uint SamplesToDo)
             }
         }
 
-        const size_t num_chans{mChans.size()};
-        size_t chan_idx{0};
-        ASSUME(DstBufferSize > 0);
-        for(auto &chandata : mChans)
+        if(mDecoder && BufferListItem)
         {
-            const al::span<float> SrcData{Device->SourceData, SrcBufferSize};
-
-            /* Load the previous samples into the source data first, then load
-             * what we can from the buffer queue.
+            /* Load and decode all the UHJ channels up front, since each output
+             * channel depends on every input channel.
              */
-            auto srciter = std::copy_n(chandata.mPrevSamples.begin(), MaxResamplerPadding>>1,
-                SrcData.begin());
-
-            if UNLIKELY(!BufferListItem)
+            const size_t toDecode{SrcBufferSize - (MaxResamplerPadding>>1)};
+            const size_t toLoad{toDecode + DecodePadding};
+            for(size_t chan{0};chan < NumChannels;++chan)
             {
-                /* When loading from a voice that ended prematurely, only take
-                 * the samples that get closest to 0 amplitude. This helps
-                 * certain sounds fade out better.
-                 */
-                auto abs_lt = [](const float lhs, const float rhs) noexcept -> bool
-                { return std::abs(lhs) < std::abs(rhs); };
-                auto input = chandata.mPrevSamples.begin() + (MaxResamplerPadding>>1);
-                auto in_end = std::min_element(input, chandata.mPrevSamples.end(), abs_lt);
-                srciter = std::copy(input, in_end, srciter);
+                const al::span<float> SrcData{mDecodeSamples[chan].data(), toLoad};
+                float *srciter;
+                if((mFlags&VoiceIsStatic))
+                    srciter = LoadBufferStatic(BufferListItem, BufferLoopItem, NumChannels,
+                        SampleType, SampleSize, chan, DataPosInt, SrcData);
+                else if((mFlags&VoiceIsCallback))
+                    srciter = LoadBufferCallback(BufferListItem, NumChannels, SampleType,
+                        SampleSize, chan, mNumCallbackSamples, SrcData);
+                else
+                    srciter = LoadBufferQueue(BufferListItem, BufferLoopItem, NumChannels,
+                        SampleType, SampleSize, chan, DataPosInt, SrcData);
+                /* Silence anything past the end for the decoder to look at. */
+                std::fill(srciter, SrcData.end(), 0.0f);
             }
-            else if((mFlags&VoiceIsStatic))
-                srciter = LoadBufferStatic(BufferListItem, BufferLoopItem, num_chans, SampleType,
-                    SampleSize, chan_idx, DataPosInt, {srciter, SrcData.end()});
-            else if((mFlags&VoiceIsCallback))
-                srciter = LoadBufferCallback(BufferListItem, num_chans, SampleType, SampleSize,
-                    chan_idx, mNumCallbackSamples, {srciter, SrcData.end()});
-            else
-                srciter = LoadBufferQueue(BufferListItem, BufferLoopItem, num_chans, SampleType,
-                    SampleSize, chan_idx, DataPosInt, {srciter, SrcData.end()});
 
-            if UNLIKELY(srciter != SrcData.end())
+            /* The next update starts where the resampler's history does. */
+            const size_t SrcSamplesDone{(increment*DstBufferSize + DataPosFrac)>>MixerFracBits};
+            float *samples[3]{mDecodeSamples[0].data(), mDecodeSamples[1].data(),
+                mDecodeSamples[2].data()};
+            mDecoder->decode(samples, toDecode, SrcSamplesDone);
+        }
+
+        /* Multichannel voices are resampled in groups of channels, so the
+         * group's paths can be filtered together, and ambisonic channels can
+         * have their high-frequency scaling applied together.
+         */
+        constexpr size_t MaxGroupSize{BandSplitterBank::NumLanes};
+        const size_t GroupSize{(mChans.size() > 1) ? MaxGroupSize : 1u};
+        ASSUME(DstBufferSize > 0);
+        for(size_t chan_base{0};chan_base < mChans.size();chan_base += GroupSize)
+        {
+            const size_t NumGroupChans{minz(mChans.size()-chan_base, GroupSize)};
+            std::array<float*,MaxGroupSize> ResampledLines;
+            for(size_t group_idx{0};group_idx < NumGroupChans;++group_idx)
             {
-                /* If the source buffer wasn't filled, copy the last sample for
-                 * the remaining buffer. Ideally it should have ended with
-                 * silence, but if not the gain fading should help avoid clicks
-                 * from sudden amplitude changes.
+                const size_t chan_idx{chan_base + group_idx};
+                ChannelData &chandata = mChans[chan_idx];
+                const al::span<float> SrcData{Device->SourceData, SrcBufferSize};
+
+                /* Load the previous samples into the source data first, then load
+                 * what we can from the buffer queue.
                  */
-                const float sample{*(srciter-1)};
-                std::fill(srciter, SrcData.end(), sample);
-            }
+                auto srciter = std::copy_n(chandata.mPrevSamples.begin(), MaxResamplerPadding>>1,
+                    SrcData.begin());
 
-            /* Store the last source samples used for next time. */
-            std::copy_n(&SrcData[(increment*DstBufferSize + DataPosFrac)>>MixerFracBits],
-                chandata.mPrevSamples.size(), chandata.mPrevSamples.begin());
+                if UNLIKELY(!BufferListItem)
+                {
+                    /* When loading from a voice that ended prematurely, only take
+                     * the samples that get closest to 0 amplitude. This helps
+                     * certain sounds fade out better.
+                     */
+                    auto abs_lt = [](const float lhs, const float rhs) noexcept -> bool
+                    { return std::abs(lhs) < std::abs(rhs); };
+                    auto input = chandata.mPrevSamples.begin() + (MaxResamplerPadding>>1);
+                    auto in_end = std::min_element(input, chandata.mPrevSamples.end(), abs_lt);
+                    srciter = std::copy(input, in_end, srciter);
+                }
+                else if(mDecoder)
+                    srciter = std::copy_n(mDecodeSamples[chan_idx].cbegin(),
+                        std::distance(srciter, SrcData.end()), srciter);
+                else if((mFlags&VoiceIsStatic))
+                    srciter = LoadBufferStatic(BufferListItem, BufferLoopItem, NumChannels, SampleType,
+                        SampleSize, chan_idx, DataPosInt, {srciter, SrcData.end()});
+                else if((mFlags&VoiceIsCallback))
+                    srciter = LoadBufferCallback(BufferListItem, NumChannels, SampleType, SampleSize,
+                        chan_idx, mNumCallbackSamples, {srciter, SrcData.end()});
+                else
+                    srciter = LoadBufferQueue(BufferListItem, BufferLoopItem, NumChannels, SampleType,
+                        SampleSize, chan_idx, DataPosInt, {srciter, SrcData.end()});
 
-            /* Resample, then apply ambisonic upsampling as needed. */
-            float *ResampledData{Resample(&mResampleState, &SrcData[MaxResamplerPadding>>1],
-                DataPosFrac, increment, {Device->ResampledData, DstBufferSize})};
-            if((mFlags&VoiceIsAmbisonic))
-                chandata.mAmbiSplitter.processHfScale({ResampledData, DstBufferSize},
-                    chandata.mAmbiScale);
+                if UNLIKELY(srciter != SrcData.end())
+                {
+                    /* If the source buffer wasn't filled, copy the last sample for
+                     * the remaining buffer. Ideally it should have ended with
+                     * silence, but if not the gain fading should help avoid clicks
+                     * from sudden amplitude changes.
+                     */
+                    const float sample{*(srciter-1)};
+                    std::fill(srciter, SrcData.end(), sample);
+                }
 
-            /* Now filter and mix to the appropriate outputs. */
-            float (&FilterBuf)[BufferLineSize] = Device->FilteredData;
-            {
-                DirectParams &parms = chandata.mDryParams;
-                const float *samples{DoFilters(parms.LowPass, parms.HighPass, FilterBuf,
-                    {ResampledData, DstBufferSize}, mDirect.FilterType)};
+                /* Store the last source samples used for next time. */
+                std::copy_n(&SrcData[(increment*DstBufferSize + DataPosFrac)>>MixerFracBits],
+                    chandata.mPrevSamples.size(), chandata.mPrevSamples.begin());
 
-                if((mFlags&VoiceHasHrtf))
+
+                /* Resample. A grouped channel needs its own line, since the
+                 * resampler may return the source data as-is, and that gets
+                 * overwritten by the next channel's.
+                 */
+                float *ResampleDst{(GroupSize > 1) ? Device->GroupResampledData[group_idx].data()
+                    : Device->ResampledData};
+                float *ResampledData{Resample(&mResampleState, &SrcData[MaxResamplerPadding>>1],
+                    DataPosFrac, increment, {ResampleDst, DstBufferSize})};
+                if(GroupSize > 1 && ResampledData != ResampleDst)
                 {
-                    const float TargetGain{UNLIKELY(vstate == Stopping) ? 0.0f :
-                        parms.Hrtf.Target.Gain};
-                    DoHrtfMix(samples, DstBufferSize, parms, TargetGain, Counter, OutPos, IrSize,
-                        Device);
+                    std::copy_n(ResampledData, DstBufferSize, ResampleDst);
+                    ResampledData = ResampleDst;
                 }
-                else if((mFlags&VoiceHasNfc))
+                ResampledLines[group_idx] = ResampledData;
+            }
+
+            /* Apply ambisonic upsampling as needed. If there's fewer channels
+             * than lanes left, the unused lanes repeat the first channel,
+             * writing back the same result for it.
+             */
+            if((mFlags&VoiceIsAmbisonic))
+            {
+                BandSplitterBank splitters;
+                BandSplitterBank::LaneArray hfscales;
+                for(size_t j{NumGroupChans};j < MaxGroupSize;++j)
+                    ResampledLines[j] = ResampledLines[0];
+                for(size_t j{0};j < MaxGroupSize;++j)
                 {
-                    const float *TargetGains{UNLIKELY(vstate == Stopping) ? SilentTarget.data()
-                        : parms.Gains.Target.data()};
-                    DoNfcMix({samples, DstBufferSize}, mDirect.Buffer.data(), parms, TargetGains,
-                        Counter, OutPos, Device);
+                    const ChannelData &chandata = mChans[chan_base + ((j < NumGroupChans) ? j : 0)];
+                    splitters.load(j, chandata.mAmbiSplitter);
+                    hfscales[j] = chandata.mAmbiScale;
+                }
+                splitters.processHfScale(ResampledLines, hfscales, DstBufferSize);
+                for(size_t j{0};j < NumGroupChans;++j)
+                    splitters.store(j, mChans[chan_base+j].mAmbiSplitter);
+            }
+
+            /* Now filter and mix to the appropriate outputs. Path 0 is the
+             * direct path, and each send follows.
+             */
+            auto mix_path = [&](ChannelData &chandata, const uint path, const float *samples)
+            {
+                if(path == 0)
+                {
+                    DirectParams &parms = chandata.mDryParams;
+                    if((mFlags&VoiceHasHrtf))
+                    {
+                        const float TargetGain{UNLIKELY(vstate == Stopping) ? 0.0f :
+                            parms.Hrtf.Target.Gain};
+                        DoHrtfMix(samples, DstBufferSize, parms, TargetGain, Counter, OutPos,
+                            IrSize, Device);
+                    }
+                    else if((mFlags&VoiceHasNfc))
+                    {
+                        const float *TargetGains{UNLIKELY(vstate == Stopping) ?
+                            SilentTarget.data() : parms.Gains.Target.data()};
+                        DoNfcMix({samples, DstBufferSize}, mDirect.Buffer.data(), parms,
+                            TargetGains, Counter, OutPos, Device);
+                    }
+                    else
+                    {
+                        const float *TargetGains{UNLIKELY(vstate == Stopping) ?
+                            SilentTarget.data() : parms.Gains.Target.data()};
+                        MixSamplesSparse({samples, DstBufferSize}, mDirect.Buffer,
+                            parms.Gains.Current.data(), TargetGains, parms.Gains.getActive(),
+                            Counter, OutPos);
+                    }
                 }
                 else
                 {
+                    SendParams &parms = chandata.mWetParams[path-1];
                     const float *TargetGains{UNLIKELY(vstate == Stopping) ? SilentTarget.data()
                         : parms.Gains.Target.data()};
-                    MixSamples({samples, DstBufferSize}, mDirect.Buffer,
-                        parms.Gains.Current.data(), TargetGains, Counter, OutPos);
+                    MixSamplesSparse({samples, DstBufferSize}, mSend[path-1].Buffer,
+                        parms.Gains.Current.data(), TargetGains, parms.Gains.getActive(), Counter,
+                        OutPos);
                 }
-            }
+            };
 
-            for(uint send{0};send < NumSends;++send)
+            /* Paths that need filtering are collected across the group's
+             * channels, to be filtered together in the lanes of a filter bank.
+             */
+            FilterPath FilterPaths[MaxFilterPaths];
+            std::pair<ChannelData*,uint> FilterPathIds[MaxFilterPaths];
+            size_t NumFilterPaths{0};
+            auto flush_paths = [&]()
             {
-                if(mSend[send].Buffer.empty())
-                    continue;
-
-                SendParams &parms = chandata.mWetParams[send];
-                const float *samples{DoFilters(parms.LowPass, parms.HighPass, FilterBuf,
-                    {ResampledData, DstBufferSize}, mSend[send].FilterType)};
+                FloatBufferLine *FilterBufs{Device->FilteredData};
+                if(NumFilterPaths == 1)
+                {
+                    const FilterPath &fpath = FilterPaths[0];
+                    DoFilters(*fpath.LowPass, *fpath.HighPass, FilterBufs[0].data(),
+                        {fpath.Src, DstBufferSize}, fpath.Type);
+                }
+                else if(NumFilterPaths <= BiquadBank<2>::NumLanes)
+                    DoFilterBank<BiquadBank<2>>({FilterPaths, NumFilterPaths}, FilterBufs,
+                        DstBufferSize);
+                else
+                    DoFilterBank<BiquadBank<2,MaxFilterPaths>>({FilterPaths, NumFilterPaths},
+                        FilterBufs, DstBufferSize);
+                for(size_t i{0};i < NumFilterPaths;++i)
+                    mix_path(*FilterPathIds[i].first, FilterPathIds[i].second,
+                        FilterBufs[i].data());
+                NumFilterPaths = 0;
+            };
+            for(size_t group_idx{0};group_idx < NumGroupChans;++group_idx)
+            {
+                ChannelData &chandata = mChans[chan_base + group_idx];
+                float *ResampledData{ResampledLines[group_idx]};
 
-                const float *TargetGains{UNLIKELY(vstate == Stopping) ? SilentTarget.data()
-                    : parms.Gains.Target.data()};
-                MixSamples({samples, DstBufferSize}, mSend[send].Buffer,
-                    parms.Gains.Current.data(), TargetGains, Counter, OutPos);
+                for(uint path{0};path <= NumSends;++path)
+                {
+                    if(path > 0 && mSend[path-1].Buffer.empty())
+                        continue;
+
+                    BiquadFilter &lpfilter = (path == 0) ? chandata.mDryParams.LowPass
+                        : chandata.mWetParams[path-1].LowPass;
+                    BiquadFilter &hpfilter = (path == 0) ? chandata.mDryParams.HighPass
+                        : chandata.mWetParams[path-1].HighPass;
+                    const int type{(path == 0) ? mDirect.FilterType : mSend[path-1].FilterType};
+                    if(type == AF_None)
+                    {
+                        lpfilter.clear();
+                        hpfilter.clear();
+                        mix_path(chandata, path, ResampledData);
+                        continue;
+                    }
+
+                    FilterPaths[NumFilterPaths] = FilterPath{&lpfilter, &hpfilter, type,
+                        ResampledData};
+                    FilterPathIds[NumFilterPaths] = {&chandata, path};
+                    if(++NumFilterPaths == MaxFilterPaths)
+                        flush_paths();
+                }
             }
-
-            ++chan_idx;
+            if(NumFilterPaths > 0)
+                flush_paths();
         }
         /* Update positions */
         DataPosFrac += increment*DstBufferSize;
@@ -748,28 +991,37 @@ void Voice::mix(const State vstate, ALCcontext *Context, const uint SamplesToDo)
     const uint SourceID{mSourceID.load(std::memory_order_relaxed)};
 
     /* Update voice info */
+    beginPositionChange();
     mPosition.store(DataPosInt, std::memory_order_relaxed);
     mPositionFrac.store(DataPosFrac, std::memory_order_relaxed);
     mCurrentBuffer.store(BufferListItem, std::memory_order_relaxed);
+    mPositionClock.store(Device->mMixEndTime.count(), std::memory_order_relaxed);
     if(!BufferListItem)
     {
         mLoopBuffer.store(nullptr, std::memory_order_relaxed);
         mSourceID.store(0u, std::memory_order_relaxed);
     }
+    endPositionChange();
     std::atomic_thread_fence(std::memory_order_release);
 
     /* Send any events now, after the position/buffer info was updated. */
     const uint enabledevt{Context->mEnabledEvts.load(std::memory_order_acquire)};
     if(buffers_done > 0 && (enabledevt&EventType_BufferCompleted))
     {
-        RingBuffer *ring{Context->mAsyncEvents.get()};
-        auto evt_vec = ring->getWriteVector();
-        if(evt_vec.first.len > 0)
+        if(Context->mEventQueueing.load(std::memory_order_acquire))
+            Context->queueEventRecord(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, SourceID,
+                buffers_done);
+        else
         {
-            AsyncEvent *evt{::new(evt_vec.first.buf) AsyncEvent{EventType_BufferCompleted}};
-            evt->u.bufcomp.id = SourceID;
-            evt->u.bufcomp.count = buffers_done;
-            ring->writeAdvance(1);
+            RingBuffer *ring{Context->mAsyncEvents.get()};
+            auto evt_vec = ring->getWriteVector();
+            if(evt_vec.first.len > 0)
+            {
+                AsyncEvent *evt{::new(evt_vec.first.buf) AsyncEvent{EventType_BufferCompleted}};
+                evt->u.bufcomp.id = SourceID;
+                evt->u.bufcomp.count = buffers_done;
+                ring->writeAdvance(1);
+            }
         }
     }
 
@@ -3,6 +3,10 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 
 #include "almalloc.h"
 #include "alspan.h"
@@ -15,6 +19,7 @@
 #include "core/filters/splitter.h"
 #include "core/mixer/defs.h"
 #include "core/mixer/hrtfdefs.h"
+#include "core/uhjfilter.h"
 #include "vector.h"
 
 struct ALCcontext;
@@ -45,6 +50,34 @@ enum {
 };
 
 
+/* The gains for mixing a voice channel to each output channel. */
+struct MixGains {
+    std::array<float,MAX_OUTPUT_CHANNELS> Current;
+    std::array<float,MAX_OUTPUT_CHANNELS> Target;
+
+    /* The output channels with an audible current or target gain, which are
+     * the only ones that need to be mixed.
+     */
+    std::array<uint8_t,MAX_OUTPUT_CHANNELS> ActiveChans;
+    uint NumActive;
+
+    al::span<const uint8_t> getActive() const noexcept { return {ActiveChans.data(), NumActive}; }
+
+    /* Updates the active channel list for the given number of outputs. Should
+     * be called after setting new target gains.
+     */
+    void updateActive(const size_t numchans) noexcept
+    {
+        NumActive = 0;
+        for(size_t c{0};c < numchans;++c)
+        {
+            if(std::abs(Current[c]) > GainSilenceThreshold
+                || std::abs(Target[c]) > GainSilenceThreshold)
+                ActiveChans[NumActive++] = static_cast<uint8_t>(c);
+        }
+    }
+};
+
 struct DirectParams {
     BiquadFilter LowPass;
     BiquadFilter HighPass;
@@ -57,20 +90,58 @@ struct DirectParams {
         alignas(16) std::array<float,HrtfHistoryLength> History;
     } Hrtf;
 
-    struct {
-        std::array<float,MAX_OUTPUT_CHANNELS> Current;
-        std::array<float,MAX_OUTPUT_CHANNELS> Target;
-    } Gains;
+    MixGains Gains;
 };
 
 struct SendParams {
     BiquadFilter LowPass;
     BiquadFilter HighPass;
 
-    struct {
-        std::array<float,MAX_OUTPUT_CHANNELS> Current;
-        std::array<float,MAX_OUTPUT_CHANNELS> Target;
-    } Gains;
+    MixGains Gains;
+};
+
+
+/* Mixing parameters calculated from a voice's properties, to be applied to the
+ * voice as its new targets.
+ */
+struct VoiceMixParams {
+    uint mStep;
+    ResamplerFunc mResampler;
+    InterpState mResampleState;
+
+    /* VoiceHasHrtf and VoiceHasNfc, as needed. */
+    uint mFlags;
+
+    /* The NFC filter control coefficient, and the number of channels (from
+     * the first) to adjust with it.
+     */
+    float mNfcW0;
+    uint mNfcChannels;
+
+    struct TargetParams {
+        int FilterType;
+        al::span<FloatBufferLine> Buffer;
+
+        /* The filter coefficients for every channel. */
+        BiquadFilter LowPass;
+        BiquadFilter HighPass;
+    };
+    TargetParams mDirect;
+    std::array<TargetParams,MAX_SENDS> mSend;
+
+    struct ChannelParams {
+        HrtfFilter HrtfTarget;
+        std::array<float,MAX_OUTPUT_CHANNELS> DryGains;
+        std::array<std::array<float,MAX_OUTPUT_CHANNELS>,MAX_SENDS> WetGains;
+    };
+    al::FlexArray<ChannelParams> mChans;
+
+    VoiceMixParams(size_t numchans) : mChans{numchans} { }
+
+    static std::unique_ptr<VoiceMixParams> Create(size_t numchans)
+    { return std::unique_ptr<VoiceMixParams>{new(FamCount(numchans)) VoiceMixParams{numchans}}; }
+
+    DEF_FAM_NEWDEL(VoiceMixParams, mChans)
 };
 
 
@@ -144,6 +215,17 @@ struct VoiceProps {
 struct VoicePropsItem : public VoiceProps {
     std::atomic<VoicePropsItem*> next{nullptr};
 
+    /* Mixing parameters calculated outside of the mixer, if mHasMixParams is
+     * set, and the stamps of the context, listener, and effect slot updates
+     * they were calculated with.
+     */
+    std::unique_ptr<VoiceMixParams> mMixParams;
+    bool mHasMixParams{false};
+    uint mContextStamp{0u};
+    uint mListenerStamp{0u};
+    uint mListenerPoseStamp{0u};
+    std::array<uint,MAX_SENDS> mSlotStamps{};
+
     DEF_NEWDEL(VoicePropsItem)
 };
 
@@ -163,6 +245,9 @@ struct Voice {
         Pending
     };
 
+    /* The pending property update. This is owned by the context's property
+     * pool, which cleans it up.
+     */
     std::atomic<VoicePropsItem*> mUpdate{nullptr};
 
     VoiceProps mProps;
@@ -187,6 +272,15 @@ struct Voice {
      */
     std::atomic<VoiceBufferItem*> mLoopBuffer;
 
+    /* Sequence count for the mixer's changes to the source ID, position, and
+     * current buffer, which is odd while they're being changed. Readers check
+     * it before and after reading them, and retry if it was odd or changed,
+     * rather than waiting for the mixer to finish.
+     */
+    std::atomic<uint> mPositionSeq{0u};
+    /* The device clock time the mixer last updated the position for. */
+    std::atomic<std::chrono::nanoseconds::rep> mPositionClock{0};
+
     /* Properties for the attached buffer(s). */
     FmtChannels mFmtChannels;
     FmtType mFmtType;
@@ -224,8 +318,27 @@ struct Voice {
     };
     al::vector<ChannelData> mChans{2};
 
+    /* UHJ sources are decoded to B-Format prior to resampling, with storage
+     * for the loaded and decoded samples of each channel.
+     */
+    using DecodeBufferLine = std::array<float,UhjDecoder::sMaxSamples+UhjDecoder::sFilterDelay>;
+    std::unique_ptr<UhjDecoder> mDecoder;
+    al::vector<DecodeBufferLine,16> mDecodeSamples;
+
     Voice() = default;
-    ~Voice() { delete mUpdate.exchange(nullptr, std::memory_order_acq_rel); }
+    ~Voice();
+
+    void beginPositionChange() noexcept
+    {
+        mPositionSeq.store(mPositionSeq.load(std::memory_order_relaxed)+1u,
+            std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void endPositionChange() noexcept
+    {
+        mPositionSeq.store(mPositionSeq.load(std::memory_order_relaxed)+1u,
+            std::memory_order_release);
+    }
 
     Voice(const Voice&) = delete;
     Voice& operator=(const Voice&) = delete;
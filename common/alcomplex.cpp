@@ -13,7 +13,10 @@
 #include "math_defs.h"
 
 
-void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
+namespace {
+
+template<typename Real>
+void fft_impl(const al::span<std::complex<Real>> buffer, const double sign)
 {
     const size_t fftsize{buffer.size()};
     /* Get the number of bits used for indexing. Simplifies bit-reversal and
@@ -35,7 +38,10 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
             std::swap(buffer[idx], buffer[revidx]);
     }
 
-    /* Iterative form of Danielson-Lanczos lemma */
+    /* Iterative form of Danielson-Lanczos lemma. The twiddle factors are
+     * always stepped in double precision to avoid accumulating error with
+     * float buffers.
+     */
     size_t step2{1u};
     for(size_t i{0};i < log2_size;++i)
     {
@@ -46,9 +52,13 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
         const size_t step{step2 << 1};
         for(size_t j{0};j < step2;j++)
         {
+            const Real ur{static_cast<Real>(u.real())};
+            const Real ui{static_cast<Real>(u.imag())};
             for(size_t k{j};k < fftsize;k+=step)
             {
-                std::complex<double> temp{buffer[k+step2] * u};
+                const std::complex<Real> odd{buffer[k+step2]};
+                const std::complex<Real> temp{odd.real()*ur - odd.imag()*ui,
+                    odd.real()*ui + odd.imag()*ur};
                 buffer[k+step2] = buffer[k] - temp;
                 buffer[k] += temp;
             }
@@ -60,6 +70,86 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
     }
 }
 
+} // namespace
+
+void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
+{ fft_impl(buffer, sign); }
+
+void complex_fft(const al::span<std::complex<float>> buffer, const float sign)
+{ fft_impl(buffer, sign); }
+
+/* The real FFTs pack the even and odd samples into the real and imaginary
+ * parts of a half-size complex signal, and use the conjugate symmetry of the
+ * even and odd components' responses to separate (or combine) them.
+ */
+void forward_real_fft(const al::span<const float> input,
+    const al::span<std::complex<float>> output)
+{
+    const size_t half{input.size() >> 1};
+
+    for(size_t i{0};i < half;++i)
+        output[i] = std::complex<float>{input[i*2], input[i*2 + 1]};
+    forward_fft(output.first(half));
+
+    const std::complex<float> z0{output[0]};
+    output[0] = std::complex<float>{z0.real() + z0.imag(), 0.0f};
+    output[half] = std::complex<float>{z0.real() - z0.imag(), 0.0f};
+
+    const double arg{al::MathDefs<double>::Pi() / static_cast<double>(half)};
+    const std::complex<double> w{std::cos(arg), -std::sin(arg)};
+    std::complex<double> u{w};
+    for(size_t k{1};k <= half/2;++k)
+    {
+        const std::complex<float> zk{output[k]}, zn{std::conj(output[half-k])};
+        const std::complex<float> even{(zk + zn) * 0.5f};
+        const std::complex<float> odd{(zk - zn) * std::complex<float>{0.0f, -0.5f}};
+        const std::complex<float> uf{static_cast<float>(u.real()), static_cast<float>(u.imag())};
+        const std::complex<float> todd{odd.real()*uf.real() - odd.imag()*uf.imag(),
+            odd.real()*uf.imag() + odd.imag()*uf.real()};
+
+        /* X[k] = E[k] + W^k*O[k], and X[N/2-k] = conj(E[k] - W^k*O[k]). */
+        output[k] = even + todd;
+        output[half-k] = std::conj(even - todd);
+
+        u *= w;
+    }
+}
+
+void inverse_real_fft(const al::span<std::complex<float>> input, const al::span<float> output)
+{
+    const size_t half{output.size() >> 1};
+
+    const float dc{input[0].real()}, nyq{input[half].real()};
+    input[0] = std::complex<float>{dc + nyq, dc - nyq};
+
+    const double arg{al::MathDefs<double>::Pi() / static_cast<double>(half)};
+    const std::complex<double> w{std::cos(arg), std::sin(arg)};
+    std::complex<double> u{w};
+    for(size_t k{1};k <= half/2;++k)
+    {
+        const std::complex<float> xk{input[k]}, xn{std::conj(input[half-k])};
+        const std::complex<float> even{xk + xn};
+        const std::complex<float> diff{xk - xn};
+        const std::complex<float> uf{static_cast<float>(u.real()), static_cast<float>(u.imag())};
+        const std::complex<float> odd{diff.real()*uf.real() - diff.imag()*uf.imag(),
+            diff.real()*uf.imag() + diff.imag()*uf.real()};
+
+        /* Z[k] = E[k] + i*O[k], and Z[N/2-k] = conj(E[k] - i*O[k]). */
+        const std::complex<float> iodd{-odd.imag(), odd.real()};
+        input[k] = even + iodd;
+        input[half-k] = std::conj(even - iodd);
+
+        u *= w;
+    }
+    inverse_fft(input.first(half));
+
+    for(size_t i{0};i < half;++i)
+    {
+        output[i*2] = input[i].real();
+        output[i*2 + 1] = input[i].imag();
+    }
+}
+
 void complex_hilbert(const al::span<std::complex<double>> buffer)
 {
     inverse_fft(buffer);
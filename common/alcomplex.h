@@ -11,6 +11,7 @@
  * the data supplied in the buffer, which MUST BE power of two.
  */
 void complex_fft(const al::span<std::complex<double>> buffer, const double sign);
+void complex_fft(const al::span<std::complex<float>> buffer, const float sign);
 
 /**
  * Calculate the frequency-domain response of the time-domain signal in the
@@ -18,6 +19,8 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
  */
 inline void forward_fft(const al::span<std::complex<double>> buffer)
 { complex_fft(buffer, -1.0); }
+inline void forward_fft(const al::span<std::complex<float>> buffer)
+{ complex_fft(buffer, -1.0f); }
 
 /**
  * Calculate the time-domain signal of the frequency-domain response in the
@@ -25,6 +28,26 @@ inline void forward_fft(const al::span<std::complex<double>> buffer)
  */
 inline void inverse_fft(const al::span<std::complex<double>> buffer)
 { complex_fft(buffer, 1.0); }
+inline void inverse_fft(const al::span<std::complex<float>> buffer)
+{ complex_fft(buffer, 1.0f); }
+
+/**
+ * Calculate the frequency-domain response of the real time-domain signal in
+ * the input buffer, using a complex FFT of half the size. The input size MUST
+ * BE power of two (at least 4), and the output receives the size/2 + 1 non-
+ * mirrored frequency bins (DC to Nyquist).
+ */
+void forward_real_fft(const al::span<const float> input,
+    const al::span<std::complex<float>> output);
+
+/**
+ * Calculate the real time-domain signal of the size/2 + 1 non-mirrored
+ * frequency bins in the input buffer, which is used as scratch space and left
+ * in an undefined state. The output size MUST BE power of two (at least 4).
+ * As with inverse_fft, the result is not normalized and is scaled up by the
+ * output size.
+ */
+void inverse_real_fft(const al::span<std::complex<float>> input, const al::span<float> output);
 
 /**
  * Calculate the complex helical sequence (discrete-time analytical signal) of
@@ -3,9 +3,16 @@
 
 #include "biquad.h"
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <type_traits>
 
 #include "opthelpers.h"
 
@@ -161,3 +168,200 @@ void BiquadFilterR<Real>::dualProcess(BiquadFilterR &other, const al::span<const
 
 template class BiquadFilterR<float>;
 template class BiquadFilterR<double>;
+
+
+namespace {
+
+/* Calls the given function with each index from 0 to N-1 as a compile-time
+ * constant. The vector loops below rely on this so the compiler keeps each
+ * lane group's filter history in its own register, rather than in a stack
+ * array it would need to index at run-time.
+ */
+template<size_t N>
+struct Unroll {
+    template<typename F>
+    static inline void run(F&& f)
+    {
+        Unroll<N-1>::run(f);
+        f(std::integral_constant<size_t,N-1>{});
+    }
+};
+template<>
+struct Unroll<0> {
+    template<typename F>
+    static inline void run(F&&) { }
+};
+
+} // namespace
+
+template<size_t NumStages, size_t Lanes>
+void BiquadBank<NumStages,Lanes>::process(const al::span<LaneArray> samples) noexcept
+{
+    constexpr size_t NumVecs{NumLanes / 4};
+
+    /* Only the history is kept in registers, as the coefficients for every
+     * stage and lane group wouldn't fit. Loading them as needed doesn't add
+     * to the latency of the feedback path.
+     */
+#ifdef HAVE_SSE_INTRINSICS
+    __m128 z1[NumStages*NumVecs], z2[NumStages*NumVecs];
+    Unroll<NumStages*NumVecs>::run([&](auto i)
+    {
+        z1[i] = _mm_load_ps(&mStages[i/NumVecs].z1[i%NumVecs*4]);
+        z2[i] = _mm_load_ps(&mStages[i/NumVecs].z2[i%NumVecs*4]);
+    });
+
+    for(LaneArray &sample : samples)
+    {
+        __m128 input[NumVecs];
+        Unroll<NumVecs>::run([&](auto v) { input[v] = _mm_loadu_ps(&sample[v*4]); });
+        Unroll<NumStages*NumVecs>::run([&](auto i)
+        {
+            const Stage &stage = mStages[i/NumVecs];
+            constexpr size_t v{decltype(i)::value % NumVecs};
+
+            const __m128 output{_mm_add_ps(_mm_mul_ps(input[v],
+                _mm_load_ps(&stage.b0[v*4])), z1[i])};
+            z1[i] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(input[v], _mm_load_ps(&stage.b1[v*4])),
+                _mm_mul_ps(output, _mm_load_ps(&stage.a1[v*4]))), z2[i]);
+            z2[i] = _mm_sub_ps(_mm_mul_ps(input[v], _mm_load_ps(&stage.b2[v*4])),
+                _mm_mul_ps(output, _mm_load_ps(&stage.a2[v*4])));
+            input[v] = output;
+        });
+        Unroll<NumVecs>::run([&](auto v) { _mm_storeu_ps(&sample[v*4], input[v]); });
+    }
+
+    Unroll<NumStages*NumVecs>::run([&](auto i)
+    {
+        _mm_store_ps(&mStages[i/NumVecs].z1[i%NumVecs*4], z1[i]);
+        _mm_store_ps(&mStages[i/NumVecs].z2[i%NumVecs*4], z2[i]);
+    });
+
+#elif defined(HAVE_NEON)
+
+    float32x4_t z1[NumStages*NumVecs], z2[NumStages*NumVecs];
+    Unroll<NumStages*NumVecs>::run([&](auto i)
+    {
+        z1[i] = vld1q_f32(&mStages[i/NumVecs].z1[i%NumVecs*4]);
+        z2[i] = vld1q_f32(&mStages[i/NumVecs].z2[i%NumVecs*4]);
+    });
+
+    for(LaneArray &sample : samples)
+    {
+        float32x4_t input[NumVecs];
+        Unroll<NumVecs>::run([&](auto v) { input[v] = vld1q_f32(&sample[v*4]); });
+        Unroll<NumStages*NumVecs>::run([&](auto i)
+        {
+            const Stage &stage = mStages[i/NumVecs];
+            constexpr size_t v{decltype(i)::value % NumVecs};
+
+            const float32x4_t output{vaddq_f32(vmulq_f32(input[v],
+                vld1q_f32(&stage.b0[v*4])), z1[i])};
+            z1[i] = vaddq_f32(vsubq_f32(vmulq_f32(input[v], vld1q_f32(&stage.b1[v*4])),
+                vmulq_f32(output, vld1q_f32(&stage.a1[v*4]))), z2[i]);
+            z2[i] = vsubq_f32(vmulq_f32(input[v], vld1q_f32(&stage.b2[v*4])),
+                vmulq_f32(output, vld1q_f32(&stage.a2[v*4])));
+            input[v] = output;
+        });
+        Unroll<NumVecs>::run([&](auto v) { vst1q_f32(&sample[v*4], input[v]); });
+    }
+
+    Unroll<NumStages*NumVecs>::run([&](auto i)
+    {
+        vst1q_f32(&mStages[i/NumVecs].z1[i%NumVecs*4], z1[i]);
+        vst1q_f32(&mStages[i/NumVecs].z2[i%NumVecs*4], z2[i]);
+    });
+
+#else
+
+    std::array<Stage,NumStages> stages{mStages};
+    for(LaneArray &sample : samples)
+    {
+        for(Stage &stage : stages)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+            {
+                const float input{sample[j]};
+                const float output{input*stage.b0[j] + stage.z1[j]};
+                stage.z1[j] = input*stage.b1[j] - output*stage.a1[j] + stage.z2[j];
+                stage.z2[j] = input*stage.b2[j] - output*stage.a2[j];
+                sample[j] = output;
+            }
+        }
+    }
+    for(size_t s{0};s < NumStages;++s)
+    {
+        mStages[s].z1 = stages[s].z1;
+        mStages[s].z2 = stages[s].z2;
+    }
+#endif
+}
+
+template<size_t NumStages, size_t Lanes>
+void BiquadBank<NumStages,Lanes>::process(const al::span<const float*const,NumLanes> src,
+    const al::span<float*const,NumLanes> dst, const size_t count) noexcept
+{
+    /* Interleave the lines into a temporary buffer, a chunk at a time, so the
+     * lanes can be processed together.
+     */
+    alignas(16) std::array<LaneArray,64> temp;
+    for(size_t base{0};base < count;)
+    {
+        const size_t todo{std::min(count-base, temp.size())};
+        size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+        /* Transpose 4x4 blocks, four samples from four lanes at a time. */
+        for(;todo-i >= 4;i += 4)
+        {
+            for(size_t j{0};j < NumLanes;j += 4)
+            {
+                __m128 s0{_mm_loadu_ps(&src[j  ][base+i])};
+                __m128 s1{_mm_loadu_ps(&src[j+1][base+i])};
+                __m128 s2{_mm_loadu_ps(&src[j+2][base+i])};
+                __m128 s3{_mm_loadu_ps(&src[j+3][base+i])};
+                _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+                _mm_store_ps(&temp[i  ][j], s0);
+                _mm_store_ps(&temp[i+1][j], s1);
+                _mm_store_ps(&temp[i+2][j], s2);
+                _mm_store_ps(&temp[i+3][j], s3);
+            }
+        }
+#endif
+        for(;i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+                temp[i][j] = src[j][base+i];
+        }
+
+        process({temp.data(), todo});
+
+        i = 0;
+#ifdef HAVE_SSE_INTRINSICS
+        for(;todo-i >= 4;i += 4)
+        {
+            for(size_t j{0};j < NumLanes;j += 4)
+            {
+                __m128 s0{_mm_load_ps(&temp[i  ][j])};
+                __m128 s1{_mm_load_ps(&temp[i+1][j])};
+                __m128 s2{_mm_load_ps(&temp[i+2][j])};
+                __m128 s3{_mm_load_ps(&temp[i+3][j])};
+                _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+                _mm_storeu_ps(&dst[j  ][base+i], s0);
+                _mm_storeu_ps(&dst[j+1][base+i], s1);
+                _mm_storeu_ps(&dst[j+2][base+i], s2);
+                _mm_storeu_ps(&dst[j+3][base+i], s3);
+            }
+        }
+#endif
+        for(;i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+                dst[j][base+i] = temp[i][j];
+        }
+        base += todo;
+    }
+}
+
+template class BiquadBank<2>;
+template class BiquadBank<4>;
+template class BiquadBank<2,8>;
@@ -2,6 +2,7 @@
 #define CORE_FILTERS_BIQUAD_H
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <utility>
@@ -37,8 +38,14 @@ enum class BiquadType {
     BandPass,
 };
 
+template<size_t NumStages, size_t Lanes=4>
+class BiquadBank;
+
 template<typename Real>
 class BiquadFilterR {
+    template<size_t NumStages, size_t Lanes>
+    friend class BiquadBank;
+
     /* Last two delayed components for direct form II. */
     Real mZ1{0.0f}, mZ2{0.0f};
     /* Transfer function coefficients "b" (numerator) */
@@ -141,4 +148,79 @@ struct DualBiquadR {
 using BiquadFilter = BiquadFilterR<float>;
 using DualBiquad = DualBiquadR<float>;
 
+
+/* A bank of independent biquad filter chains, one per SIMD lane, that are all
+ * processed at once. Each lane applies NumStages filters in series, using its
+ * own coefficients and history. Since a single biquad is limited by the
+ * latency of its feedback, running several in lockstep costs about the same
+ * as running one. Banks of more than four lanes run multiple vectors side by
+ * side, keeping more independent feedback chains in flight.
+ *
+ * The bank is just working storage. The coefficients and history are loaded
+ * from regular BiquadFilter objects, and the history is stored back to them
+ * after processing.
+ */
+template<size_t NumStages, size_t Lanes>
+class BiquadBank {
+public:
+    static constexpr size_t NumLanes{Lanes};
+    static_assert(NumLanes%4 == 0, "Lane count must be a multiple of 4");
+
+    using LaneArray = std::array<float,NumLanes>;
+
+private:
+    struct Stage {
+        alignas(16) LaneArray b0, b1, b2;
+        alignas(16) LaneArray a1, a2;
+        alignas(16) LaneArray z1, z2;
+    };
+    std::array<Stage,NumStages> mStages{};
+
+public:
+    /** Loads the coefficients and history of a filter into a lane's stage. */
+    void load(const size_t lane, const size_t stage, const BiquadFilter &filter) noexcept
+    {
+        Stage &dst = mStages[stage];
+        dst.b0[lane] = filter.mB0;
+        dst.b1[lane] = filter.mB1;
+        dst.b2[lane] = filter.mB2;
+        dst.a1[lane] = filter.mA1;
+        dst.a2[lane] = filter.mA2;
+        dst.z1[lane] = filter.mZ1;
+        dst.z2[lane] = filter.mZ2;
+    }
+
+    /** Sets a lane's stage to pass its input through unchanged. */
+    void setPassthru(const size_t lane, const size_t stage) noexcept
+    {
+        Stage &dst = mStages[stage];
+        dst.b0[lane] = 1.0f;
+        dst.b1[lane] = dst.b2[lane] = 0.0f;
+        dst.a1[lane] = dst.a2[lane] = 0.0f;
+        dst.z1[lane] = dst.z2[lane] = 0.0f;
+    }
+
+    /** Stores the history of a lane's stage back to the given filter. */
+    void store(const size_t lane, const size_t stage, BiquadFilter &filter) const noexcept
+    {
+        const Stage &src = mStages[stage];
+        filter.mZ1 = src.z1[lane];
+        filter.mZ2 = src.z2[lane];
+    }
+
+    /**
+     * Processes interleaved samples in-place, with each element holding one
+     * sample for each lane.
+     */
+    void process(const al::span<LaneArray> samples) noexcept;
+
+    /**
+     * Processes a separate input and output line for each lane. The same
+     * input may be given for multiple lanes, and a lane's output may replace
+     * its own input.
+     */
+    void process(const al::span<const float*const,NumLanes> src,
+        const al::span<float*const,NumLanes> dst, const size_t count) noexcept;
+};
+
 #endif /* CORE_FILTERS_BIQUAD_H */
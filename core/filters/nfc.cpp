@@ -3,7 +3,15 @@
 
 #include "nfc.h"
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <cassert>
 
 #include "opthelpers.h"
 
@@ -381,3 +389,145 @@ void NfcFilter::process4(const al::span<const float> src, float *RESTRICT dst)
     fourth.z[2] = z3;
     fourth.z[3] = z4;
 }
+
+void NfcFilter::process(const al::span<const float> src, const al::span<float*const> dst)
+{
+    /* Each order is run in its own SIMD lane, as a second-order section
+     * followed by another second-order section. Lower orders leave the unused
+     * coefficients as 0, which passes the signal through unchanged.
+     */
+    using LaneArray = std::array<float,4>;
+    const size_t numorders{dst.size()};
+    assert(numorders <= 4);
+
+    alignas(16) const LaneArray gain{{first.gain, second.gain, third.gain, fourth.gain}};
+    alignas(16) const LaneArray b1{{first.b1, second.b1, third.b1, fourth.b1}};
+    alignas(16) const LaneArray b2{{0.0f, second.b2, third.b2, fourth.b2}};
+    alignas(16) const LaneArray b3{{0.0f, 0.0f, third.b3, fourth.b3}};
+    alignas(16) const LaneArray b4{{0.0f, 0.0f, 0.0f, fourth.b4}};
+    alignas(16) const LaneArray a1{{first.a1, second.a1, third.a1, fourth.a1}};
+    alignas(16) const LaneArray a2{{0.0f, second.a2, third.a2, fourth.a2}};
+    alignas(16) const LaneArray a3{{0.0f, 0.0f, third.a3, fourth.a3}};
+    alignas(16) const LaneArray a4{{0.0f, 0.0f, 0.0f, fourth.a4}};
+    alignas(16) LaneArray z1{{first.z[0], second.z[0], third.z[0], fourth.z[0]}};
+    alignas(16) LaneArray z2{{0.0f, second.z[1], third.z[1], fourth.z[1]}};
+    alignas(16) LaneArray z3{{0.0f, 0.0f, third.z[2], fourth.z[2]}};
+    alignas(16) LaneArray z4{{0.0f, 0.0f, 0.0f, fourth.z[3]}};
+
+    alignas(16) std::array<LaneArray,64> temp;
+    for(size_t base{0};base < src.size();)
+    {
+        const size_t todo{std::min(src.size()-base, temp.size())};
+        const float *input{src.data() + base};
+
+#ifdef HAVE_SSE_INTRINSICS
+        const __m128 gain4{_mm_load_ps(gain.data())};
+        const __m128 b14{_mm_load_ps(b1.data())}, b24{_mm_load_ps(b2.data())};
+        const __m128 b34{_mm_load_ps(b3.data())}, b44{_mm_load_ps(b4.data())};
+        const __m128 a14{_mm_load_ps(a1.data())}, a24{_mm_load_ps(a2.data())};
+        const __m128 a34{_mm_load_ps(a3.data())}, a44{_mm_load_ps(a4.data())};
+        __m128 z14{_mm_load_ps(z1.data())}, z24{_mm_load_ps(z2.data())};
+        __m128 z34{_mm_load_ps(z3.data())}, z44{_mm_load_ps(z4.data())};
+        for(size_t i{0};i < todo;++i)
+        {
+            const __m128 in{_mm_set1_ps(input[i])};
+            __m128 y{_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(in, gain4), _mm_mul_ps(a14, z14)),
+                _mm_mul_ps(a24, z24))};
+            __m128 out{_mm_add_ps(_mm_add_ps(y, _mm_mul_ps(b14, z14)), _mm_mul_ps(b24, z24))};
+            z24 = _mm_add_ps(z24, z14);
+            z14 = _mm_add_ps(z14, y);
+
+            y = _mm_sub_ps(_mm_sub_ps(out, _mm_mul_ps(a34, z34)), _mm_mul_ps(a44, z44));
+            out = _mm_add_ps(_mm_add_ps(y, _mm_mul_ps(b34, z34)), _mm_mul_ps(b44, z44));
+            z44 = _mm_add_ps(z44, z34);
+            z34 = _mm_add_ps(z34, y);
+
+            _mm_store_ps(temp[i].data(), out);
+        }
+        _mm_store_ps(z1.data(), z14);
+        _mm_store_ps(z2.data(), z24);
+        _mm_store_ps(z3.data(), z34);
+        _mm_store_ps(z4.data(), z44);
+
+#elif defined(HAVE_NEON)
+
+        const float32x4_t gain4{vld1q_f32(gain.data())};
+        const float32x4_t b14{vld1q_f32(b1.data())}, b24{vld1q_f32(b2.data())};
+        const float32x4_t b34{vld1q_f32(b3.data())}, b44{vld1q_f32(b4.data())};
+        const float32x4_t a14{vld1q_f32(a1.data())}, a24{vld1q_f32(a2.data())};
+        const float32x4_t a34{vld1q_f32(a3.data())}, a44{vld1q_f32(a4.data())};
+        float32x4_t z14{vld1q_f32(z1.data())}, z24{vld1q_f32(z2.data())};
+        float32x4_t z34{vld1q_f32(z3.data())}, z44{vld1q_f32(z4.data())};
+        for(size_t i{0};i < todo;++i)
+        {
+            const float32x4_t in{vdupq_n_f32(input[i])};
+            float32x4_t y{vsubq_f32(vsubq_f32(vmulq_f32(in, gain4), vmulq_f32(a14, z14)),
+                vmulq_f32(a24, z24))};
+            float32x4_t out{vaddq_f32(vaddq_f32(y, vmulq_f32(b14, z14)), vmulq_f32(b24, z24))};
+            z24 = vaddq_f32(z24, z14);
+            z14 = vaddq_f32(z14, y);
+
+            y = vsubq_f32(vsubq_f32(out, vmulq_f32(a34, z34)), vmulq_f32(a44, z44));
+            out = vaddq_f32(vaddq_f32(y, vmulq_f32(b34, z34)), vmulq_f32(b44, z44));
+            z44 = vaddq_f32(z44, z34);
+            z34 = vaddq_f32(z34, y);
+
+            vst1q_f32(temp[i].data(), out);
+        }
+        vst1q_f32(z1.data(), z14);
+        vst1q_f32(z2.data(), z24);
+        vst1q_f32(z3.data(), z34);
+        vst1q_f32(z4.data(), z44);
+
+#else
+
+        for(size_t i{0};i < todo;++i)
+        {
+            for(size_t j{0};j < 4;++j)
+            {
+                float y{input[i]*gain[j] - a1[j]*z1[j] - a2[j]*z2[j]};
+                float out{y + b1[j]*z1[j] + b2[j]*z2[j]};
+                z2[j] += z1[j];
+                z1[j] += y;
+
+                y = out - a3[j]*z3[j] - a4[j]*z4[j];
+                out = y + b3[j]*z3[j] + b4[j]*z4[j];
+                z4[j] += z3[j];
+                z3[j] += y;
+
+                temp[i][j] = out;
+            }
+        }
+#endif
+
+        for(size_t j{0};j < numorders;++j)
+        {
+            float *RESTRICT output{dst[j] + base};
+            for(size_t i{0};i < todo;++i)
+                output[i] = temp[i][j];
+        }
+        base += todo;
+    }
+
+    /* Only store the history for the orders that were output. */
+    if(numorders > 0)
+        first.z[0] = z1[0];
+    if(numorders > 1)
+    {
+        second.z[0] = z1[1];
+        second.z[1] = z2[1];
+    }
+    if(numorders > 2)
+    {
+        third.z[0] = z1[2];
+        third.z[1] = z2[2];
+        third.z[2] = z3[2];
+    }
+    if(numorders > 3)
+    {
+        fourth.z[0] = z1[3];
+        fourth.z[1] = z2[3];
+        fourth.z[2] = z3[3];
+        fourth.z[3] = z4[3];
+    }
+}
@@ -58,6 +58,14 @@ public:
 
     /* Near-field control filter for fourth-order ambisonic channels (16-24). */
     void process4(const al::span<const float> src, float *RESTRICT dst);
+
+    /* Near-field control filters for multiple ambisonic orders at once, all
+     * applied to the same input. The first output line receives the first-
+     * order filter, the second the second-order filter, and so on, up to
+     * fourth-order. This is faster than calling the individual methods for
+     * each order.
+     */
+    void process(const al::span<const float> src, const al::span<float*const> dst);
 };
 
 #endif /* CORE_FILTERS_NFC_H */
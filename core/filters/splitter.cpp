@@ -3,6 +3,12 @@
 
 #include "splitter.h"
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -111,3 +117,153 @@ void BandSplitterR<Real>::applyAllpass(const al::span<Real> samples) const
 
 template class BandSplitterR<float>;
 template class BandSplitterR<double>;
+
+
+void BandSplitterBank::split(const al::span<LaneArray> samples, LaneArray *lpout) noexcept
+{
+    static_assert(NumLanes == 4, "Unexpected lane count");
+
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 ap_coeff{_mm_load_ps(mCoeff.data())};
+    const __m128 lp_coeff{_mm_add_ps(_mm_mul_ps(ap_coeff, _mm_set1_ps(0.5f)),
+        _mm_set1_ps(0.5f))};
+    __m128 lp_z1{_mm_load_ps(mLpZ1.data())};
+    __m128 lp_z2{_mm_load_ps(mLpZ2.data())};
+    __m128 ap_z1{_mm_load_ps(mApZ1.data())};
+    for(LaneArray &sample : samples)
+    {
+        const __m128 in{_mm_load_ps(sample.data())};
+
+        __m128 d{_mm_mul_ps(_mm_sub_ps(in, lp_z1), lp_coeff)};
+        __m128 lp_y{_mm_add_ps(lp_z1, d)};
+        lp_z1 = _mm_add_ps(lp_y, d);
+
+        d = _mm_mul_ps(_mm_sub_ps(lp_y, lp_z2), lp_coeff);
+        lp_y = _mm_add_ps(lp_z2, d);
+        lp_z2 = _mm_add_ps(lp_y, d);
+
+        const __m128 ap_y{_mm_add_ps(_mm_mul_ps(in, ap_coeff), ap_z1)};
+        ap_z1 = _mm_sub_ps(in, _mm_mul_ps(ap_y, ap_coeff));
+
+        _mm_store_ps((lpout++)->data(), lp_y);
+        _mm_store_ps(sample.data(), _mm_sub_ps(ap_y, lp_y));
+    }
+    _mm_store_ps(mLpZ1.data(), lp_z1);
+    _mm_store_ps(mLpZ2.data(), lp_z2);
+    _mm_store_ps(mApZ1.data(), ap_z1);
+
+#elif defined(HAVE_NEON)
+
+    const float32x4_t ap_coeff{vld1q_f32(mCoeff.data())};
+    const float32x4_t lp_coeff{vaddq_f32(vmulq_f32(ap_coeff, vdupq_n_f32(0.5f)),
+        vdupq_n_f32(0.5f))};
+    float32x4_t lp_z1{vld1q_f32(mLpZ1.data())};
+    float32x4_t lp_z2{vld1q_f32(mLpZ2.data())};
+    float32x4_t ap_z1{vld1q_f32(mApZ1.data())};
+    for(LaneArray &sample : samples)
+    {
+        const float32x4_t in{vld1q_f32(sample.data())};
+
+        float32x4_t d{vmulq_f32(vsubq_f32(in, lp_z1), lp_coeff)};
+        float32x4_t lp_y{vaddq_f32(lp_z1, d)};
+        lp_z1 = vaddq_f32(lp_y, d);
+
+        d = vmulq_f32(vsubq_f32(lp_y, lp_z2), lp_coeff);
+        lp_y = vaddq_f32(lp_z2, d);
+        lp_z2 = vaddq_f32(lp_y, d);
+
+        const float32x4_t ap_y{vaddq_f32(vmulq_f32(in, ap_coeff), ap_z1)};
+        ap_z1 = vsubq_f32(in, vmulq_f32(ap_y, ap_coeff));
+
+        vst1q_f32((lpout++)->data(), lp_y);
+        vst1q_f32(sample.data(), vsubq_f32(ap_y, lp_y));
+    }
+    vst1q_f32(mLpZ1.data(), lp_z1);
+    vst1q_f32(mLpZ2.data(), lp_z2);
+    vst1q_f32(mApZ1.data(), ap_z1);
+
+#else
+
+    LaneArray lp_coeff;
+    for(size_t j{0};j < NumLanes;++j)
+        lp_coeff[j] = mCoeff[j]*0.5f + 0.5f;
+    for(LaneArray &sample : samples)
+    {
+        LaneArray &lp_y = *(lpout++);
+        for(size_t j{0};j < NumLanes;++j)
+        {
+            const float in{sample[j]};
+
+            float d{(in - mLpZ1[j]) * lp_coeff[j]};
+            lp_y[j] = mLpZ1[j] + d;
+            mLpZ1[j] = lp_y[j] + d;
+
+            d = (lp_y[j] - mLpZ2[j]) * lp_coeff[j];
+            lp_y[j] = mLpZ2[j] + d;
+            mLpZ2[j] = lp_y[j] + d;
+
+            const float ap_y{in*mCoeff[j] + mApZ1[j]};
+            mApZ1[j] = in - ap_y*mCoeff[j];
+
+            sample[j] = ap_y - lp_y[j];
+        }
+    }
+#endif
+}
+
+void BandSplitterBank::process(const al::span<const float*const,NumLanes> input,
+    const al::span<float*const,NumLanes> hpout, const al::span<float*const,NumLanes> lpout,
+    const size_t count) noexcept
+{
+    alignas(16) std::array<LaneArray,64> hptemp;
+    alignas(16) std::array<LaneArray,64> lptemp;
+    for(size_t base{0};base < count;)
+    {
+        const size_t todo{std::min(count-base, hptemp.size())};
+        for(size_t i{0};i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+                hptemp[i][j] = input[j][base+i];
+        }
+
+        split({hptemp.data(), todo}, lptemp.data());
+
+        for(size_t i{0};i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+            {
+                hpout[j][base+i] = hptemp[i][j];
+                lpout[j][base+i] = lptemp[i][j];
+            }
+        }
+        base += todo;
+    }
+}
+
+void BandSplitterBank::processHfScale(const al::span<float*const,NumLanes> samples,
+    const LaneArray &hfscale, const size_t count) noexcept
+{
+    alignas(16) std::array<LaneArray,64> hptemp;
+    alignas(16) std::array<LaneArray,64> lptemp;
+    for(size_t base{0};base < count;)
+    {
+        const size_t todo{std::min(count-base, hptemp.size())};
+        for(size_t i{0};i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+                hptemp[i][j] = samples[j][base+i];
+        }
+
+        split({hptemp.data(), todo}, lptemp.data());
+
+        /* Scale the high-frequency band and add it back to the low-frequency
+         * band.
+         */
+        for(size_t i{0};i < todo;++i)
+        {
+            for(size_t j{0};j < NumLanes;++j)
+                samples[j][base+i] = hptemp[i][j]*hfscale[j] + lptemp[i][j];
+        }
+        base += todo;
+    }
+}
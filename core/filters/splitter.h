@@ -1,10 +1,13 @@
 #ifndef CORE_FILTERS_SPLITTER_H
 #define CORE_FILTERS_SPLITTER_H
 
+#include <array>
 #include <cstddef>
 
 #include "alspan.h"
 
+class BandSplitterBank;
+
 
 /* Band splitter. Splits a signal into two phase-matching frequency bands. */
 template<typename Real>
@@ -14,6 +17,8 @@ class BandSplitterR {
     Real mLpZ2{0.0f};
     Real mApZ1{0.0f};
 
+    friend class BandSplitterBank;
+
 public:
     BandSplitterR() = default;
     BandSplitterR(const BandSplitterR&) = default;
@@ -33,4 +38,56 @@ public:
 };
 using BandSplitter = BandSplitterR<float>;
 
+
+/* A bank of independent band splitters, one per SIMD lane, that are all
+ * processed at once. This is for filtering several channels (e.g. the
+ * channels of an ambisonic signal) with their own splitters, which would
+ * otherwise each be limited by the latency of their feedback.
+ *
+ * As with BiquadBank, the bank is just working storage. The coefficient and
+ * history are loaded from regular BandSplitter objects, and the history is
+ * stored back to them after processing.
+ */
+class BandSplitterBank {
+public:
+    static constexpr size_t NumLanes{4};
+
+    using LaneArray = std::array<float,NumLanes>;
+
+private:
+    alignas(16) LaneArray mCoeff;
+    alignas(16) LaneArray mLpZ1;
+    alignas(16) LaneArray mLpZ2;
+    alignas(16) LaneArray mApZ1;
+
+    /* Splits the interleaved samples in-place, replacing them with the high-
+     * frequency band and writing the low-frequency band to lpout.
+     */
+    void split(const al::span<LaneArray> samples, LaneArray *lpout) noexcept;
+
+public:
+    void load(const size_t lane, const BandSplitter &splitter) noexcept
+    {
+        mCoeff[lane] = splitter.mCoeff;
+        mLpZ1[lane] = splitter.mLpZ1;
+        mLpZ2[lane] = splitter.mLpZ2;
+        mApZ1[lane] = splitter.mApZ1;
+    }
+    void store(const size_t lane, BandSplitter &splitter) const noexcept
+    {
+        splitter.mLpZ1 = mLpZ1[lane];
+        splitter.mLpZ2 = mLpZ2[lane];
+        splitter.mApZ1 = mApZ1[lane];
+    }
+
+    /* Splits each lane's input line into high- and low-frequency bands. */
+    void process(const al::span<const float*const,NumLanes> input,
+        const al::span<float*const,NumLanes> hpout, const al::span<float*const,NumLanes> lpout,
+        const size_t count) noexcept;
+
+    /* Applies each lane's high-frequency scale to its line, in-place. */
+    void processHfScale(const al::span<float*const,NumLanes> samples, const LaneArray &hfscale,
+        const size_t count) noexcept;
+};
+
 #endif /* CORE_FILTERS_SPLITTER_H */
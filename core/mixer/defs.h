@@ -2,6 +2,8 @@
 #define CORE_MIXER_DEFS_H
 
 #include <array>
+#include <cmath>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "alspan.h"
@@ -73,6 +75,15 @@ template<typename InstTag>
 void Mix_(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutBuffer,
     float *CurrentGains, const float *TargetGains, const size_t Counter, const size_t OutPos);
 
+/* Mixes only to the output channels listed in OutChans. The gains are still
+ * indexed by output channel, and the gains for unlisted channels are left
+ * alone.
+ */
+template<typename InstTag>
+void MixSparse_(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutBuffer,
+    float *CurrentGains, const float *TargetGains, const al::span<const uint8_t> OutChans,
+    const size_t Counter, const size_t OutPos);
+
 template<typename InstTag>
 void MixHrtf_(const float *InSamples, float2 *AccumSamples, const uint IrSize,
     const MixHrtfFilter *hrtfparams, const size_t BufferSize);
@@ -84,6 +95,29 @@ void MixDirectHrtf_(const FloatBufferSpan LeftOut, const FloatBufferSpan RightOu
     const al::span<const FloatBufferLine> InSamples, float2 *AccumSamples,
     float *TempBuf, HrtfChannelState *ChanState, const size_t IrSize, const size_t BufferSize);
 
+/* The maximum number of input lines for matrix mixing. */
+constexpr size_t MaxMatrixInputs{16};
+
+/* Matrix mixing. Mixes each input line to each output line, accumulating onto
+ * the output. Gains holds a row of input gains for each output, with
+ * GainStride floats between the start of each row. Gains at or below the
+ * silence threshold are skipped, as with Mix_. The lines must be 16-byte
+ * aligned.
+ */
+template<typename InstTag>
+void MixMatrix_(const al::span<const float*const> InSamples,
+    const al::span<float*const> OutSamples, const float *Gains, const size_t GainStride,
+    const size_t SamplesToDo);
+
+/* Complex multiply-accumulate for split (structure-of-arrays) spectra. Each
+ * buffer holds Count real components followed by Count imaginary components,
+ * and Accum += Input * Filter is applied for each complex value. Count must be
+ * a multiple of 4, and the buffers must be 16-byte aligned.
+ */
+template<typename InstTag>
+void ComplexMac_(float *RESTRICT Accum, const float *RESTRICT Input,
+    const float *RESTRICT Filter, const size_t Count);
+
 /* Vectorized resampler helpers */
 template<size_t N>
 inline void InitPosArrays(uint frac, uint increment, uint (&frac_arr)[N], uint (&pos_arr)[N])
@@ -98,4 +132,33 @@ inline void InitPosArrays(uint frac, uint increment, uint (&frac_arr)[N], uint (
     }
 }
 
+/* Matrix mixer helper. Finds the inputs that are audible on any of N outputs,
+ * storing them along with their gain for each output (silent gains are set to
+ * 0). Returns the number of inputs found.
+ */
+template<size_t N>
+inline size_t GatherMatrixInputs(const al::span<const float*const> InSamples, const float *Gains,
+    const size_t GainStride, const float **inputs, std::array<float,N> *gains)
+{
+    size_t count{0};
+    for(size_t i{0};i < InSamples.size();++i)
+    {
+        bool audible{false};
+        for(size_t k{0};k < N;++k)
+        {
+            const float gain{Gains[k*GainStride + i]};
+            if(!(std::abs(gain) > GainSilenceThreshold))
+                gains[count][k] = 0.0f;
+            else
+            {
+                gains[count][k] = gain;
+                audible = true;
+            }
+        }
+        if(audible)
+            inputs[count++] = InSamples[i];
+    }
+    return count;
+}
+
 #endif /* CORE_MIXER_DEFS_H */
@@ -96,6 +96,40 @@ inline void ApplyCoeffs(float2 *RESTRICT Values, const size_t IrSize, const Cons
     }
 }
 
+/* Mixes the input to one output line, stepping the current gain toward the
+ * target gain over Counter samples.
+ */
+inline void MixLine(const al::span<const float> InSamples, float *RESTRICT dst, float &CurrentGain,
+    const float TargetGain, const float delta, const size_t min_len,
+    const size_t Counter)
+{
+    float gain{CurrentGain};
+    const float step{(TargetGain-gain) * delta};
+
+    size_t pos{0};
+    if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
+        gain = TargetGain;
+    else
+    {
+        float step_count{0.0f};
+        for(;pos != min_len;++pos)
+        {
+            dst[pos] += InSamples[pos] * (gain + step*step_count);
+            step_count += 1.0f;
+        }
+        if(pos == Counter)
+            gain = TargetGain;
+        else
+            gain += step*step_count;
+    }
+    CurrentGain = gain;
+
+    if(!(std::abs(gain) > GainSilenceThreshold))
+        return;
+    for(;pos != InSamples.size();++pos)
+        dst[pos] += InSamples[pos] * gain;
+}
+
 } // namespace
 
 template<>
@@ -168,33 +202,65 @@ void Mix_<CTag>(const al::span<const float> InSamples, const al::span<FloatBuffe
     const auto min_len = minz(Counter, InSamples.size());
     for(FloatBufferLine &output : OutBuffer)
     {
-        float *RESTRICT dst{al::assume_aligned<16>(output.data()+OutPos)};
-        float gain{*CurrentGains};
-        const float step{(*TargetGains-gain) * delta};
-
-        size_t pos{0};
-        if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
-            gain = *TargetGains;
-        else
-        {
-            float step_count{0.0f};
-            for(;pos != min_len;++pos)
-            {
-                dst[pos] += InSamples[pos] * (gain + step*step_count);
-                step_count += 1.0f;
-            }
-            if(pos == Counter)
-                gain = *TargetGains;
-            else
-                gain += step*step_count;
-        }
-        *CurrentGains = gain;
+        MixLine(InSamples, al::assume_aligned<16>(output.data()+OutPos), *CurrentGains,
+            *TargetGains, delta, min_len, Counter);
         ++CurrentGains;
         ++TargetGains;
+    }
+}
+
+template<>
+void MixSparse_<CTag>(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, float *CurrentGains, const float *TargetGains,
+    const al::span<const uint8_t> OutChans, const size_t Counter, const size_t OutPos)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto min_len = minz(Counter, InSamples.size());
+
+    for(const size_t chan : OutChans)
+        MixLine(InSamples, al::assume_aligned<16>(OutBuffer[chan].data()+OutPos),
+            CurrentGains[chan], TargetGains[chan], delta, min_len, Counter);
+}
+
+template<>
+void MixMatrix_<CTag>(const al::span<const float*const> InSamples,
+    const al::span<float*const> OutSamples, const float *Gains, const size_t GainStride,
+    const size_t SamplesToDo)
+{
+    ASSUME(InSamples.size() <= MaxMatrixInputs);
+
+    const float *inputs[MaxMatrixInputs];
+    std::array<float,1> gains[MaxMatrixInputs];
+    for(float *RESTRICT dst : OutSamples)
+    {
+        const size_t numins{GatherMatrixInputs<1>(InSamples, Gains, GainStride, inputs, gains)};
+        Gains += GainStride;
 
-        if(!(std::abs(gain) > GainSilenceThreshold))
+        if(numins == 0)
             continue;
-        for(;pos != InSamples.size();++pos)
-            dst[pos] += InSamples[pos] * gain;
+        for(size_t pos{0};pos < SamplesToDo;++pos)
+        {
+            float sample{dst[pos]};
+            for(size_t i{0};i < numins;++i)
+                sample += inputs[i][pos] * gains[i][0];
+            dst[pos] = sample;
+        }
+    }
+}
+
+template<>
+void ComplexMac_<CTag>(float *RESTRICT Accum, const float *RESTRICT Input,
+    const float *RESTRICT Filter, const size_t Count)
+{
+    float *RESTRICT accRe{al::assume_aligned<16>(Accum)};
+    float *RESTRICT accIm{al::assume_aligned<16>(Accum + Count)};
+    const float *RESTRICT inRe{al::assume_aligned<16>(Input)};
+    const float *RESTRICT inIm{al::assume_aligned<16>(Input + Count)};
+    const float *RESTRICT firRe{al::assume_aligned<16>(Filter)};
+    const float *RESTRICT firIm{al::assume_aligned<16>(Filter + Count)};
+    for(size_t i{0};i < Count;++i)
+    {
+        accRe[i] += inRe[i]*firRe[i] - inIm[i]*firIm[i];
+        accIm[i] += inRe[i]*firIm[i] + inIm[i]*firRe[i];
     }
 }
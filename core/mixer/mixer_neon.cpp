@@ -56,6 +56,128 @@ inline void ApplyCoeffs(float2 *RESTRICT Values, const size_t IrSize, const Cons
     }
 }
 
+/* Mixes the inputs to a group of N outputs, keeping the outputs' samples in
+ * registers while all the inputs are accumulated onto them.
+ */
+template<size_t N>
+void MixMatrixGroup(const al::span<const float*const> InSamples, float *const *outputs,
+    const float *Gains, const size_t GainStride, const size_t SamplesToDo)
+{
+    const float *inputs[MaxMatrixInputs];
+    std::array<float,N> gains[MaxMatrixInputs];
+    const size_t numins{GatherMatrixInputs<N>(InSamples, Gains, GainStride, inputs, gains)};
+    if(numins == 0)
+        return;
+
+    float32x4_t gains4[MaxMatrixInputs][N];
+    for(size_t i{0};i < numins;++i)
+    {
+        for(size_t k{0};k < N;++k)
+            gains4[i][k] = vdupq_n_f32(gains[i][k]);
+    }
+
+    size_t pos{0};
+    for(;pos < (SamplesToDo&~size_t{3});pos += 4)
+    {
+        float32x4_t dry4[N];
+        for(size_t k{0};k < N;++k)
+            dry4[k] = vld1q_f32(&outputs[k][pos]);
+        for(size_t i{0};i < numins;++i)
+        {
+            const float32x4_t val4{vld1q_f32(&inputs[i][pos])};
+            for(size_t k{0};k < N;++k)
+                dry4[k] = vmlaq_f32(dry4[k], val4, gains4[i][k]);
+        }
+        for(size_t k{0};k < N;++k)
+            vst1q_f32(&outputs[k][pos], dry4[k]);
+    }
+    for(;pos < SamplesToDo;++pos)
+    {
+        for(size_t k{0};k < N;++k)
+        {
+            float sample{outputs[k][pos]};
+            for(size_t i{0};i < numins;++i)
+                sample += inputs[i][pos] * gains[i][k];
+            outputs[k][pos] = sample;
+        }
+    }
+}
+
+/* Mixes the input to one output line, stepping the current gain toward the
+ * target gain over Counter samples.
+ */
+inline void MixLine(const al::span<const float> InSamples, float *RESTRICT dst, float &CurrentGain,
+    const float TargetGain, const float delta, const size_t min_len, const size_t aligned_len,
+    const size_t Counter)
+{
+    float gain{CurrentGain};
+    const float step{(TargetGain-gain) * delta};
+
+    size_t pos{0};
+    if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
+        gain = TargetGain;
+    else
+    {
+        float step_count{0.0f};
+        /* Mix with applying gain steps in aligned multiples of 4. */
+        if(size_t todo{(min_len-pos) >> 2})
+        {
+            const float32x4_t four4{vdupq_n_f32(4.0f)};
+            const float32x4_t step4{vdupq_n_f32(step)};
+            const float32x4_t gain4{vdupq_n_f32(gain)};
+            float32x4_t step_count4{vdupq_n_f32(0.0f)};
+            step_count4 = vsetq_lane_f32(1.0f, step_count4, 1);
+            step_count4 = vsetq_lane_f32(2.0f, step_count4, 2);
+            step_count4 = vsetq_lane_f32(3.0f, step_count4, 3);
+
+            do {
+                const float32x4_t val4 = vld1q_f32(&InSamples[pos]);
+                float32x4_t dry4 = vld1q_f32(&dst[pos]);
+                dry4 = vmlaq_f32(dry4, val4, vmlaq_f32(gain4, step4, step_count4));
+                step_count4 = vaddq_f32(step_count4, four4);
+                vst1q_f32(&dst[pos], dry4);
+                pos += 4;
+            } while(--todo);
+            /* NOTE: step_count4 now represents the next four counts after
+             * the last four mixed samples, so the lowest element
+             * represents the next step count to apply.
+             */
+            step_count = vgetq_lane_f32(step_count4, 0);
+        }
+        /* Mix with applying left over gain steps that aren't aligned multiples of 4. */
+        for(size_t leftover{min_len&3};leftover;++pos,--leftover)
+        {
+            dst[pos] += InSamples[pos] * (gain + step*step_count);
+            step_count += 1.0f;
+        }
+        if(pos == Counter)
+            gain = TargetGain;
+        else
+            gain += step*step_count;
+
+        /* Mix until pos is aligned with 4 or the mix is done. */
+        for(size_t leftover{aligned_len&3};leftover;++pos,--leftover)
+            dst[pos] += InSamples[pos] * gain;
+    }
+    CurrentGain = gain;
+
+    if(!(std::abs(gain) > GainSilenceThreshold))
+        return;
+    if(size_t todo{(InSamples.size()-pos) >> 2})
+    {
+        const float32x4_t gain4 = vdupq_n_f32(gain);
+        do {
+            const float32x4_t val4 = vld1q_f32(&InSamples[pos]);
+            float32x4_t dry4 = vld1q_f32(&dst[pos]);
+            dry4 = vmlaq_f32(dry4, val4, gain4);
+            vst1q_f32(&dst[pos], dry4);
+            pos += 4;
+        } while(--todo);
+    }
+    for(size_t leftover{(InSamples.size()-pos)&3};leftover;++pos,--leftover)
+        dst[pos] += InSamples[pos] * gain;
+}
+
 } // namespace
 
 template<>
@@ -234,74 +356,71 @@ void Mix_<NEONTag>(const al::span<const float> InSamples, const al::span<FloatBu
 
     for(FloatBufferLine &output : OutBuffer)
     {
-        float *RESTRICT dst{al::assume_aligned<16>(output.data()+OutPos)};
-        float gain{*CurrentGains};
-        const float step{(*TargetGains-gain) * delta};
-
-        size_t pos{0};
-        if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
-            gain = *TargetGains;
-        else
-        {
-            float step_count{0.0f};
-            /* Mix with applying gain steps in aligned multiples of 4. */
-            if(size_t todo{(min_len-pos) >> 2})
-            {
-                const float32x4_t four4{vdupq_n_f32(4.0f)};
-                const float32x4_t step4{vdupq_n_f32(step)};
-                const float32x4_t gain4{vdupq_n_f32(gain)};
-                float32x4_t step_count4{vdupq_n_f32(0.0f)};
-                step_count4 = vsetq_lane_f32(1.0f, step_count4, 1);
-                step_count4 = vsetq_lane_f32(2.0f, step_count4, 2);
-                step_count4 = vsetq_lane_f32(3.0f, step_count4, 3);
-
-                do {
-                    const float32x4_t val4 = vld1q_f32(&InSamples[pos]);
-                    float32x4_t dry4 = vld1q_f32(&dst[pos]);
-                    dry4 = vmlaq_f32(dry4, val4, vmlaq_f32(gain4, step4, step_count4));
-                    step_count4 = vaddq_f32(step_count4, four4);
-                    vst1q_f32(&dst[pos], dry4);
-                    pos += 4;
-                } while(--todo);
-                /* NOTE: step_count4 now represents the next four counts after
-                 * the last four mixed samples, so the lowest element
-                 * represents the next step count to apply.
-                 */
-                step_count = vgetq_lane_f32(step_count4, 0);
-            }
-            /* Mix with applying left over gain steps that aren't aligned multiples of 4. */
-            for(size_t leftover{min_len&3};leftover;++pos,--leftover)
-            {
-                dst[pos] += InSamples[pos] * (gain + step*step_count);
-                step_count += 1.0f;
-            }
-            if(pos == Counter)
-                gain = *TargetGains;
-            else
-                gain += step*step_count;
-
-            /* Mix until pos is aligned with 4 or the mix is done. */
-            for(size_t leftover{aligned_len&3};leftover;++pos,--leftover)
-                dst[pos] += InSamples[pos] * gain;
-        }
-        *CurrentGains = gain;
+        MixLine(InSamples, al::assume_aligned<16>(output.data()+OutPos), *CurrentGains,
+            *TargetGains, delta, min_len, aligned_len, Counter);
         ++CurrentGains;
         ++TargetGains;
+    }
+}
 
-        if(!(std::abs(gain) > GainSilenceThreshold))
-            continue;
-        if(size_t todo{(InSamples.size()-pos) >> 2})
-        {
-            const float32x4_t gain4 = vdupq_n_f32(gain);
-            do {
-                const float32x4_t val4 = vld1q_f32(&InSamples[pos]);
-                float32x4_t dry4 = vld1q_f32(&dst[pos]);
-                dry4 = vmlaq_f32(dry4, val4, gain4);
-                vst1q_f32(&dst[pos], dry4);
-                pos += 4;
-            } while(--todo);
-        }
-        for(size_t leftover{(InSamples.size()-pos)&3};leftover;++pos,--leftover)
-            dst[pos] += InSamples[pos] * gain;
+template<>
+void MixSparse_<NEONTag>(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, float *CurrentGains, const float *TargetGains,
+    const al::span<const uint8_t> OutChans, const size_t Counter, const size_t OutPos)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto min_len = minz(Counter, InSamples.size());
+    const auto aligned_len = minz((min_len+3) & ~size_t{3}, InSamples.size()) - min_len;
+
+    for(const size_t chan : OutChans)
+        MixLine(InSamples, al::assume_aligned<16>(OutBuffer[chan].data()+OutPos),
+            CurrentGains[chan], TargetGains[chan], delta, min_len, aligned_len, Counter);
+}
+
+template<>
+void MixMatrix_<NEONTag>(const al::span<const float*const> InSamples,
+    const al::span<float*const> OutSamples, const float *Gains, const size_t GainStride,
+    const size_t SamplesToDo)
+{
+    ASSUME(InSamples.size() <= MaxMatrixInputs);
+
+    /* Mix four outputs at a time, then whatever is left. */
+    float *const *outputs{OutSamples.data()};
+    size_t numouts{OutSamples.size()};
+    for(;numouts >= 4;numouts -= 4)
+    {
+        MixMatrixGroup<4>(InSamples, outputs, Gains, GainStride, SamplesToDo);
+        outputs += 4;
+        Gains += GainStride*4;
+    }
+    switch(numouts)
+    {
+    case 3: MixMatrixGroup<3>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    case 2: MixMatrixGroup<2>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    case 1: MixMatrixGroup<1>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    }
+}
+
+template<>
+void ComplexMac_<NEONTag>(float *RESTRICT Accum, const float *RESTRICT Input,
+    const float *RESTRICT Filter, const size_t Count)
+{
+    float *RESTRICT accIm{Accum + Count};
+    const float *RESTRICT inIm{Input + Count};
+    const float *RESTRICT firIm{Filter + Count};
+    for(size_t i{0};i < Count;i+=4)
+    {
+        const float32x4_t ir4{vld1q_f32(&Input[i])};
+        const float32x4_t ii4{vld1q_f32(&inIm[i])};
+        const float32x4_t fr4{vld1q_f32(&Filter[i])};
+        const float32x4_t fi4{vld1q_f32(&firIm[i])};
+
+        /* (a+bi)*(c+di) = (ac-bd) + (ad+bc)i */
+        float32x4_t re4{vld1q_f32(&Accum[i])};
+        float32x4_t im4{vld1q_f32(&accIm[i])};
+        re4 = vmlsq_f32(vmlaq_f32(re4, ir4, fr4), ii4, fi4);
+        im4 = vmlaq_f32(vmlaq_f32(im4, ir4, fi4), ii4, fr4);
+        vst1q_f32(&Accum[i], re4);
+        vst1q_f32(&accIm[i], im4);
     }
 }
@@ -74,6 +74,127 @@ inline void ApplyCoeffs(float2 *RESTRICT Values, const size_t IrSize, const Cons
     }
 }
 
+/* Mixes the inputs to a group of N outputs, keeping the outputs' samples in
+ * registers while all the inputs are accumulated onto them.
+ */
+template<size_t N>
+void MixMatrixGroup(const al::span<const float*const> InSamples, float *const *outputs,
+    const float *Gains, const size_t GainStride, const size_t SamplesToDo)
+{
+    const float *inputs[MaxMatrixInputs];
+    std::array<float,N> gains[MaxMatrixInputs];
+    const size_t numins{GatherMatrixInputs<N>(InSamples, Gains, GainStride, inputs, gains)};
+    if(numins == 0)
+        return;
+
+    __m128 gains4[MaxMatrixInputs][N];
+    for(size_t i{0};i < numins;++i)
+    {
+        for(size_t k{0};k < N;++k)
+            gains4[i][k] = _mm_set1_ps(gains[i][k]);
+    }
+
+    size_t pos{0};
+    for(;pos < (SamplesToDo&~size_t{3});pos += 4)
+    {
+        __m128 dry4[N];
+        for(size_t k{0};k < N;++k)
+            dry4[k] = _mm_load_ps(&outputs[k][pos]);
+        for(size_t i{0};i < numins;++i)
+        {
+            const __m128 val4{_mm_load_ps(&inputs[i][pos])};
+            for(size_t k{0};k < N;++k)
+                dry4[k] = MLA4(dry4[k], val4, gains4[i][k]);
+        }
+        for(size_t k{0};k < N;++k)
+            _mm_store_ps(&outputs[k][pos], dry4[k]);
+    }
+    for(;pos < SamplesToDo;++pos)
+    {
+        for(size_t k{0};k < N;++k)
+        {
+            float sample{outputs[k][pos]};
+            for(size_t i{0};i < numins;++i)
+                sample += inputs[i][pos] * gains[i][k];
+            outputs[k][pos] = sample;
+        }
+    }
+}
+
+/* Mixes the input to one output line, stepping the current gain toward the
+ * target gain over Counter samples.
+ */
+inline void MixLine(const al::span<const float> InSamples, float *RESTRICT dst, float &CurrentGain,
+    const float TargetGain, const float delta, const size_t min_len, const size_t aligned_len,
+    const size_t Counter)
+{
+    float gain{CurrentGain};
+    const float step{(TargetGain-gain) * delta};
+
+    size_t pos{0};
+    if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
+        gain = TargetGain;
+    else
+    {
+        float step_count{0.0f};
+        /* Mix with applying gain steps in aligned multiples of 4. */
+        if(size_t todo{(min_len-pos) >> 2})
+        {
+            const __m128 four4{_mm_set1_ps(4.0f)};
+            const __m128 step4{_mm_set1_ps(step)};
+            const __m128 gain4{_mm_set1_ps(gain)};
+            __m128 step_count4{_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)};
+            do {
+                const __m128 val4{_mm_load_ps(&InSamples[pos])};
+                __m128 dry4{_mm_load_ps(&dst[pos])};
+
+                /* dry += val * (gain + step*step_count) */
+                dry4 = MLA4(dry4, val4, MLA4(gain4, step4, step_count4));
+
+                _mm_store_ps(&dst[pos], dry4);
+                step_count4 = _mm_add_ps(step_count4, four4);
+                pos += 4;
+            } while(--todo);
+            /* NOTE: step_count4 now represents the next four counts after
+             * the last four mixed samples, so the lowest element
+             * represents the next step count to apply.
+             */
+            step_count = _mm_cvtss_f32(step_count4);
+        }
+        /* Mix with applying left over gain steps that aren't aligned multiples of 4. */
+        for(size_t leftover{min_len&3};leftover;++pos,--leftover)
+        {
+            dst[pos] += InSamples[pos] * (gain + step*step_count);
+            step_count += 1.0f;
+        }
+        if(pos == Counter)
+            gain = TargetGain;
+        else
+            gain += step*step_count;
+
+        /* Mix until pos is aligned with 4 or the mix is done. */
+        for(size_t leftover{aligned_len&3};leftover;++pos,--leftover)
+            dst[pos] += InSamples[pos] * gain;
+    }
+    CurrentGain = gain;
+
+    if(!(std::abs(gain) > GainSilenceThreshold))
+        return;
+    if(size_t todo{(InSamples.size()-pos) >> 2})
+    {
+        const __m128 gain4{_mm_set1_ps(gain)};
+        do {
+            const __m128 val4{_mm_load_ps(&InSamples[pos])};
+            __m128 dry4{_mm_load_ps(&dst[pos])};
+            dry4 = _mm_add_ps(dry4, _mm_mul_ps(val4, gain4));
+            _mm_store_ps(&dst[pos], dry4);
+            pos += 4;
+        } while(--todo);
+    }
+    for(size_t leftover{(InSamples.size()-pos)&3};leftover;++pos,--leftover)
+        dst[pos] += InSamples[pos] * gain;
+}
+
 } // namespace
 
 template<>
@@ -201,73 +322,71 @@ void Mix_<SSETag>(const al::span<const float> InSamples, const al::span<FloatBuf
 
     for(FloatBufferLine &output : OutBuffer)
     {
-        float *RESTRICT dst{al::assume_aligned<16>(output.data()+OutPos)};
-        float gain{*CurrentGains};
-        const float step{(*TargetGains-gain) * delta};
-
-        size_t pos{0};
-        if(!(std::abs(step) > std::numeric_limits<float>::epsilon()))
-            gain = *TargetGains;
-        else
-        {
-            float step_count{0.0f};
-            /* Mix with applying gain steps in aligned multiples of 4. */
-            if(size_t todo{(min_len-pos) >> 2})
-            {
-                const __m128 four4{_mm_set1_ps(4.0f)};
-                const __m128 step4{_mm_set1_ps(step)};
-                const __m128 gain4{_mm_set1_ps(gain)};
-                __m128 step_count4{_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)};
-                do {
-                    const __m128 val4{_mm_load_ps(&InSamples[pos])};
-                    __m128 dry4{_mm_load_ps(&dst[pos])};
-
-                    /* dry += val * (gain + step*step_count) */
-                    dry4 = MLA4(dry4, val4, MLA4(gain4, step4, step_count4));
-
-                    _mm_store_ps(&dst[pos], dry4);
-                    step_count4 = _mm_add_ps(step_count4, four4);
-                    pos += 4;
-                } while(--todo);
-                /* NOTE: step_count4 now represents the next four counts after
-                 * the last four mixed samples, so the lowest element
-                 * represents the next step count to apply.
-                 */
-                step_count = _mm_cvtss_f32(step_count4);
-            }
-            /* Mix with applying left over gain steps that aren't aligned multiples of 4. */
-            for(size_t leftover{min_len&3};leftover;++pos,--leftover)
-            {
-                dst[pos] += InSamples[pos] * (gain + step*step_count);
-                step_count += 1.0f;
-            }
-            if(pos == Counter)
-                gain = *TargetGains;
-            else
-                gain += step*step_count;
-
-            /* Mix until pos is aligned with 4 or the mix is done. */
-            for(size_t leftover{aligned_len&3};leftover;++pos,--leftover)
-                dst[pos] += InSamples[pos] * gain;
-        }
-        *CurrentGains = gain;
+        MixLine(InSamples, al::assume_aligned<16>(output.data()+OutPos), *CurrentGains,
+            *TargetGains, delta, min_len, aligned_len, Counter);
         ++CurrentGains;
         ++TargetGains;
+    }
+}
 
-        if(!(std::abs(gain) > GainSilenceThreshold))
-            continue;
-        if(size_t todo{(InSamples.size()-pos) >> 2})
-        {
-            const __m128 gain4{_mm_set1_ps(gain)};
-            do {
-                const __m128 val4{_mm_load_ps(&InSamples[pos])};
-                __m128 dry4{_mm_load_ps(&dst[pos])};
-                dry4 = _mm_add_ps(dry4, _mm_mul_ps(val4, gain4));
-                _mm_store_ps(&dst[pos], dry4);
-                pos += 4;
-            } while(--todo);
-        }
-        for(size_t leftover{(InSamples.size()-pos)&3};leftover;++pos,--leftover)
-            dst[pos] += InSamples[pos] * gain;
+template<>
+void MixSparse_<SSETag>(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, float *CurrentGains, const float *TargetGains,
+    const al::span<const uint8_t> OutChans, const size_t Counter, const size_t OutPos)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto min_len = minz(Counter, InSamples.size());
+    const auto aligned_len = minz((min_len+3) & ~size_t{3}, InSamples.size()) - min_len;
+
+    for(const size_t chan : OutChans)
+        MixLine(InSamples, al::assume_aligned<16>(OutBuffer[chan].data()+OutPos),
+            CurrentGains[chan], TargetGains[chan], delta, min_len, aligned_len, Counter);
+}
+
+template<>
+void MixMatrix_<SSETag>(const al::span<const float*const> InSamples,
+    const al::span<float*const> OutSamples, const float *Gains, const size_t GainStride,
+    const size_t SamplesToDo)
+{
+    ASSUME(InSamples.size() <= MaxMatrixInputs);
+
+    /* Mix four outputs at a time, then whatever is left. */
+    float *const *outputs{OutSamples.data()};
+    size_t numouts{OutSamples.size()};
+    for(;numouts >= 4;numouts -= 4)
+    {
+        MixMatrixGroup<4>(InSamples, outputs, Gains, GainStride, SamplesToDo);
+        outputs += 4;
+        Gains += GainStride*4;
+    }
+    switch(numouts)
+    {
+    case 3: MixMatrixGroup<3>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    case 2: MixMatrixGroup<2>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    case 1: MixMatrixGroup<1>(InSamples, outputs, Gains, GainStride, SamplesToDo); break;
+    }
+}
+
+template<>
+void ComplexMac_<SSETag>(float *RESTRICT Accum, const float *RESTRICT Input,
+    const float *RESTRICT Filter, const size_t Count)
+{
+    float *RESTRICT accIm{Accum + Count};
+    const float *RESTRICT inIm{Input + Count};
+    const float *RESTRICT firIm{Filter + Count};
+    for(size_t i{0};i < Count;i+=4)
+    {
+        const __m128 ir4{_mm_load_ps(&Input[i])};
+        const __m128 ii4{_mm_load_ps(&inIm[i])};
+        const __m128 fr4{_mm_load_ps(&Filter[i])};
+        const __m128 fi4{_mm_load_ps(&firIm[i])};
+
+        /* (a+bi)*(c+di) = (ac-bd) + (ad+bc)i */
+        __m128 re4{_mm_load_ps(&Accum[i])};
+        __m128 im4{_mm_load_ps(&accIm[i])};
+        re4 = _mm_sub_ps(MLA4(re4, ir4, fr4), _mm_mul_ps(ii4, fi4));
+        im4 = MLA4(MLA4(im4, ir4, fi4), ii4, fr4);
+        _mm_store_ps(&Accum[i], re4);
+        _mm_store_ps(&accIm[i], im4);
     }
 }
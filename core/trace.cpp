@@ -0,0 +1,361 @@
+
+#include "config.h"
+
+#include "trace.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef HAVE_PTHREAD_SETNAME_NP
+#include <pthread.h>
+#endif
+
+#include "logging.h"
+#include "ringbuffer.h"
+#include "threads.h"
+
+
+std::atomic<bool> gTraceEnabled{false};
+std::atomic<bool> gTraceVoices{false};
+
+namespace {
+
+using std::chrono::steady_clock;
+
+struct TraceEvent {
+    const char *mName;
+    const char *mArgName;
+    uint32_t mArg;
+    steady_clock::time_point mStart;
+    steady_clock::duration mDuration;
+};
+
+/* The spans recorded by one thread. The slots are allocated up front, and a
+ * thread claims one the first time it records a span, so recording never
+ * allocates or locks. Only the owning thread writes events, and only the
+ * writer thread reads them.
+ */
+struct ThreadTrace {
+    /* Set by a thread claiming the slot, and cleared by the writer once the
+     * thread has exited and its spans are written.
+     */
+    std::atomic<bool> mClaimed{false};
+    /* Set once the claiming thread has filled in its ID and name. */
+    std::atomic<bool> mActive{false};
+    /* Set when the owning thread exits. */
+    std::atomic<bool> mExited{false};
+
+    RingBufferPtr mEvents;
+    std::atomic<uint64_t> mDropped{0u};
+
+    uint mThreadId{0u};
+    char mName[64]{};
+    bool mNameWritten{false};
+};
+
+constexpr size_t MaxTraceThreads{16};
+constexpr size_t ThreadTraceSize{8191};
+
+/* How often the writer thread writes out recorded spans. */
+constexpr std::chrono::milliseconds WriteInterval{100};
+
+/* Kept once allocated, since threads may still hold a slot after tracing
+ * stops.
+ */
+std::unique_ptr<ThreadTrace[]> gThreadTraces;
+std::atomic<uint> gNextThreadId{1u};
+/* Spans dropped by threads that found no free slot. */
+std::atomic<uint64_t> gUntracedDropped{0u};
+
+FILE *gTraceFile{nullptr};
+steady_clock::time_point gTraceStart;
+bool gFirstEvent{true};
+
+std::thread gTraceThread;
+std::mutex gTraceThreadLock;
+std::condition_variable gTraceThreadCond;
+bool gTraceQuit{false};
+
+/* Marks the thread's slot as exited when the thread ends. */
+struct ThreadTraceRef {
+    ThreadTrace *mTrace{nullptr};
+
+    ~ThreadTraceRef()
+    {
+        if(mTrace)
+            mTrace->mExited.store(true, std::memory_order_release);
+    }
+};
+thread_local ThreadTraceRef tThreadTrace;
+
+
+ThreadTrace *GetThreadTrace() noexcept
+{
+    if LIKELY(tThreadTrace.mTrace) return tThreadTrace.mTrace;
+
+    /* Synchronize with StartTracing allocating the slots. */
+    if(!gTraceEnabled.load(std::memory_order_acquire))
+        return nullptr;
+
+    ThreadTrace *traces{gThreadTraces.get()};
+    for(size_t i{0};i < MaxTraceThreads;++i)
+    {
+        ThreadTrace &trace = traces[i];
+        bool claimed{false};
+        if(!trace.mClaimed.compare_exchange_strong(claimed, true, std::memory_order_acq_rel))
+            continue;
+
+        /* Threads are expected to have been named before recording anything,
+         * so the name can be picked up here.
+         */
+        trace.mThreadId = gNextThreadId.fetch_add(1u, std::memory_order_relaxed);
+        trace.mName[0] = '\0';
+#ifdef HAVE_PTHREAD_SETNAME_NP
+        if(pthread_getname_np(pthread_self(), trace.mName, sizeof(trace.mName)) != 0)
+            trace.mName[0] = '\0';
+#endif
+        trace.mActive.store(true, std::memory_order_release);
+
+        tThreadTrace.mTrace = &trace;
+        return &trace;
+    }
+    return nullptr;
+}
+
+
+void WriteJsonString(const char *str)
+{
+    fputc('"', gTraceFile);
+    for(;*str;++str)
+    {
+        if(*str == '"' || *str == '\\')
+            fputc('\\', gTraceFile);
+        if(static_cast<unsigned char>(*str) >= 0x20)
+            fputc(*str, gTraceFile);
+    }
+    fputc('"', gTraceFile);
+}
+
+void BeginJsonEvent()
+{
+    fputs(gFirstEvent ? "\n" : ",\n", gTraceFile);
+    gFirstEvent = false;
+}
+
+void LogDroppedSpans(const ThreadTrace &trace)
+{
+    if(const uint64_t dropped{trace.mDropped.load(std::memory_order_relaxed)})
+    {
+        if(trace.mName[0])
+            WARN("Dropped %" PRIu64 " trace spans from %s\n", dropped, trace.mName);
+        else
+            WARN("Dropped %" PRIu64 " trace spans from thread %u\n", dropped, trace.mThreadId);
+    }
+}
+
+/* Writes out the spans recorded so far, and frees the slots of threads that
+ * have exited once their spans are written. Only called from one thread at a
+ * time.
+ */
+void WriteTraceEvents()
+{
+    using std::chrono::duration;
+    using us = duration<double,std::micro>;
+
+    ThreadTrace *traces{gThreadTraces.get()};
+    for(size_t i{0};i < MaxTraceThreads;++i)
+    {
+        ThreadTrace &trace = traces[i];
+        if(!trace.mActive.load(std::memory_order_acquire))
+            continue;
+
+        /* Check for the thread exiting before reading its spans, so any it
+         * recorded before exiting are written.
+         */
+        const bool exited{trace.mExited.load(std::memory_order_acquire)};
+
+        if(!trace.mNameWritten)
+        {
+            BeginJsonEvent();
+            fprintf(gTraceFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":", trace.mThreadId);
+            if(trace.mName[0])
+                WriteJsonString(trace.mName);
+            else
+                fprintf(gTraceFile, "\"thread %u\"", trace.mThreadId);
+            fputs("}}", gTraceFile);
+            trace.mNameWritten = true;
+        }
+
+        RingBuffer *ring{trace.mEvents.get()};
+        auto evt_data = ring->getReadVector();
+        auto write_events = [&trace](const ll_ringbuffer_data &data) -> void
+        {
+            auto *evt = reinterpret_cast<const TraceEvent*>(data.buf);
+            for(size_t j{0};j < data.len;++j,++evt)
+            {
+                BeginJsonEvent();
+                fprintf(gTraceFile, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                    "\"ts\":%.3f,\"dur\":%.3f", evt->mName, trace.mThreadId,
+                    us{evt->mStart - gTraceStart}.count(), us{evt->mDuration}.count());
+                if(evt->mArgName)
+                    fprintf(gTraceFile, ",\"args\":{\"%s\":%u}", evt->mArgName, evt->mArg);
+                fputc('}', gTraceFile);
+            }
+        };
+        write_events(evt_data.first);
+        write_events(evt_data.second);
+        ring->readAdvance(evt_data.first.len + evt_data.second.len);
+
+        if(exited)
+        {
+            LogDroppedSpans(trace);
+            trace.mDropped.store(0u, std::memory_order_relaxed);
+            trace.mNameWritten = false;
+            trace.mExited.store(false, std::memory_order_relaxed);
+            trace.mActive.store(false, std::memory_order_relaxed);
+            trace.mClaimed.store(false, std::memory_order_release);
+        }
+    }
+    fflush(gTraceFile);
+}
+
+int TraceThread()
+{
+    althrd_setname("alsoft-trace");
+
+    std::unique_lock<std::mutex> threadlock{gTraceThreadLock};
+    while(!gTraceQuit)
+    {
+        gTraceThreadCond.wait_for(threadlock, WriteInterval);
+
+        /* The recording threads never take this lock, so holding it while
+         * writing doesn't hold them up.
+         */
+        WriteTraceEvents();
+    }
+    return 0;
+}
+
+/* Stops tracing when the library is unloaded. */
+struct TraceCleanup {
+    ~TraceCleanup() { StopTracing(); }
+} gTraceCleanup;
+
+} // namespace
+
+
+void StartTracing(FILE *file, bool voices)
+{
+    if(gTraceFile) return;
+
+    try {
+        if(!gThreadTraces)
+        {
+            auto traces = std::make_unique<ThreadTrace[]>(MaxTraceThreads);
+            for(size_t i{0};i < MaxTraceThreads;++i)
+                traces[i].mEvents = RingBuffer::Create(ThreadTraceSize, sizeof(TraceEvent),
+                    false);
+            gThreadTraces = std::move(traces);
+        }
+    }
+    catch(std::exception &e) {
+        ERR("Failed to allocate trace buffers: %s\n", e.what());
+        fclose(file);
+        return;
+    }
+    /* Forget anything recorded after tracing last stopped, and rewrite the
+     * thread names in the new file.
+     */
+    for(size_t i{0};i < MaxTraceThreads;++i)
+    {
+        ThreadTrace &trace = gThreadTraces[i];
+        trace.mEvents->readAdvance(trace.mEvents->readSpace());
+        trace.mNameWritten = false;
+    }
+
+    gTraceFile = file;
+    gTraceStart = steady_clock::now();
+    gFirstEvent = true;
+    fputs("[", gTraceFile);
+    BeginJsonEvent();
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":"
+        "\"OpenAL Soft\"}}", gTraceFile);
+
+    try {
+        gTraceQuit = false;
+        gTraceThread = std::thread{TraceThread};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start trace thread: %s\n", e.what());
+        fclose(gTraceFile);
+        gTraceFile = nullptr;
+        return;
+    }
+    gTraceEnabled.store(true, std::memory_order_release);
+    gTraceVoices.store(voices, std::memory_order_release);
+}
+
+void StopTracing()
+{
+    if(!gTraceFile) return;
+    gTraceVoices.store(false, std::memory_order_release);
+    gTraceEnabled.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> _{gTraceThreadLock};
+        gTraceQuit = true;
+    }
+    gTraceThreadCond.notify_all();
+    if(gTraceThread.joinable())
+        gTraceThread.join();
+
+    WriteTraceEvents();
+    for(size_t i{0};i < MaxTraceThreads;++i)
+    {
+        ThreadTrace &trace = gThreadTraces[i];
+        if(trace.mActive.load(std::memory_order_acquire))
+        {
+            LogDroppedSpans(trace);
+            trace.mDropped.store(0u, std::memory_order_relaxed);
+        }
+    }
+    if(const uint64_t dropped{gUntracedDropped.exchange(0u, std::memory_order_relaxed)})
+        WARN("Dropped %" PRIu64 " trace spans from threads beyond the first %zu\n", dropped,
+            MaxTraceThreads);
+    fputs("\n]\n", gTraceFile);
+    fclose(gTraceFile);
+    gTraceFile = nullptr;
+}
+
+void TraceSpan(const char *name, const char *argname, uint32_t arg,
+    steady_clock::time_point start, steady_clock::time_point end) noexcept
+{
+    ThreadTrace *trace{GetThreadTrace()};
+    if UNLIKELY(!trace)
+    {
+        gUntracedDropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+
+    auto evt_data = trace->mEvents->getWriteVector().first;
+    if UNLIKELY(evt_data.len < 1)
+    {
+        trace->mDropped.store(trace->mDropped.load(std::memory_order_relaxed)+1u,
+            std::memory_order_relaxed);
+        return;
+    }
+
+    auto *evt = reinterpret_cast<TraceEvent*>(evt_data.buf);
+    evt->mName = name;
+    evt->mArgName = argname;
+    evt->mArg = arg;
+    evt->mStart = start;
+    evt->mDuration = end - start;
+    trace->mEvents->writeAdvance(1);
+}
@@ -0,0 +1,69 @@
+#ifndef CORE_TRACE_H
+#define CORE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "opthelpers.h"
+
+
+/* Set while tracing is active. */
+extern std::atomic<bool> gTraceEnabled;
+/* Set while tracing is active with per-voice spans. These are off by default,
+ * as a span for every mixed voice each update can fill the per-thread buffers
+ * faster than they're written out.
+ */
+extern std::atomic<bool> gTraceVoices;
+
+/* Starts recording trace spans, which a background thread writes to the given
+ * file as Chrome trace event JSON (loadable in chrome://tracing or the
+ * Perfetto UI). The file is closed when tracing stops. Spans recorded with
+ * gTraceVoices are only included if voices is true.
+ */
+void StartTracing(FILE *file, bool voices);
+/* Stops tracing, writing out any remaining spans. */
+void StopTracing();
+
+/* Records a span on the calling thread. The name and argname strings must
+ * stay valid until tracing stops (string literals, generally), and argname
+ * may be null to not record the argument. Each thread records into its own
+ * lock-free buffer, claimed from a preallocated set the first time the thread
+ * records a span. Spans are dropped if the buffer fills up, or if no buffer is
+ * free.
+ */
+void TraceSpan(const char *name, const char *argname, uint32_t arg,
+    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    noexcept;
+
+/* Records a span for the lifetime of the object, if tracing is active. A
+ * different flag can be given for spans that are only recorded on request.
+ */
+class TraceScope {
+    const bool mActive;
+    const char *const mName;
+    const char *const mArgName;
+    const uint32_t mArg;
+    std::chrono::steady_clock::time_point mStart;
+
+public:
+    TraceScope(const std::atomic<bool> &enabled, const char *name, const char *argname=nullptr,
+        uint32_t arg=0) noexcept
+        : mActive{enabled.load(std::memory_order_relaxed)}, mName{name}, mArgName{argname}
+        , mArg{arg}
+    { if UNLIKELY(mActive) mStart = std::chrono::steady_clock::now(); }
+    TraceScope(const char *name, const char *argname=nullptr, uint32_t arg=0) noexcept
+        : TraceScope{gTraceEnabled, name, argname, arg}
+    { }
+    ~TraceScope()
+    {
+        if UNLIKELY(mActive)
+            TraceSpan(mName, mArgName, mArg, mStart, std::chrono::steady_clock::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#endif /* CORE_TRACE_H */
@@ -10,6 +10,7 @@
 #endif
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 
 #include "alcomplex.h"
@@ -21,8 +22,12 @@ namespace {
 
 using complex_d = std::complex<double>;
 
+template<size_t FilterSize>
 struct PhaseShifterT {
-    alignas(16) std::array<float,Uhj2Encoder::sFilterSize> Coeffs;
+    static_assert(FilterSize >= 16, "FilterSize needs to be at least 16");
+    static_assert((FilterSize&(FilterSize-1)) == 0, "FilterSize needs to be power of two");
+
+    alignas(16) std::array<float,FilterSize/2> Coeffs{};
 
     /* Some notes on this filter construction.
      *
@@ -44,7 +49,7 @@ struct PhaseShifterT {
      */
     PhaseShifterT()
     {
-        constexpr size_t fft_size{Uhj2Encoder::sFilterSize * 2};
+        constexpr size_t fft_size{FilterSize};
         constexpr size_t half_size{fft_size / 2};
 
         /* Generate a frequency domain impulse with a +90 degree phase offset.
@@ -64,7 +69,7 @@ struct PhaseShifterT {
         /* Reverse the filter for simpler processing, and store only the non-0
          * coefficients.
          */
-        auto fftiter = fftBuffer.get() + half_size + (Uhj2Encoder::sFilterSize-1);
+        auto fftiter = fftBuffer.get() + half_size + (half_size-1);
         for(float &coeff : Coeffs)
         {
             coeff = static_cast<float>(fftiter->real() / double{fft_size});
@@ -72,10 +77,26 @@ struct PhaseShifterT {
         }
     }
 };
-const PhaseShifterT PShift{};
+const PhaseShifterT<128> PShift128{};
+const PhaseShifterT<256> PShift256{};
+const PhaseShifterT<512> PShift512{};
 
-void allpass_process(al::span<float> dst, const float *RESTRICT src)
+al::span<const float> GetPhaseShifter(UhjLength length) noexcept
 {
+    switch(length)
+    {
+    case UhjLength::Length128: return PShift128.Coeffs;
+    case UhjLength::Length256: return PShift256.Coeffs;
+    case UhjLength::Length512: return PShift512.Coeffs;
+    }
+    return PShift256.Coeffs;
+}
+
+void allpass_process(al::span<float> dst, const float *RESTRICT src,
+    const al::span<const float> filter)
+{
+    ASSUME((filter.size()&3) == 0);
+
 #ifdef HAVE_SSE_INTRINSICS
     if(size_t todo{dst.size()>>1})
     {
@@ -83,9 +104,9 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
         do {
             __m128 r04{_mm_setzero_ps()};
             __m128 r14{_mm_setzero_ps()};
-            for(size_t j{0};j < PShift.Coeffs.size();j+=4)
+            for(size_t j{0};j < filter.size();j+=4)
             {
-                const __m128 coeffs{_mm_load_ps(&PShift.Coeffs[j])};
+                const __m128 coeffs{_mm_load_ps(&filter[j])};
                 const __m128 s0{_mm_loadu_ps(&src[j*2])};
                 const __m128 s1{_mm_loadu_ps(&src[j*2 + 4])};
 
@@ -107,9 +128,9 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
     if((dst.size()&1))
     {
         __m128 r4{_mm_setzero_ps()};
-        for(size_t j{0};j < PShift.Coeffs.size();j+=4)
+        for(size_t j{0};j < filter.size();j+=4)
         {
-            const __m128 coeffs{_mm_load_ps(&PShift.Coeffs[j])};
+            const __m128 coeffs{_mm_load_ps(&filter[j])};
             /* NOTE: This could alternatively be done with two unaligned loads
              * and a shuffle. Which would be better?
              */
@@ -159,9 +180,9 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
         do {
             float32x4_t r04{vdupq_n_f32(0.0f)};
             float32x4_t r14{vdupq_n_f32(0.0f)};
-            for(size_t j{0};j < PShift.Coeffs.size();j+=4)
+            for(size_t j{0};j < filter.size();j+=4)
             {
-                const float32x4_t coeffs{vld1q_f32(&PShift.Coeffs[j])};
+                const float32x4_t coeffs{vld1q_f32(&filter[j])};
                 const float32x4_t s0{vld1q_f32(&src[j*2])};
                 const float32x4_t s1{vld1q_f32(&src[j*2 + 4])};
 
@@ -188,9 +209,9 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
             return ret;
         };
         float32x4_t r4{vdupq_n_f32(0.0f)};
-        for(size_t j{0};j < PShift.Coeffs.size();j+=4)
+        for(size_t j{0};j < filter.size();j+=4)
         {
-            const float32x4_t coeffs{vld1q_f32(&PShift.Coeffs[j])};
+            const float32x4_t coeffs{vld1q_f32(&filter[j])};
             const float32x4_t s{load4(src[j*2], src[j*2 + 2], src[j*2 + 4], src[j*2 + 6])};
             r4 = vmlaq_f32(r4, s, coeffs);
         }
@@ -203,8 +224,8 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
     for(float &output : dst)
     {
         float ret{0.0f};
-        for(size_t j{0};j < PShift.Coeffs.size();++j)
-            ret += src[j*2] * PShift.Coeffs[j];
+        for(size_t j{0};j < filter.size();++j)
+            ret += src[j*2] * filter[j];
 
         output += ret;
         ++src;
@@ -229,6 +250,10 @@ void allpass_process(al::span<float> dst, const float *RESTRICT src)
  * with the desired shift.
  */
 
+Uhj2Encoder::Uhj2Encoder(UhjLength length)
+  : mLength{length}, mFilterDelay{GetPhaseShifter(length).size()}
+{ }
+
 void Uhj2Encoder::encode(const FloatBufferSpan LeftOut, const FloatBufferSpan RightOut,
     const FloatBufferLine *InSamples, const size_t SamplesToDo)
 {
@@ -244,13 +269,13 @@ void Uhj2Encoder::encode(const FloatBufferSpan LeftOut, const FloatBufferSpan Ri
     /* Combine the previously delayed mid/side signal with the input. */
 
     /* S = 0.9396926*W + 0.1855740*X */
-    auto miditer = std::copy(mMidDelay.cbegin(), mMidDelay.cend(), mMid.begin());
+    auto miditer = std::copy_n(mMidDelay.cbegin(), mFilterDelay, mMid.begin());
     std::transform(winput, winput+SamplesToDo, xinput, miditer,
         [](const float w, const float x) noexcept -> float
         { return 0.9396926f*w + 0.1855740f*x; });
 
     /* D = 0.6554516*Y */
-    auto sideiter = std::copy(mSideDelay.cbegin(), mSideDelay.cend(), mSide.begin());
+    auto sideiter = std::copy_n(mSideDelay.cbegin(), mFilterDelay, mSide.begin());
     std::transform(yinput, yinput+SamplesToDo, sideiter,
         [](const float y) noexcept -> float { return 0.6554516f*y; });
 
@@ -261,18 +286,19 @@ void Uhj2Encoder::encode(const FloatBufferSpan LeftOut, const FloatBufferSpan Ri
         *sideiter += left[i] - right[i];
 
     /* Copy the future samples back to the delay buffers for next time. */
-    std::copy_n(mMid.cbegin()+SamplesToDo, mMidDelay.size(), mMidDelay.begin());
-    std::copy_n(mSide.cbegin()+SamplesToDo, mSideDelay.size(), mSideDelay.begin());
+    std::copy_n(mMid.cbegin()+SamplesToDo, mFilterDelay, mMidDelay.begin());
+    std::copy_n(mSide.cbegin()+SamplesToDo, mFilterDelay, mSideDelay.begin());
 
     /* Now add the all-passed signal into the side signal. */
 
     /* D += j(-0.3420201*W + 0.5098604*X) */
-    auto tmpiter = std::copy(mSideHistory.cbegin(), mSideHistory.cend(), mTemp.begin());
+    const size_t historySize{mFilterDelay*2 - 1};
+    auto tmpiter = std::copy_n(mSideHistory.cbegin(), historySize, mTemp.begin());
     std::transform(winput, winput+SamplesToDo, xinput, tmpiter,
         [](const float w, const float x) noexcept -> float
         { return -0.3420201f*w + 0.5098604f*x; });
-    std::copy_n(mTemp.cbegin()+SamplesToDo, mSideHistory.size(), mSideHistory.begin());
-    allpass_process({mSide.data(), SamplesToDo}, mTemp.data());
+    std::copy_n(mTemp.cbegin()+SamplesToDo, historySize, mSideHistory.begin());
+    allpass_process({mSide.data(), SamplesToDo}, mTemp.data(), GetPhaseShifter(mLength));
 
     /* Left = (S + D)/2.0 */
     for(size_t i{0};i < SamplesToDo;i++)
@@ -281,3 +307,74 @@ void Uhj2Encoder::encode(const FloatBufferSpan LeftOut, const FloatBufferSpan Ri
     for(size_t i{0};i < SamplesToDo;i++)
         right[i] = (mMid[i] - mSide[i]) * 0.5f;
 }
+
+
+/* Decoding 2-channel UHJ to B-Format is done as:
+ *
+ * S = Left + Right
+ * D = Left - Right
+ *
+ * W = 0.981532*S + 0.197484*j(0.828331*D)
+ * X = 0.418496*S - j(0.828331*D)
+ * Y = 0.795968*D + j(0.186633*S)
+ *
+ * where j is a +90 degree phase shift. This is the 2-channel subset of the
+ * 3- and 4-channel UHJ decode, which also make use of the T and Q channels.
+ *
+ * As with encoding, the phase shift is done with the FIR filter. Since the
+ * input includes look-ahead samples for the filter, the unfiltered signal
+ * doesn't need to be delayed.
+ */
+
+void UhjDecoder::decode(const al::span<float*,3> samples, const size_t samplesToDo,
+    const size_t samplesDone)
+{
+    ASSUME(samplesToDo > 0);
+    ASSUME(samplesToDo <= sMaxSamples);
+    ASSUME(samplesDone <= samplesToDo);
+
+    const auto coeffs = GetPhaseShifter(UhjLength::Length256);
+
+    const size_t inputSize{samplesToDo + sFilterDelay};
+    {
+        const float *RESTRICT left{al::assume_aligned<16>(samples[0])};
+        const float *RESTRICT right{al::assume_aligned<16>(samples[1])};
+
+        /* S = Left + Right */
+        auto siter = std::copy(mSHistory.cbegin(), mSHistory.cend(), mS.begin());
+        std::transform(left, left+inputSize, right, siter, std::plus<float>{});
+
+        /* D = Left - Right */
+        auto diter = std::copy(mDHistory.cbegin(), mDHistory.cend(), mD.begin());
+        std::transform(left, left+inputSize, right, diter, std::minus<float>{});
+    }
+
+    /* Keep the input history preceding where the next input starts. */
+    std::copy_n(mS.cbegin()+samplesDone, mSHistory.size(), mSHistory.begin());
+    std::copy_n(mD.cbegin()+samplesDone, mDHistory.size(), mDHistory.begin());
+
+    /* The unfiltered signal, aligned to the center of the filter. */
+    const float *RESTRICT sinput{mS.data() + sFilterDelay-1};
+    const float *RESTRICT dinput{mD.data() + sFilterDelay-1};
+
+    float *RESTRICT woutput{al::assume_aligned<16>(samples[0])};
+    float *RESTRICT xoutput{al::assume_aligned<16>(samples[1])};
+    float *RESTRICT youtput{al::assume_aligned<16>(samples[2])};
+
+    /* tmp = j(0.828331*D) */
+    std::fill_n(mTemp.begin(), samplesToDo, 0.0f);
+    allpass_process({mTemp.data(), samplesToDo}, mD.data(), coeffs);
+
+    /* W = 0.981532*S + 0.197484*tmp */
+    for(size_t i{0};i < samplesToDo;++i)
+        woutput[i] = 0.981532f*sinput[i] + 0.197484f*0.828331f*mTemp[i];
+    /* X = 0.418496*S - tmp */
+    for(size_t i{0};i < samplesToDo;++i)
+        xoutput[i] = 0.418496f*sinput[i] - 0.828331f*mTemp[i];
+
+    /* Y = 0.795968*D + j(0.186633*S) */
+    std::fill_n(mTemp.begin(), samplesToDo, 0.0f);
+    allpass_process({mTemp.data(), samplesToDo}, mS.data(), coeffs);
+    for(size_t i{0};i < samplesToDo;++i)
+        youtput[i] = 0.795968f*dinput[i] + 0.186633f*mTemp[i];
+}
@@ -4,27 +4,46 @@
 #include <array>
 
 #include "almalloc.h"
+#include "alspan.h"
 #include "bufferline.h"
 
 
+/* The available FIR lengths for the wide-band phase shift. The filter is
+ * center-aligned, so its delay is half its length (e.g. a length of 256 has a
+ * delay of 128 samples). Since every other coefficient is 0, it also only
+ * needs that many multiply-adds per sample.
+ */
+enum class UhjLength : unsigned char {
+    Length128,
+    Length256,
+    Length512,
+};
+
+/* The default filter length for encoding and decoding. */
+constexpr UhjLength UhjLengthDefault{UhjLength::Length256};
+
+
 struct Uhj2Encoder {
-    /* A particular property of the filter allows it to cover nearly twice its
-     * length, so the filter size is also the effective delay (despite being
-     * center-aligned).
-     */
-    constexpr static size_t sFilterSize{128};
+    /* The largest filter delay, for sizing the buffers. */
+    constexpr static size_t sMaxFilterDelay{256};
+
+    const UhjLength mLength;
+    /* The delay (and number of non-0 coefficients) for the filter in use. */
+    const size_t mFilterDelay;
 
     /* Delays for the unfiltered signal. */
-    alignas(16) std::array<float,sFilterSize> mMidDelay{};
-    alignas(16) std::array<float,sFilterSize> mSideDelay{};
+    alignas(16) std::array<float,sMaxFilterDelay> mMidDelay{};
+    alignas(16) std::array<float,sMaxFilterDelay> mSideDelay{};
 
-    alignas(16) std::array<float,BufferLineSize+sFilterSize> mMid{};
-    alignas(16) std::array<float,BufferLineSize+sFilterSize> mSide{};
+    alignas(16) std::array<float,BufferLineSize+sMaxFilterDelay> mMid{};
+    alignas(16) std::array<float,BufferLineSize+sMaxFilterDelay> mSide{};
 
     /* History for the FIR filter. */
-    alignas(16) std::array<float,sFilterSize*2 - 1> mSideHistory{};
+    alignas(16) std::array<float,sMaxFilterDelay*2 - 1> mSideHistory{};
+
+    alignas(16) std::array<float,BufferLineSize + sMaxFilterDelay*2> mTemp{};
 
-    alignas(16) std::array<float,BufferLineSize + sFilterSize*2> mTemp{};
+    Uhj2Encoder(UhjLength length=UhjLengthDefault);
 
     /**
      * Encodes a 2-channel UHJ (stereo-compatible) signal from a B-Format input
@@ -36,4 +55,37 @@ struct Uhj2Encoder {
     DEF_NEWDEL(Uhj2Encoder)
 };
 
+
+struct UhjDecoder {
+    /* The decoder is given look-ahead input, so it doesn't add any delay. */
+    constexpr static size_t sFilterDelay{128};
+
+    /* The maximum number of samples that can be decoded at once. */
+    constexpr static size_t sMaxSamples{BufferLineSize*2};
+
+    alignas(16) std::array<float,sFilterDelay-1 + sMaxSamples+sFilterDelay> mS{};
+    alignas(16) std::array<float,sFilterDelay-1 + sMaxSamples+sFilterDelay> mD{};
+
+    /* History for the FIR filters. */
+    alignas(16) std::array<float,sFilterDelay-1> mSHistory{};
+    alignas(16) std::array<float,sFilterDelay-1> mDHistory{};
+
+    alignas(16) std::array<float,sMaxSamples> mTemp{};
+
+    /**
+     * Decodes a 3-channel B-Format signal (W, X, and Y, using FuMa ordering
+     * and scaling) from a 2-channel UHJ input signal, in-place. On input, the
+     * first two buffers hold the left and right channels, with samplesToDo
+     * samples plus sFilterDelay samples of look-ahead. On output, the three
+     * buffers hold samplesToDo samples of W, X, and Y.
+     *
+     * The filter history is taken from the input preceding samplesDone, which
+     * is where the next call's input is expected to start from.
+     */
+    void decode(const al::span<float*,3> samples, const size_t samplesToDo,
+        const size_t samplesDone);
+
+    DEF_NEWDEL(UhjDecoder)
+};
+
 #endif /* CORE_UHJFILTER_H */
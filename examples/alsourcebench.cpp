@@ -0,0 +1,385 @@
+/*
+ * OpenAL Source Property Benchmark
+ *
+ * Copyright (c) 2026 by the OpenAL Soft authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This file contains a benchmark for setting and querying source properties.
+ * It times updating many sources each mix with individual calls and with one
+ * batched call, and it measures query and update throughput with several
+ * threads. It renders with a loopback device, so no audio device is needed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "AL/alext.h"
+
+
+#ifndef AL_SOFTX_source_batch
+#define AL_SOFTX_source_batch
+typedef void (AL_APIENTRY*LPALSOURCESFVSOFT)(ALsizei nsources, const ALuint *sources, ALsizei nparams, const ALenum *params, const ALfloat *values);
+#endif
+
+namespace {
+
+using std::chrono::steady_clock;
+using microseconds = std::chrono::duration<double,std::micro>;
+
+LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDeviceSOFT;
+LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT;
+LPALSOURCESFVSOFT alSourcesfvSOFT;
+
+constexpr ALCint SampleRate{48000};
+constexpr ALCsizei UpdateSize{256};
+
+/* Each source's values for one update: position, velocity, and gain. */
+constexpr ALenum UpdateParams[]{AL_POSITION, AL_VELOCITY, AL_GAIN};
+constexpr size_t ValuesPerSource{7};
+
+
+struct LoopbackContext {
+    ALCdevice *mDevice{nullptr};
+    ALCcontext *mContext{nullptr};
+
+    bool open(const int numsources)
+    {
+        mDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+        if(!mDevice)
+        {
+            fprintf(stderr, "Failed to open a loopback device\n");
+            return false;
+        }
+
+        const ALCint attrs[]{
+            ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+            ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+            ALC_FREQUENCY, SampleRate,
+            ALC_MONO_SOURCES, numsources,
+            0
+        };
+        mContext = alcCreateContext(mDevice, attrs);
+        if(!mContext || alcMakeContextCurrent(mContext) == ALC_FALSE)
+        {
+            fprintf(stderr, "Failed to set up a loopback context\n");
+            return false;
+        }
+        return true;
+    }
+
+    ~LoopbackContext()
+    {
+        alcMakeContextCurrent(nullptr);
+        if(mContext)
+            alcDestroyContext(mContext);
+        if(mDevice)
+            alcCloseDevice(mDevice);
+    }
+};
+
+
+/* Plays the given number of looping sources, and updates each of them before
+ * every mix. Returns the average time spent in the update calls, in
+ * microseconds, and the total energy of the output to compare the methods.
+ */
+bool RunUpdates(const int numsources, const int numupdates, const bool batched,
+    double *avgtime, double *energy)
+{
+    LoopbackContext ctx;
+    if(!ctx.open(numsources))
+        return false;
+
+    std::vector<float> data(SampleRate/10);
+    for(size_t i{0};i < data.size();++i)
+        data[i] = static_cast<float>(std::sin(static_cast<double>(i) * 0.05)) * 0.01f;
+
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), SampleRate);
+
+    std::vector<ALuint> sources(static_cast<size_t>(numsources));
+    alGenSources(numsources, sources.data());
+    for(ALuint source : sources)
+    {
+        alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+        alSourcei(source, AL_LOOPING, AL_TRUE);
+    }
+    alSourcePlayv(numsources, sources.data());
+    if(alGetError() != AL_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to set up %d sources\n", numsources);
+        return false;
+    }
+
+    std::vector<float> values(sources.size() * ValuesPerSource);
+    std::vector<float> output(UpdateSize * 2);
+    microseconds total{};
+    *energy = 0.0;
+    for(int update{0};update < numupdates;++update)
+    {
+        for(size_t i{0};i < sources.size();++i)
+        {
+            const float angle{static_cast<float>(update)*0.01f + static_cast<float>(i)};
+            float *vals{&values[i*ValuesPerSource]};
+            vals[0] = std::sin(angle) * 10.0f;
+            vals[1] = 1.0f;
+            vals[2] = std::cos(angle) * 10.0f;
+            vals[3] = std::cos(angle);
+            vals[4] = 0.0f;
+            vals[5] = -std::sin(angle);
+            vals[6] = 0.5f + 0.5f*std::sin(angle*2.0f);
+        }
+
+        const auto start = steady_clock::now();
+        if(batched)
+            alSourcesfvSOFT(numsources, sources.data(), 3, UpdateParams, values.data());
+        else for(size_t i{0};i < sources.size();++i)
+        {
+            const float *vals{&values[i*ValuesPerSource]};
+            alSourcefv(sources[i], AL_POSITION, vals);
+            alSourcefv(sources[i], AL_VELOCITY, vals+3);
+            alSourcef(sources[i], AL_GAIN, vals[6]);
+        }
+        total += steady_clock::now() - start;
+
+        alcRenderSamplesSOFT(ctx.mDevice, output.data(), UpdateSize);
+        for(float sample : output)
+            *energy += sample*sample;
+    }
+
+    alDeleteSources(numsources, sources.data());
+    alDeleteBuffers(1, &buffer);
+
+    *avgtime = total.count() / numupdates;
+    return alGetError() == AL_NO_ERROR;
+}
+
+
+/* Queries source properties from the given number of threads for the given
+ * time, and returns the total number of calls made per second.
+ */
+double RunQueries(const ALuint *sources, const size_t numsources, const int numthreads,
+    const int seconds)
+{
+    std::atomic<bool> quit{false};
+    std::atomic<unsigned long> totalcalls{0};
+
+    auto query_proc = [&](const unsigned int seed)
+    {
+        unsigned int rng{seed};
+        unsigned long calls{0};
+        while(!quit.load(std::memory_order_relaxed))
+        {
+            rng = rng*1103515245u + 12345u;
+            const ALuint source{sources[(rng>>16) % numsources]};
+
+            ALfloat position[3];
+            ALint state;
+            alGetSourcefv(source, AL_POSITION, position);
+            alGetSourcei(source, AL_SOURCE_STATE, &state);
+            calls += 2;
+        }
+        totalcalls.fetch_add(calls);
+    };
+
+    std::vector<std::thread> threads;
+    for(int i{0};i < numthreads;++i)
+        threads.emplace_back(query_proc, static_cast<unsigned int>(i+1) * 7919u);
+
+    std::this_thread::sleep_for(std::chrono::seconds{seconds});
+    quit.store(true);
+    for(auto &thread : threads)
+        thread.join();
+
+    return static_cast<double>(totalcalls.load()) / seconds;
+}
+
+
+/* Sets source properties from the given number of threads for the given time,
+ * with each thread updating its own sources while the device renders. Returns
+ * the total number of calls made per second.
+ */
+double RunSetters(ALCdevice *device, const ALuint *sources, const size_t numsources,
+    const int numthreads, const int seconds)
+{
+    std::atomic<bool> quit{false};
+    std::atomic<unsigned long> totalcalls{0};
+
+    auto set_proc = [&](const size_t first, const size_t count)
+    {
+        unsigned long calls{0};
+        while(!quit.load(std::memory_order_relaxed))
+        {
+            const float angle{static_cast<float>(calls) * 0.001f};
+            const ALuint source{sources[first + calls%count]};
+            alSource3f(source, AL_POSITION, std::sin(angle)*10.0f, 1.0f, std::cos(angle)*10.0f);
+            alSourcef(source, AL_GAIN, 0.5f + 0.5f*std::sin(angle*2.0f));
+            calls += 2;
+        }
+        totalcalls.fetch_add(calls);
+    };
+
+    const size_t perthread{numsources / static_cast<size_t>(numthreads)};
+    std::vector<std::thread> threads;
+    for(int i{0};i < numthreads;++i)
+        threads.emplace_back(set_proc, static_cast<size_t>(i)*perthread, perthread);
+
+    std::vector<float> output(UpdateSize * 2);
+    const auto end = steady_clock::now() + std::chrono::seconds{seconds};
+    while(steady_clock::now() < end)
+    {
+        alcRenderSamplesSOFT(device, output.data(), UpdateSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    quit.store(true);
+    for(auto &thread : threads)
+        thread.join();
+
+    return static_cast<double>(totalcalls.load()) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int numsources{800};
+    int numupdates{400};
+    int maxthreads{static_cast<int>(std::thread::hardware_concurrency())};
+    int seconds{2};
+
+    for(int i{1};i < argc;++i)
+    {
+        if(i+1 < argc && strcmp(argv[i], "-sources") == 0)
+            numsources = atoi(argv[++i]);
+        else if(i+1 < argc && strcmp(argv[i], "-updates") == 0)
+            numupdates = atoi(argv[++i]);
+        else if(i+1 < argc && strcmp(argv[i], "-threads") == 0)
+            maxthreads = atoi(argv[++i]);
+        else if(i+1 < argc && strcmp(argv[i], "-seconds") == 0)
+            seconds = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-sources <count>] [-updates <count>] [-threads <count>]"
+                " [-seconds <time>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(numsources < 1 || numupdates < 1 || seconds < 1)
+    {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+    if(maxthreads < 1) maxthreads = 1;
+
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+    {
+        fprintf(stderr, "ALC_SOFT_loopback extension not available\n");
+        return 1;
+    }
+    alcLoopbackOpenDeviceSOFT = reinterpret_cast<LPALCLOOPBACKOPENDEVICESOFT>(
+        alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT"));
+    alcRenderSamplesSOFT = reinterpret_cast<LPALCRENDERSAMPLESSOFT>(
+        alcGetProcAddress(nullptr, "alcRenderSamplesSOFT"));
+
+    printf("Updating %d sources for %d mixes of %d samples\n", numsources, numupdates,
+        UpdateSize);
+
+    double calltime, callenergy;
+    if(!RunUpdates(numsources, numupdates, false, &calltime, &callenergy))
+        return 1;
+    printf("  individual calls:  %8.1f us per update (output energy %.6g)\n", calltime,
+        callenergy);
+
+    {
+        /* The extension can only be checked and loaded with a context. */
+        LoopbackContext ctx;
+        if(!ctx.open(1))
+            return 1;
+        if(alIsExtensionPresent("AL_SOFTX_source_batch"))
+            alSourcesfvSOFT = reinterpret_cast<LPALSOURCESFVSOFT>(
+                alGetProcAddress("alSourcesfvSOFT"));
+    }
+    if(!alSourcesfvSOFT)
+        printf("  AL_SOFTX_source_batch not available\n");
+    else
+    {
+        double batchtime, batchenergy;
+        if(!RunUpdates(numsources, numupdates, true, &batchtime, &batchenergy))
+            return 1;
+        printf("  alSourcesfvSOFT:   %8.1f us per update (output energy %.6g)\n", batchtime,
+            batchenergy);
+    }
+
+    LoopbackContext ctx;
+    if(!ctx.open(64))
+        return 1;
+    ALuint sources[64];
+    alGenSources(64, sources);
+
+    printf("Querying 64 sources for %d second%s (%u hardware threads)\n", seconds,
+        (seconds==1) ? "" : "s", std::thread::hardware_concurrency());
+    double base{0.0};
+    for(int numthreads{1};numthreads <= maxthreads;numthreads *= 2)
+    {
+        const double rate{RunQueries(sources, 64, numthreads, seconds)};
+        if(numthreads == 1) base = rate;
+        printf("  %3d thread%s %8.2f M calls/s (%.2fx)\n", numthreads,
+            (numthreads==1) ? ": " : "s:", rate/1000000.0, rate/base);
+    }
+
+    std::vector<float> data(SampleRate/10);
+    for(size_t i{0};i < data.size();++i)
+        data[i] = static_cast<float>(std::sin(static_cast<double>(i) * 0.05)) * 0.01f;
+
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), SampleRate);
+    for(ALuint source : sources)
+    {
+        alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+        alSourcei(source, AL_LOOPING, AL_TRUE);
+    }
+    alSourcePlayv(64, sources);
+
+    printf("Setting 64 playing sources for %d second%s\n", seconds, (seconds==1) ? "" : "s");
+    for(int numthreads{1};numthreads <= maxthreads;numthreads *= 2)
+    {
+        const double rate{RunSetters(ctx.mDevice, sources, 64, numthreads, seconds)};
+        if(numthreads == 1) base = rate;
+        printf("  %3d thread%s %8.2f M calls/s (%.2fx)\n", numthreads,
+            (numthreads==1) ? ": " : "s:", rate/1000000.0, rate/base);
+    }
+
+    alDeleteSources(64, sources);
+    alDeleteBuffers(1, &buffer);
+    return 0;
+}
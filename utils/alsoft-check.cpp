@@ -0,0 +1,723 @@
+/*
+ * Behavior checks for OpenAL Soft's in-progress extensions.
+ *
+ * Copyright (c) 2026 by the OpenAL Soft authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This program checks the behavior of the in-progress extensions, using a
+ * loopback device so no audio device is needed. Each check is run in turn (or
+ * only the ones named on the command line), and the program returns non-zero
+ * if any of them fail.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "inprogext.h"
+#include "mixstats.h"
+
+
+namespace {
+
+LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDeviceSOFT;
+LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT;
+
+constexpr ALCint SampleRate{48000};
+
+int NumFailures{0};
+
+#define CHECK(x) do {                                                         \
+    if(!(x))                                                                  \
+    {                                                                         \
+        fprintf(stderr, "  %s:%d: check failed: %s\n", __FILE__, __LINE__, #x); \
+        ++NumFailures;                                                        \
+    }                                                                         \
+} while(0)
+
+
+struct LoopbackContext {
+    ALCdevice *mDevice{nullptr};
+    ALCcontext *mContext{nullptr};
+
+    bool open()
+    {
+        mDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+        if(!mDevice)
+        {
+            fprintf(stderr, "  Failed to open a loopback device\n");
+            return false;
+        }
+
+        const ALCint attrs[]{
+            ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+            ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+            ALC_FREQUENCY, SampleRate,
+            0
+        };
+        mContext = alcCreateContext(mDevice, attrs);
+        if(!mContext || alcMakeContextCurrent(mContext) == ALC_FALSE)
+        {
+            fprintf(stderr, "  Failed to set up a loopback context\n");
+            return false;
+        }
+        return true;
+    }
+
+    void render(ALCsizei samples)
+    {
+        std::vector<float> output(static_cast<size_t>(samples) * 2);
+        alcRenderSamplesSOFT(mDevice, output.data(), samples);
+    }
+
+    ~LoopbackContext()
+    {
+        alcMakeContextCurrent(nullptr);
+        if(mContext)
+            alcDestroyContext(mContext);
+        if(mDevice)
+            alcCloseDevice(mDevice);
+    }
+};
+
+ALuint CreateSineBuffer(ALsizei length)
+{
+    std::vector<float> data(static_cast<size_t>(length));
+    for(size_t i{0};i < data.size();++i)
+        data[i] = (i&1) ? 0.25f : -0.25f;
+
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), SampleRate);
+    return buffer;
+}
+
+
+/* Recorded source commands must only take effect when committed, be applied
+ * in order, and raise the same errors the calls would have.
+ */
+void CheckSourceCommands(LoopbackContext&)
+{
+    if(!alIsExtensionPresent("AL_SOFTX_source_commands"))
+    {
+        fprintf(stderr, "  AL_SOFTX_source_commands not available\n");
+        ++NumFailures;
+        return;
+    }
+    auto alBeginSourceCommandsSOFT = reinterpret_cast<LPALBEGINSOURCECOMMANDSSOFT>(
+        alGetProcAddress("alBeginSourceCommandsSOFT"));
+    auto alCommitSourceCommandsSOFT = reinterpret_cast<LPALCOMMITSOURCECOMMANDSSOFT>(
+        alGetProcAddress("alCommitSourceCommandsSOFT"));
+    auto alSource3i64SOFT = reinterpret_cast<LPALSOURCE3I64SOFT>(
+        alGetProcAddress("alSource3i64SOFT"));
+    auto alSourcei64vSOFT = reinterpret_cast<LPALSOURCEI64VSOFT>(
+        alGetProcAddress("alSourcei64vSOFT"));
+
+    const ALuint buffer{CreateSineBuffer(SampleRate)};
+    ALuint sources[2]{};
+    alGenSources(2, sources);
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    /* Committing without recording is an error. */
+    alCommitSourceCommandsSOFT();
+    CHECK(alGetError() == AL_INVALID_OPERATION);
+
+    alBeginSourceCommandsSOFT();
+    alBeginSourceCommandsSOFT();
+    CHECK(alGetError() == AL_INVALID_OPERATION);
+
+    const ALfloat position[3]{1.0f, 2.0f, 3.0f};
+    alSourcef(sources[0], AL_GAIN, 0.5f);
+    alSourcefv(sources[0], AL_POSITION, position);
+    alSourcei(sources[0], AL_LOOPING, AL_TRUE);
+    alSourcef(sources[0], AL_GAIN, 0.25f);
+    alSourceQueueBuffers(sources[1], 1, &buffer);
+    alSourcePlay(sources[1]);
+
+    /* Nothing is applied while recording, and queries still run. */
+    ALfloat gain{};
+    ALint ival{};
+    alGetSourcef(sources[0], AL_GAIN, &gain);
+    CHECK(gain == 1.0f);
+    alGetSourcei(sources[1], AL_BUFFERS_QUEUED, &ival);
+    CHECK(ival == 0);
+    alGetSourcei(sources[1], AL_SOURCE_STATE, &ival);
+    CHECK(ival == AL_INITIAL);
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    alCommitSourceCommandsSOFT();
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    /* The last recorded value wins. */
+    alGetSourcef(sources[0], AL_GAIN, &gain);
+    CHECK(gain == 0.25f);
+    ALfloat values[3]{};
+    alGetSourcefv(sources[0], AL_POSITION, values);
+    CHECK(values[0] == 1.0f && values[1] == 2.0f && values[2] == 3.0f);
+    alGetSourcei(sources[0], AL_LOOPING, &ival);
+    CHECK(ival == AL_TRUE);
+    alGetSourcei(sources[1], AL_BUFFERS_QUEUED, &ival);
+    CHECK(ival == 1);
+    alGetSourcei(sources[1], AL_SOURCE_STATE, &ival);
+    CHECK(ival == AL_PLAYING);
+
+    /* Giving the wrong number of values fails when committed, as the call
+     * would have, and the other commands are still applied.
+     */
+    alBeginSourceCommandsSOFT();
+    alSource3f(sources[0], AL_GAIN, 0.1f, 0.1f, 0.1f);
+    alSource3i(sources[0], AL_LOOPING, AL_FALSE, 0, 0);
+    alSourcef(sources[0], AL_PITCH, 2.0f);
+    CHECK(alGetError() == AL_NO_ERROR);
+    alCommitSourceCommandsSOFT();
+    CHECK(alGetError() == AL_INVALID_ENUM);
+    alGetSourcef(sources[0], AL_GAIN, &gain);
+    CHECK(gain == 0.25f);
+    alGetSourcei(sources[0], AL_LOOPING, &ival);
+    CHECK(ival == AL_TRUE);
+    ALfloat pitch{};
+    alGetSourcef(sources[0], AL_PITCH, &pitch);
+    CHECK(pitch == 2.0f);
+
+    alBeginSourceCommandsSOFT();
+    const ALint64SOFT i64vals[3]{AL_FALSE, 0, 0};
+    alSourcei64vSOFT(sources[0], AL_LOOPING, i64vals);
+    alSource3i64SOFT(sources[0], AL_LOOPING, AL_TRUE, 0, 0);
+    alCommitSourceCommandsSOFT();
+    CHECK(alGetError() == AL_INVALID_ENUM);
+    alGetSourcei(sources[0], AL_LOOPING, &ival);
+    CHECK(ival == AL_FALSE);
+
+    /* Invalid source IDs fail when committed. */
+    alBeginSourceCommandsSOFT();
+    alSourcef(~0u, AL_GAIN, 0.5f);
+    alSourceStop(sources[1]);
+    CHECK(alGetError() == AL_NO_ERROR);
+    alCommitSourceCommandsSOFT();
+    CHECK(alGetError() == AL_INVALID_NAME);
+    alGetSourcei(sources[1], AL_SOURCE_STATE, &ival);
+    CHECK(ival == AL_STOPPED);
+
+    alDeleteSources(2, sources);
+    alDeleteBuffers(1, &buffer);
+    CHECK(alGetError() == AL_NO_ERROR);
+}
+
+
+/* The device clock and source offsets are read without waiting for the mixer.
+ * While another thread renders, the device clock must never go backwards, and
+ * each source offset must be paired with the clock time it was mixed for.
+ */
+void CheckClockOffsets(LoopbackContext &ctx)
+{
+    auto alcGetInteger64vSOFT = reinterpret_cast<LPALCGETINTEGER64VSOFT>(
+        alcGetProcAddress(ctx.mDevice, "alcGetInteger64vSOFT"));
+    auto alGetSourcei64vSOFT = reinterpret_cast<LPALGETSOURCEI64VSOFT>(
+        alGetProcAddress("alGetSourcei64vSOFT"));
+    if(!alcGetInteger64vSOFT || !alGetSourcei64vSOFT)
+    {
+        fprintf(stderr, "  ALC_SOFT_device_clock or AL_SOFT_source_latency not available\n");
+        ++NumFailures;
+        return;
+    }
+
+    constexpr ALCsizei RenderSize{256};
+    constexpr int MinRenders{1000};
+    constexpr int MinQueries{1000000};
+
+    ALCint64SOFT startclock{};
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_DEVICE_CLOCK_SOFT, 1, &startclock);
+
+    const ALuint buffer{CreateSineBuffer(SampleRate)};
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+    alSourcei(source, AL_LOOPING, AL_TRUE);
+    alSourcePlay(source);
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    std::atomic<bool> quit{false};
+    std::atomic<int> numrenders{0};
+    std::thread renderer{[&ctx,&quit,&numrenders]()
+    {
+        while(!quit.load())
+        {
+            ctx.render(RenderSize);
+            numrenders.fetch_add(1);
+        }
+    }};
+
+    /* The device clock in samples less the source's sample offset is when it
+     * started, plus however many times it looped, so it's the same modulo the
+     * buffer length for every query.
+     */
+    auto clock_samples = [](ALint64SOFT ns) noexcept -> ALint64SOFT
+    { return static_cast<ALint64SOFT>(std::llround(static_cast<double>(ns) * SampleRate / 1e9)); };
+    auto start_offset = [clock_samples](const ALint64SOFT (&offclock)[2]) noexcept
+    { return (clock_samples(offclock[1]) - (offclock[0]>>32)) % SampleRate; };
+
+    ALCint64SOFT lastclock{startclock};
+    ALint64SOFT startoffset{-1};
+    int numqueries{0}, clockerrors{0}, offseterrors{0};
+    while(numqueries < MinQueries || numrenders.load() < MinRenders)
+    {
+        ALCint64SOFT clock{};
+        alcGetInteger64vSOFT(ctx.mDevice, ALC_DEVICE_CLOCK_SOFT, 1, &clock);
+        if(clock < lastclock) ++clockerrors;
+        lastclock = clock;
+
+        ALint64SOFT offclock[2]{};
+        alGetSourcei64vSOFT(source, AL_SAMPLE_OFFSET_CLOCK_SOFT, offclock);
+        if(startoffset < 0)
+            startoffset = start_offset(offclock);
+        else if(start_offset(offclock) != startoffset)
+            ++offseterrors;
+        ++numqueries;
+    }
+    quit.store(true);
+    renderer.join();
+    CHECK(clockerrors == 0);
+    CHECK(offseterrors == 0);
+
+    /* Once the mixer's stopped, the clock is exactly the rendered length. */
+    ALCint64SOFT endclock{};
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_DEVICE_CLOCK_SOFT, 1, &endclock);
+    CHECK(clock_samples(endclock - startclock) == ALint64SOFT{RenderSize} * numrenders.load());
+
+    ALint64SOFT offclock[2]{};
+    alGetSourcei64vSOFT(source, AL_SAMPLE_OFFSET_CLOCK_SOFT, offclock);
+    CHECK(offclock[1] == endclock);
+    CHECK(start_offset(offclock) == startoffset);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffer);
+    CHECK(alGetError() == AL_NO_ERROR);
+}
+
+
+#ifdef __linux__
+bool IsFdReadable(int fd)
+{
+    struct pollfd pfd{};
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents&POLLIN);
+}
+#endif
+
+/* With the event queue enabled, the mixer's events are read back in order
+ * with alReadEventsSOFT, and the event fd (where available) is readable only
+ * while there are records left to read.
+ */
+void CheckEventQueue(LoopbackContext &ctx)
+{
+    if(!alIsExtensionPresent("AL_SOFTX_event_queue") || !alIsExtensionPresent("AL_SOFT_events"))
+    {
+        fprintf(stderr, "  AL_SOFTX_event_queue or AL_SOFT_events not available\n");
+        ++NumFailures;
+        return;
+    }
+    auto alEventControlSOFT = reinterpret_cast<LPALEVENTCONTROLSOFT>(
+        alGetProcAddress("alEventControlSOFT"));
+    auto alReadEventsSOFT = reinterpret_cast<LPALREADEVENTSSOFT>(
+        alGetProcAddress("alReadEventsSOFT"));
+
+    ALeventRecordSOFT records[16]{};
+    CHECK(alReadEventsSOFT(-1, records) == 0);
+    CHECK(alGetError() == AL_INVALID_VALUE);
+
+    const ALenum types[]{AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT,
+        AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT};
+    alEventControlSOFT(2, types, AL_TRUE);
+    CHECK(alIsEnabled(AL_EVENT_QUEUE_SOFTX) == AL_FALSE);
+    alEnable(AL_EVENT_QUEUE_SOFTX);
+    CHECK(alIsEnabled(AL_EVENT_QUEUE_SOFTX) == AL_TRUE);
+    const int eventfd{alGetInteger(AL_EVENT_FD_SOFTX)};
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    constexpr int NumBuffers{3};
+    ALuint buffers[NumBuffers]{};
+    for(ALuint &buffer : buffers)
+        buffer = CreateSineBuffer(1000);
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourceQueueBuffers(source, NumBuffers, buffers);
+    alSourcePlay(source);
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    ALint state{AL_PLAYING};
+    for(int i{0};i < 100 && state == AL_PLAYING;++i)
+    {
+        ctx.render(256);
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+    }
+    CHECK(state == AL_STOPPED);
+#ifdef __linux__
+    if(eventfd != -1)
+        CHECK(IsFdReadable(eventfd));
+#endif
+
+    /* Read the first record alone, to check the rest are still signaled. */
+    ALsizei count{alReadEventsSOFT(1, records)};
+    CHECK(count == 1);
+#ifdef __linux__
+    if(eventfd != -1)
+        CHECK(IsFdReadable(eventfd));
+#endif
+    count += alReadEventsSOFT(16-1, records+1);
+#ifdef __linux__
+    if(eventfd != -1)
+        CHECK(!IsFdReadable(eventfd));
+#endif
+    CHECK(alReadEventsSOFT(16, records) == 0);
+
+    /* The source starts playing, completes each buffer, then stops. */
+    CHECK(count >= 3);
+    ALuint completed{0};
+    for(ALsizei i{0};i < count;++i)
+    {
+        const ALeventRecordSOFT &rec = records[i];
+        CHECK(rec.object == source);
+        if(i == 0)
+            CHECK(rec.type == AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT && rec.param == AL_PLAYING);
+        else if(i == count-1)
+            CHECK(rec.type == AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT && rec.param == AL_STOPPED);
+        else
+        {
+            CHECK(rec.type == AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT);
+            completed += rec.param;
+        }
+    }
+    CHECK(completed == NumBuffers);
+
+    /* Nothing is queued once it's disabled. */
+    alDisable(AL_EVENT_QUEUE_SOFTX);
+    alSourceRewind(source);
+    alSourcePlay(source);
+    for(int i{0};i < 4;++i)
+        ctx.render(256);
+    CHECK(alReadEventsSOFT(16, records) == 0);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(NumBuffers, buffers);
+    CHECK(alGetError() == AL_NO_ERROR);
+}
+
+
+/* The event fd must stay readable while records are left to read, even when
+ * the mixer queues records while they're being read. The reader here only
+ * reads when the fd is readable, like an application waiting on it would, so
+ * a lost signal leaves records that are never read.
+ */
+void CheckEventQueueThreaded(LoopbackContext &ctx)
+{
+#ifdef __linux__
+    if(!alIsExtensionPresent("AL_SOFTX_event_queue") || !alIsExtensionPresent("AL_SOFT_events"))
+    {
+        fprintf(stderr, "  AL_SOFTX_event_queue or AL_SOFT_events not available\n");
+        ++NumFailures;
+        return;
+    }
+    auto alEventControlSOFT = reinterpret_cast<LPALEVENTCONTROLSOFT>(
+        alGetProcAddress("alEventControlSOFT"));
+    auto alReadEventsSOFT = reinterpret_cast<LPALREADEVENTSSOFT>(
+        alGetProcAddress("alReadEventsSOFT"));
+
+    const ALenum types[]{AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT,
+        AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT};
+    alEventControlSOFT(2, types, AL_TRUE);
+    alEnable(AL_EVENT_QUEUE_SOFTX);
+    const int eventfd{alGetInteger(AL_EVENT_FD_SOFTX)};
+    if(eventfd == -1)
+    {
+        fprintf(stderr, "  No event fd, skipping\n");
+        alDisable(AL_EVENT_QUEUE_SOFTX);
+        return;
+    }
+
+    /* Each play of the short buffer queues three records: playing, buffer
+     * completed, and stopped.
+     */
+    const ALuint buffer{CreateSineBuffer(16)};
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+    CHECK(alGetError() == AL_NO_ERROR);
+
+    constexpr int NumPlays{20000};
+    std::atomic<bool> done{false};
+    std::thread writer{[&ctx,source,&done]()
+    {
+        for(int i{0};i < NumPlays;++i)
+        {
+            alSourcePlay(source);
+            ctx.render(64);
+        }
+        done.store(true);
+    }};
+
+    ALeventRecordSOFT records[16]{};
+    size_t numread{0};
+    while(!done.load())
+    {
+        /* Read one at a time, so the fd is often signaled again for records
+         * left over.
+         */
+        if(IsFdReadable(eventfd))
+            numread += static_cast<size_t>(alReadEventsSOFT(1, records));
+        else
+            std::this_thread::yield();
+    }
+    writer.join();
+
+    while(IsFdReadable(eventfd))
+        numread += static_cast<size_t>(alReadEventsSOFT(16, records));
+    /* Nothing is left once the fd stops being readable. */
+    CHECK(alReadEventsSOFT(16, records) == 0);
+    CHECK(numread > 0);
+
+    alDisable(AL_EVENT_QUEUE_SOFTX);
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffer);
+    CHECK(alGetError() == AL_NO_ERROR);
+#else
+    (void)ctx;
+#endif
+}
+
+
+/* The histogram's percentiles are the upper limit of the bucket holding the
+ * time at that fraction, so they're never less than the exact time and at
+ * most a quarter more (or one more, for the smallest buckets). They're also
+ * never more than the largest time added.
+ */
+void CheckTimeHistogram(LoopbackContext&)
+{
+    using std::chrono::nanoseconds;
+
+    TimeHistogram histogram;
+    CHECK(histogram.getPercentile(0.5) == 0);
+    CHECK(histogram.getMax() == 0);
+
+    /* Add each time from 1 to 10000ns, out of order. */
+    constexpr uint64_t NumTimes{10000};
+    for(uint64_t i{0};i < NumTimes;++i)
+        histogram.add(nanoseconds{(i*7919)%NumTimes + 1});
+    CHECK(histogram.getMax() == NumTimes);
+
+    uint64_t last{0};
+    for(const double frac : {0.0001, 0.001, 0.01, 0.1, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0})
+    {
+        const auto exact = static_cast<uint64_t>(static_cast<double>(NumTimes)*frac + 0.5);
+        const uint64_t value{histogram.getPercentile(frac)};
+        if(!(value >= exact && value <= std::max(exact + exact/4, exact + 1)))
+            fprintf(stderr, "  percentile %g: got %llu, expected %llu\n", frac,
+                static_cast<unsigned long long>(value), static_cast<unsigned long long>(exact));
+        CHECK(value >= exact);
+        CHECK(value <= std::max(exact + exact/4, exact + 1));
+        CHECK(value >= last);
+        last = value;
+    }
+    CHECK(histogram.getPercentile(1.0) == NumTimes);
+
+    /* An outlier only shows in the percentiles that reach it. */
+    histogram.reset();
+    CHECK(histogram.getPercentile(0.99) == 0);
+    for(int i{0};i < 999;++i)
+        histogram.add(nanoseconds{1000});
+    histogram.add(nanoseconds{1000000});
+    const uint64_t median{histogram.getPercentile(0.5)};
+    CHECK(median >= 1000 && median <= 1250);
+    CHECK(histogram.getPercentile(0.999) == median);
+    CHECK(histogram.getPercentile(1.0) == 1000000);
+    CHECK(histogram.getMax() == 1000000);
+
+    /* Negative times count as 0, and times past the last bucket are limited
+     * by it, though the maximum is still exact.
+     */
+    histogram.reset();
+    histogram.add(nanoseconds{-5});
+    CHECK(histogram.getPercentile(1.0) == 0);
+    histogram.add(std::chrono::seconds{10});
+    CHECK(histogram.getMax() == 10000000000u);
+    const uint64_t top{histogram.getPercentile(1.0)};
+    CHECK(top >= 2000000000u && top < 10000000000u);
+}
+
+/* The mixer stats count every period rendered, with ordered percentiles that
+ * don't exceed the longest period.
+ */
+void CheckMixerStats(LoopbackContext &ctx)
+{
+    if(!alcIsExtensionPresent(ctx.mDevice, "ALC_SOFTX_mixer_stats"))
+    {
+        fprintf(stderr, "  ALC_SOFTX_mixer_stats not available\n");
+        ++NumFailures;
+        return;
+    }
+    auto alcGetInteger64vSOFT = reinterpret_cast<LPALCGETINTEGER64VSOFT>(
+        alcGetProcAddress(ctx.mDevice, "alcGetInteger64vSOFT"));
+
+    ALCint64SOFT periods{-1};
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_PERIODS_SOFTX, 1, &periods);
+    CHECK(periods == 0);
+
+    constexpr int NumRenders{100};
+    for(int i{0};i < NumRenders;++i)
+        ctx.render(256);
+
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_PERIODS_SOFTX, 1, &periods);
+    CHECK(periods == NumRenders);
+
+    ALCint64SOFT maxtime{}, totaltime{};
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_MAX_PERIOD_TIME_SOFTX, 1, &maxtime);
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_TOTAL_TIME_SOFTX, 1, &totaltime);
+    CHECK(maxtime > 0 && maxtime <= totaltime);
+
+    ALCint64SOFT percentiles[4]{};
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_PERIOD_PERCENTILES_SOFTX, 4, percentiles);
+    CHECK(alcGetError(ctx.mDevice) == ALC_NO_ERROR);
+    CHECK(percentiles[0] > 0);
+    CHECK(percentiles[0] <= percentiles[1] && percentiles[1] <= percentiles[2]
+        && percentiles[2] <= percentiles[3] && percentiles[3] <= maxtime);
+
+    alcGetInteger64vSOFT(ctx.mDevice, ALC_MIXER_PERIOD_PERCENTILES_SOFTX, 3, percentiles);
+    CHECK(alcGetError(ctx.mDevice) == ALC_INVALID_VALUE);
+}
+
+
+/* A running device's backend records its callback jitter and wakeup latency,
+ * with ordered percentiles that don't exceed the maximum. This uses the null
+ * output, which runs its own mixer thread in real time.
+ */
+void CheckBackendStats(LoopbackContext&)
+{
+    ALCdevice *device{alcOpenDevice("No Output")};
+    if(!device)
+    {
+        fprintf(stderr, "  Failed to open the null output (set ALSOFT_DRIVERS=null)\n");
+        ++NumFailures;
+        return;
+    }
+    if(!alcIsExtensionPresent(device, "ALC_SOFTX_backend_stats"))
+    {
+        fprintf(stderr, "  ALC_SOFTX_backend_stats not available\n");
+        ++NumFailures;
+        alcCloseDevice(device);
+        return;
+    }
+    auto alcGetInteger64vSOFT = reinterpret_cast<LPALCGETINTEGER64VSOFT>(
+        alcGetProcAddress(device, "alcGetInteger64vSOFT"));
+
+    /* Playback starts with the first context. */
+    ALCcontext *context{alcCreateContext(device, nullptr)};
+    CHECK(context != nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds{300});
+
+    ALCint64SOFT xruns{-1};
+    alcGetInteger64vSOFT(device, ALC_BACKEND_XRUNS_SOFTX, 1, &xruns);
+    CHECK(xruns >= 0);
+
+    for(const ALCenum param : {ALC_BACKEND_CALLBACK_JITTER_SOFTX, ALC_BACKEND_WAKEUP_LATENCY_SOFTX})
+    {
+        ALCint64SOFT values[5]{};
+        alcGetInteger64vSOFT(device, param, 5, values);
+        CHECK(alcGetError(device) == ALC_NO_ERROR);
+        CHECK(values[0] <= values[1] && values[1] <= values[2] && values[2] <= values[3]
+            && values[3] <= values[4]);
+        if(param == ALC_BACKEND_CALLBACK_JITTER_SOFTX)
+            CHECK(values[4] > 0);
+
+        alcGetInteger64vSOFT(device, param, 4, values);
+        CHECK(alcGetError(device) == ALC_INVALID_VALUE);
+    }
+
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+}
+
+
+struct CheckEntry {
+    const char *mName;
+    void (*mFunc)(LoopbackContext&);
+};
+const CheckEntry Checks[]{
+    {"source-commands", CheckSourceCommands},
+    {"clock-offsets", CheckClockOffsets},
+    {"event-queue", CheckEventQueue},
+    {"event-queue-threaded", CheckEventQueueThreaded},
+    {"time-histogram", CheckTimeHistogram},
+    {"mixer-stats", CheckMixerStats},
+    {"backend-stats", CheckBackendStats},
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+    {
+        fprintf(stderr, "ALC_SOFT_loopback extension not available\n");
+        return 1;
+    }
+    alcLoopbackOpenDeviceSOFT = reinterpret_cast<LPALCLOOPBACKOPENDEVICESOFT>(
+        alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT"));
+    alcRenderSamplesSOFT = reinterpret_cast<LPALCRENDERSAMPLESSOFT>(
+        alcGetProcAddress(nullptr, "alcRenderSamplesSOFT"));
+
+    int numrun{0};
+    for(const CheckEntry &check : Checks)
+    {
+        if(argc > 1)
+        {
+            bool found{false};
+            for(int i{1};i < argc && !found;++i)
+                found = strcmp(argv[i], check.mName) == 0;
+            if(!found) continue;
+        }
+
+        const int oldfailures{NumFailures};
+        LoopbackContext ctx;
+        if(!ctx.open())
+            ++NumFailures;
+        else
+            check.mFunc(ctx);
+        printf("%s: %s\n", check.mName, (NumFailures == oldfailures) ? "ok" : "FAILED");
+        ++numrun;
+    }
+    if(numrun == 0)
+    {
+        fprintf(stderr, "No matching checks\n");
+        return 1;
+    }
+
+    return NumFailures ? 1 : 0;
+}